@@ -36,11 +36,12 @@ set "LIB=!MSVC!\lib\x64;!WINSDK!\Lib\!SDKVER!\ucrt\x64;!WINSDK!\Lib\!SDKVER!\um\
 cl.exe /O2 /EHsc /DUNICODE /D_UNICODE /I. ^
     src\main.cpp ^
     libs\globals\globals.cpp libs\util\util.cpp libs\json\json.cpp libs\http\http.cpp ^
-    libs\cpu\cpu.cpp libs\mem\mem.cpp libs\gpu\gpu.cpp libs\disk\disk.cpp libs\net\net.cpp ^
-    libs\external\external.cpp libs\tray\tray.cpp libs\gdip\gdip.cpp libs\layout\layout.cpp ^
-    libs\draw\draw.cpp libs\tooltip\tooltip.cpp ^
+    libs\cpu\cpu.cpp libs\topology\topology.cpp libs\mem\mem.cpp libs\gpu\gpu.cpp libs\disk\disk.cpp libs\net\net.cpp ^
+    libs\external\external.cpp libs\tray\tray.cpp libs\gdip\gdip.cpp libs\layout\layout.cpp libs\layout\engine.cpp libs\config\config.cpp libs\sampler\sampler.cpp libs\metrics\metrics.cpp libs\exporter\exporter.cpp libs\tsdb\tsdb.cpp libs\rules\rules.cpp libs\shm\shm.cpp libs\plugins\plugins.cpp libs\footprint\footprint.cpp libs\sched\sched.cpp libs\rates\rates.cpp libs\battery\battery.cpp libs\battery\battery_win.cpp ^
+    libs\draw\draw.cpp libs\tooltip\tooltip.cpp libs\power\power.cpp libs\thermal\thermal.cpp ^
+    libs\history\history.cpp libs\rollup\rollup.cpp libs\perf\perf.cpp ^
     /Fe:SysMonitor.exe ^
-    /link user32.lib gdi32.lib gdiplus.lib shell32.lib iphlpapi.lib winhttp.lib advapi32.lib ole32.lib comctl32.lib dxgi.lib ^
+    /link user32.lib gdi32.lib gdiplus.lib shell32.lib iphlpapi.lib winhttp.lib advapi32.lib ole32.lib comctl32.lib dxgi.lib wtsapi32.lib ws2_32.lib powrprof.lib pdh.lib psapi.lib ^
     /SUBSYSTEM:WINDOWS /OPT:REF /OPT:ICF
 
 if !ERRORLEVEL! == 0 (
@@ -61,10 +62,10 @@ if %ERRORLEVEL% == 0 (
     g++ -O2 -DUNICODE -D_UNICODE -mwindows -I. ^
         src\main.cpp ^
         libs\globals\globals.cpp libs\util\util.cpp libs\json\json.cpp libs\http\http.cpp ^
-        libs\cpu\cpu.cpp libs\mem\mem.cpp libs\gpu\gpu.cpp libs\disk\disk.cpp libs\net\net.cpp ^
-        libs\external\external.cpp libs\tray\tray.cpp libs\gdip\gdip.cpp libs\layout\layout.cpp ^
-        libs\draw\draw.cpp libs\tooltip\tooltip.cpp ^
-        -o SysMonitor.exe -lgdiplus -liphlpapi -lwinhttp -ladvapi32 -lole32 -lshell32 -lcomctl32 -ldxgi
+        libs\cpu\cpu.cpp libs\topology\topology.cpp libs\mem\mem.cpp libs\gpu\gpu.cpp libs\disk\disk.cpp libs\net\net.cpp ^
+        libs\external\external.cpp libs\tray\tray.cpp libs\gdip\gdip.cpp libs\layout\layout.cpp libs\layout\engine.cpp libs\config\config.cpp libs\sampler\sampler.cpp libs\metrics\metrics.cpp libs\exporter\exporter.cpp libs\tsdb\tsdb.cpp libs\rules\rules.cpp libs\shm\shm.cpp libs\plugins\plugins.cpp libs\footprint\footprint.cpp libs\sched\sched.cpp libs\rates\rates.cpp libs\battery\battery.cpp libs\battery\battery_win.cpp ^
+        libs\draw\draw.cpp libs\tooltip\tooltip.cpp libs\power\power.cpp libs\thermal\thermal.cpp libs\history\history.cpp libs\rollup\rollup.cpp libs\perf\perf.cpp ^
+        -o SysMonitor.exe -lgdiplus -liphlpapi -lwinhttp -ladvapi32 -lole32 -lshell32 -lcomctl32 -ldxgi -lwtsapi32 -lws2_32 -lpowrprof -lpdh -lpsapi
     if !ERRORLEVEL! == 0 (
         echo.
         echo [OK] Build successful!
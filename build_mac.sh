@@ -17,6 +17,22 @@ SRC_MAIN="$SCRIPT_DIR/src/mac.main.cpp"
 SRC_MAC_GLOBALS="$SCRIPT_DIR/libs/mac/mac_globals.cpp"
 SRC_EXT="$SCRIPT_DIR/libs/mac/external_mac.mm"
 SRC_METRICS="$SCRIPT_DIR/libs/mac/metrics_mac.mm"
+SRC_HISTORY="$SCRIPT_DIR/libs/history/history.cpp"
+SRC_ROLLUP="$SCRIPT_DIR/libs/rollup/rollup.cpp"
+SRC_PERF="$SCRIPT_DIR/libs/perf/perf.cpp"
+SRC_LAYOUT="$SCRIPT_DIR/libs/layout/engine.cpp"
+SRC_CONFIG="$SCRIPT_DIR/libs/config/config.cpp"
+SRC_METRICS_REG="$SCRIPT_DIR/libs/metrics/metrics.cpp"
+SRC_EXPORTER="$SCRIPT_DIR/libs/exporter/exporter.cpp"
+SRC_TSDB="$SCRIPT_DIR/libs/tsdb/tsdb.cpp"
+SRC_RULES="$SCRIPT_DIR/libs/rules/rules.cpp"
+SRC_SHM="$SCRIPT_DIR/libs/shm/shm.cpp"
+SRC_PLUGINS="$SCRIPT_DIR/libs/plugins/plugins.cpp"
+SRC_FOOTPRINT="$SCRIPT_DIR/libs/footprint/footprint.cpp"
+SRC_SCHED="$SCRIPT_DIR/libs/sched/sched.cpp"
+SRC_RATES="$SCRIPT_DIR/libs/rates/rates.cpp"
+SRC_BATTERY="$SCRIPT_DIR/libs/battery/battery.cpp"
+SRC_TOPOLOGY="$SCRIPT_DIR/libs/topology/topology.cpp"
 APP_NAME="SysMonitor"
 APP_BUNDLE="$SCRIPT_DIR/$APP_NAME.app"
 CONTENTS="$APP_BUNDLE/Contents"
@@ -44,7 +60,7 @@ clang++ -x objective-c++ -std=c++17 -O2 \
     -framework IOKit \
     -fobjc-arc \
     -Wno-deprecated-declarations \
-    "$SRC_MAIN" "$SRC_MAC_GLOBALS" "$SRC_EXT" "$SRC_METRICS" \
+    "$SRC_MAIN" "$SRC_MAC_GLOBALS" "$SRC_EXT" "$SRC_METRICS" "$SRC_HISTORY" "$SRC_ROLLUP" "$SRC_PERF" "$SRC_LAYOUT" "$SRC_CONFIG" "$SRC_METRICS_REG" "$SRC_EXPORTER" "$SRC_TSDB" "$SRC_RULES" "$SRC_SHM" "$SRC_PLUGINS" "$SRC_FOOTPRINT" "$SRC_SCHED" "$SRC_RATES" "$SRC_BATTERY" "$SRC_TOPOLOGY" \
     -o "$BINARY"
 
 if [ $? -ne 0 ]; then
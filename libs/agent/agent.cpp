@@ -0,0 +1,112 @@
+#include "libs/agent/agent.h"
+
+#include <cstdio>
+#include <cstring>
+
+static_assert(sizeof(AgentBinHeader) + sizeof(MetricSet) <= AGENT_RECORD_MAX,
+              "binary record does not fit AGENT_RECORD_MAX");
+
+// Bounded append cursor; sticks at !ok once the buffer is full
+struct JsonOut {
+    char* p;
+    char* end;
+    bool  ok;
+
+    void Put(const char* s, size_t n) {
+        if (!ok || (size_t)(end - p) < n) { ok = false; return; }
+        memcpy(p, s, n);
+        p += n;
+    }
+    void Put(const char* s) { Put(s, strlen(s)); }
+    void Ch(char c)         { Put(&c, 1); }
+
+    void Num(double v) {
+        char b[32];
+        int n = snprintf(b, sizeof(b), "%.2f", v);
+        // Trim "12.50" -> "12.5", "3.00" -> "3"
+        while (n > 0 && b[n - 1] == '0') n--;
+        if (n > 0 && b[n - 1] == '.') n--;
+        Put(b, n);
+    }
+    void Num(uint64_t v) {
+        char b[24];
+        Put(b, snprintf(b, sizeof(b), "%llu", (unsigned long long)v));
+    }
+    void Str(const char* s) {
+        Ch('"');
+        for (; *s; s++) {
+            unsigned char c = (unsigned char)*s;
+            if (c == '"' || c == '\\') { Ch('\\'); Ch((char)c); }
+            else if (c < 0x20) {
+                char b[8];
+                Put(b, snprintf(b, sizeof(b), "\\u%04x", c));
+            } else Ch((char)c);
+        }
+        Ch('"');
+    }
+    void Key(const char* k) { Ch(','); Str(k); Ch(':'); }
+};
+
+static void Value(JsonOut& o, const MetricSet& m, int id, int i) {
+    if (g_metricDesc[id].type == MT_F64) o.Num(m.F((MetricId)id, i));
+    else                                 o.Num(m.U((MetricId)id, i));
+}
+
+static size_t EncodeJson(const MetricSet& m, uint64_t seq, uint64_t tsMs, char* buf, size_t cap) {
+    JsonOut o{buf, buf + cap, true};
+    o.Put("{\"ts\":");
+    o.Num(tsMs);
+    o.Put(",\"seq\":");
+    o.Num(seq);
+    for (int id = 0; id < METRIC_COUNT; id++) {
+        const MetricDesc& d = g_metricDesc[id];
+        o.Key(d.name);
+        if (d.slots == 1) { Value(o, m, id, 0); continue; }
+        o.Ch('[');
+        int n = m.Len((MetricId)id);
+        for (int i = 0; i < n; i++) {
+            if (i) o.Ch(',');
+            Value(o, m, id, i);
+        }
+        o.Ch(']');
+    }
+    o.Key("disk.path");
+    o.Ch('[');
+    for (int i = 0; i < m.Vols(); i++) {
+        if (i) o.Ch(',');
+        o.Str(m.volPath[i]);
+    }
+    o.Put("],\"thermal.temp_label\":[");
+    for (int i = 0; i < m.Temps(); i++) {
+        if (i) o.Ch(',');
+        o.Str(m.tempLabel[i]);
+    }
+    o.Put("],\"thermal.fan_label\":[");
+    for (int i = 0; i < m.Fans(); i++) {
+        if (i) o.Ch(',');
+        o.Str(m.fanLabel[i]);
+    }
+    o.Put("]}\n");
+    return o.ok ? (size_t)(o.p - buf) : 0;
+}
+
+static size_t EncodeBin(const MetricSet& m, uint64_t seq, uint64_t tsMs, char* buf, size_t cap) {
+    const size_t bytes = sizeof(AgentBinHeader) + sizeof(MetricSet);
+    if (cap < bytes) return 0;
+    AgentBinHeader h = {};
+    h.magic   = AGENT_BIN_MAGIC;
+    h.version = AGENT_BIN_VERSION;
+    h.slots   = (uint16_t)METRIC_SLOTS;
+    h.bytes   = (uint32_t)bytes;
+    h.seq     = seq;
+    h.tsMs    = tsMs;
+    memcpy(buf, &h, sizeof(h));
+    memcpy(buf + sizeof(h), &m, sizeof(MetricSet));
+    return bytes;
+}
+
+size_t EncodeRecord(AgentFormat fmt, const MetricSet& m, uint64_t seq,
+                    uint64_t tsMs, char* buf, size_t cap) {
+    return fmt == AGENT_BIN ? EncodeBin(m, seq, tsMs, buf, cap)
+                            : EncodeJson(m, seq, tsMs, buf, cap);
+}
@@ -0,0 +1,38 @@
+// SysMonitor - Headless record encoding
+// Portable: turns a MetricSet into one self-contained output record.
+// Encoders write into a caller-owned buffer and never allocate.
+#ifndef SYSMON_AGENT_H
+#define SYSMON_AGENT_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "libs/metrics/metrics.h"
+
+enum AgentFormat { AGENT_JSON, AGENT_BIN };
+
+// JSON lines: {"ts":..,"seq":..,"cpu.total":12.5,"cpu.core":[..],..,
+//              "disk.path":[..],"thermal.temp_label":[..],
+//              "thermal.fan_label":[..]}\n
+// Array metrics are cut to the live count (cores / volumes).
+// Binary: AgentBinHeader followed by the raw MetricSet; fixed length, so
+// records can be read back with a single fread each.
+struct AgentBinHeader {
+    uint32_t magic;         // AGENT_BIN_MAGIC
+    uint16_t version;
+    uint16_t slots;         // METRIC_SLOTS, to reject mismatched layouts
+    uint32_t bytes;         // header + payload
+    uint32_t reserved;
+    uint64_t seq;
+    uint64_t tsMs;          // wall clock, ms since epoch
+};
+
+static const uint32_t AGENT_BIN_MAGIC   = 0x31524D53;     // "SMR1"
+static const uint16_t AGENT_BIN_VERSION = 1;
+static const size_t   AGENT_RECORD_MAX  = 16384;
+
+// Bytes written, or 0 if cap is too small
+size_t EncodeRecord(AgentFormat fmt, const MetricSet& m, uint64_t seq,
+                    uint64_t tsMs, char* buf, size_t cap);
+
+#endif // SYSMON_AGENT_H
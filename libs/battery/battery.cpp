@@ -0,0 +1,60 @@
+#include "libs/battery/battery.h"
+
+// Ring of the readings in the current state, oldest first from g_head
+static PsuReading g_psuHist[PSU_HISTORY];
+static int        g_head = 0, g_len = 0;
+
+static const PsuReading& At(int i) { return g_psuHist[(g_head + i) % PSU_HISTORY]; }
+
+void PsuPush(const PsuReading& r) {
+    if (g_len && At(g_len - 1).state != r.state) g_len = 0;
+    // Drop what fell out of the window, then the oldest if full
+    while (g_len && r.ms - At(0).ms > PSU_WINDOW_MS) {
+        g_head = (g_head + 1) % PSU_HISTORY;
+        g_len--;
+    }
+    if (g_len == PSU_HISTORY) {
+        g_head = (g_head + 1) % PSU_HISTORY;
+        g_len--;
+    }
+    g_psuHist[(g_head + g_len++) % PSU_HISTORY] = r;
+}
+
+// Change per hour between the oldest and newest reading, given a span of at
+// least a minute (shorter spans are mostly rounding of the sysfs values)
+static bool Slope(double PsuReading::*field, double& perHour) {
+    if (g_len < 2) return false;
+    const PsuReading& a = At(0);
+    const PsuReading& b = At(g_len - 1);
+    if (a.*field < 0 || b.*field < 0 || b.ms - a.ms < 60000) return false;
+    perHour = (b.*field - a.*field) * 3600000.0 / (double)(b.ms - a.ms);
+    return true;
+}
+
+void PsuApply(MetricSet& m) {
+    if (!g_len || At(g_len - 1).state == PSU_NONE) {
+        m.SetF(METRIC_BATTERY, -1);
+        m.SetU(METRIC_POWER_STATE, PSU_NONE);
+        m.SetF(METRIC_POWER_DRAW, -1);
+        m.SetF(METRIC_POWER_TTE, -1);
+        return;
+    }
+    const PsuReading& cur = At(g_len - 1);
+    m.SetF(METRIC_BATTERY, cur.pct);
+    m.SetU(METRIC_POWER_STATE, (uint64_t)cur.state);
+
+    double sum = 0, slope;
+    int n = 0;
+    for (int i = 0; i < g_len; i++)
+        if (At(i).watts >= 0) { sum += At(i).watts; n++; }
+    double draw = n ? sum / n : Slope(&PsuReading::energyWh, slope) ? (slope < 0 ? -slope : slope) : -1;
+    m.SetF(METRIC_POWER_DRAW, cur.state == PSU_FULL ? 0 : draw);
+
+    double tte = -1;
+    if (cur.state == PSU_DISCHARGING) {
+        if (draw > 0 && cur.energyWh >= 0)                  tte = cur.energyWh / draw * 3600.0;
+        else if (Slope(&PsuReading::pct, slope) && slope < 0) tte = cur.pct / -slope * 3600.0;
+        else                                                 tte = cur.osTteSec;
+    }
+    m.SetF(METRIC_POWER_TTE, tte);
+}
@@ -0,0 +1,40 @@
+// SysMonitor - Battery / power supply
+// Portable: shared by the Windows, macOS and Linux builds.
+// The platform backends push one raw reading per sample (and on every
+// power-source change notification); this keeps a short history and turns
+// it into the power.* metrics:
+//   power.battery          charge, %            (-1: no battery)
+//   power.state            PSU_* below
+//   power.draw             W in or out, averaged over the history
+//   power.time_to_empty    s, while discharging (-1: unknown)
+// Draw comes from the reported power where there is one, otherwise from
+// the slope of the remaining energy. Time to empty is remaining energy
+// over that draw, or the charge slope, or the OS's own estimate.
+// The history restarts on every state change (plugged in, unplugged).
+#ifndef SYSMON_BATTERY_H
+#define SYSMON_BATTERY_H
+
+#include <cstdint>
+
+#include "libs/metrics/metrics.h"
+
+static const int      PSU_HISTORY   = 16;
+static const uint32_t PSU_WINDOW_MS = 5 * 60 * 1000;
+
+enum PsuState { PSU_NONE, PSU_DISCHARGING, PSU_CHARGING, PSU_FULL };
+
+struct PsuReading {
+    uint64_t ms;                // monotonic, when read
+    int      state;             // PsuState
+    double   pct;
+    double   watts;             // instantaneous, -1 = not reported
+    double   energyWh;          // remaining, -1 = not reported
+    double   osTteSec;          // the OS's time to empty, -1 = none
+};
+
+// Sampling thread
+void PsuPush(const PsuReading& r);
+// Writes the power.* metrics from the history
+void PsuApply(MetricSet& m);
+
+#endif // SYSMON_BATTERY_H
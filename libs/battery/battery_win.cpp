@@ -0,0 +1,23 @@
+#include "libs/battery/battery_win.h"
+#include "libs/battery/battery.h"
+
+#include <powrprof.h>
+
+// Straight from the battery driver; GetSystemPowerStatus has the
+// percentage only
+void UpdateBattery() {
+    SYSTEM_BATTERY_STATE bs = {};
+    PsuReading r = { GetTickCount64(), PSU_NONE, -1, -1, -1, -1 };
+    if (CallNtPowerInformation(SystemBatteryState, nullptr, 0, &bs, sizeof(bs)) == 0 &&
+        bs.BatteryPresent && bs.MaxCapacity) {
+        r.state = bs.Charging ? PSU_CHARGING : bs.Discharging ? PSU_DISCHARGING : PSU_FULL;
+        r.pct   = 100.0 * bs.RemainingCapacity / bs.MaxCapacity;
+        // Rate: mW, negative while discharging, 0x80000000 = unknown
+        LONG rate = (LONG)bs.Rate;
+        if (rate != (LONG)0x80000000) r.watts = (rate < 0 ? -rate : rate) / 1000.0;
+        r.energyWh = bs.RemainingCapacity / 1000.0;
+        if (bs.EstimatedTime != 0xFFFFFFFF && bs.Discharging) r.osTteSec = bs.EstimatedTime;
+    }
+    PsuPush(r);
+    PsuApply(g_metrics);
+}
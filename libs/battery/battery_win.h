@@ -0,0 +1,13 @@
+// SysMonitor - Battery sampler (Windows)
+// Charge, rate and remaining capacity from SystemBatteryState, pushed into
+// the portable history (libs/battery) once per sample and on every
+// power-source notification (libs/power).
+#ifndef SYSMON_BATTERY_WIN_H
+#define SYSMON_BATTERY_WIN_H
+
+#include "libs/globals/globals.h"
+
+// Sampling thread
+void UpdateBattery();
+
+#endif
@@ -0,0 +1,181 @@
+#include "libs/bench/bench.h"
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+
+#include <fcntl.h>
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+static const char* g_filter   = nullptr;
+static uint64_t    g_minNs    = 200000000ull;
+static bool        g_json     = false;
+static int         g_sysFd    = -1;         // perf tracepoint counter
+static int         g_ioFd     = -1;         // /proc/self/io fallback
+static const char* g_sysSource = "none";
+
+// ---- Allocation counter -------------------------------------------------
+// The executable's malloc family interposes glibc's for the whole process
+// (operator new included), forwarding to the real allocator.
+static std::atomic<uint64_t> g_allocs{0};
+
+#ifdef __GLIBC__
+extern "C" {
+void* __libc_malloc(size_t n);
+void* __libc_calloc(size_t n, size_t sz);
+void* __libc_realloc(void* p, size_t n);
+void* __libc_memalign(size_t align, size_t n);
+void  __libc_free(void* p);
+
+void* malloc(size_t n) {
+    g_allocs.fetch_add(1, std::memory_order_relaxed);
+    return __libc_malloc(n);
+}
+void* calloc(size_t n, size_t sz) {
+    g_allocs.fetch_add(1, std::memory_order_relaxed);
+    return __libc_calloc(n, sz);
+}
+void* realloc(void* p, size_t n) {
+    g_allocs.fetch_add(1, std::memory_order_relaxed);
+    return __libc_realloc(p, n);
+}
+void* aligned_alloc(size_t align, size_t n) {
+    g_allocs.fetch_add(1, std::memory_order_relaxed);
+    return __libc_memalign(align, n);
+}
+int posix_memalign(void** out, size_t align, size_t n) {
+    g_allocs.fetch_add(1, std::memory_order_relaxed);
+    void* p = __libc_memalign(align, n);
+    if (!p) return 12;  // ENOMEM
+    *out = p;
+    return 0;
+}
+void free(void* p) { __libc_free(p); }
+}
+#endif
+
+// ---- Syscall counter ----------------------------------------------------
+static int OpenTracepoint() {
+    static const char* IDS[] = {
+        "/sys/kernel/tracing/events/raw_syscalls/sys_enter/id",
+        "/sys/kernel/debug/tracing/events/raw_syscalls/sys_enter/id",
+    };
+    for (const char* path : IDS) {
+        FILE* f = fopen(path, "r");
+        if (!f) continue;
+        unsigned long long id = 0;
+        bool ok = fscanf(f, "%llu", &id) == 1;
+        fclose(f);
+        if (!ok) continue;
+
+        perf_event_attr a;
+        memset(&a, 0, sizeof(a));
+        a.type = PERF_TYPE_TRACEPOINT;
+        a.size = sizeof(a);
+        a.config = id;
+        a.sample_period = 1;
+        // This thread, any CPU
+        int fd = (int)syscall(SYS_perf_event_open, &a, 0, -1, -1, PERF_FLAG_FD_CLOEXEC);
+        if (fd >= 0) return fd;
+    }
+    return -1;
+}
+
+static uint64_t ReadSyscalls() {
+    if (g_sysFd >= 0) {
+        uint64_t v = 0;
+        if (read(g_sysFd, &v, sizeof(v)) != (ssize_t)sizeof(v)) return 0;
+        return v;
+    }
+    if (g_ioFd >= 0) {
+        char buf[512];
+        ssize_t n = pread(g_ioFd, buf, sizeof(buf) - 1, 0);
+        if (n <= 0) return 0;
+        buf[n] = 0;
+        const char* r = strstr(buf, "syscr:");
+        const char* w = strstr(buf, "syscw:");
+        return (r ? strtoull(r + 6, nullptr, 10) : 0) + (w ? strtoull(w + 6, nullptr, 10) : 0);
+    }
+    return 0;
+}
+
+static uint64_t NowNs() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+// ---- Harness ------------------------------------------------------------
+bool BenchInit(int argc, char** argv) {
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--json")) {
+            g_json = true;
+        } else if (!strcmp(argv[i], "--filter") && i + 1 < argc) {
+            g_filter = argv[++i];
+        } else if (!strcmp(argv[i], "--min-ms") && i + 1 < argc) {
+            long ms = strtol(argv[++i], nullptr, 10);
+            if (ms < 1) ms = 1;
+            g_minNs = (uint64_t)ms * 1000000ull;
+        } else {
+            fprintf(stderr, "usage: %s [--json] [--filter SUBSTR] [--min-ms N]\n", argv[0]);
+            return false;
+        }
+    }
+
+    g_sysFd = OpenTracepoint();
+    if (g_sysFd >= 0) {
+        g_sysSource = "tracepoint";
+    } else {
+        g_ioFd = open("/proc/self/io", O_RDONLY | O_CLOEXEC);
+        if (g_ioFd >= 0) g_sysSource = "rw";
+    }
+
+    if (!g_json)
+        printf("%-22s %12s %14s %12s %12s   (syscalls: %s)\n",
+               "case", "iters", "ns/op", "allocs/op", "syscalls/op", g_sysSource);
+    return true;
+}
+
+void BenchDone() {
+    if (g_sysFd >= 0) close(g_sysFd);
+    if (g_ioFd >= 0)  close(g_ioFd);
+    g_sysFd = g_ioFd = -1;
+}
+
+bool BenchWanted(const char* name) {
+    return !g_filter || strstr(name, g_filter);
+}
+
+uint64_t BenchMinNs() { return g_minNs; }
+
+BenchCounters BenchRead() {
+    BenchCounters c;
+    // Syscalls first so the clock read (vDSO) stays out of the count
+    c.syscalls = ReadSyscalls();
+    c.allocs   = g_allocs.load(std::memory_order_relaxed);
+    c.ns       = NowNs();
+    return c;
+}
+
+void BenchReport(const char* name, uint64_t iters, const BenchCounters& a, const BenchCounters& b) {
+    double n = (double)iters;
+    double ns = (double)(b.ns - a.ns) / n;
+    double allocs = (double)(b.allocs - a.allocs) / n;
+    // One of the two counter reads lands inside the window
+    uint64_t sys = b.syscalls - a.syscalls;
+    if (sys > 0) sys--;
+    double syscalls = (double)sys / n;
+
+    if (g_json)
+        printf("{\"name\":\"%s\",\"iters\":%llu,\"ns_per_op\":%.1f,\"allocs_per_op\":%.2f,"
+               "\"syscalls_per_op\":%.2f,\"syscall_source\":\"%s\"}\n",
+               name, (unsigned long long)iters, ns, allocs, syscalls, g_sysSource);
+    else
+        printf("%-22s %12llu %14.1f %12.2f %12.2f\n",
+               name, (unsigned long long)iters, ns, allocs, syscalls);
+    fflush(stdout);
+}
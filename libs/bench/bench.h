@@ -0,0 +1,54 @@
+// SysMonitor - Microbenchmark harness (Linux)
+// Each case is timed in a loop that doubles until it runs for at least the
+// minimum time, and reports per-op wall time, heap allocations (every
+// malloc/calloc/realloc/new in the process) and syscalls. Syscalls come from
+// the raw_syscalls:sys_enter tracepoint when perf_event_open allows it, else
+// from the read/write counts in /proc/self/io.
+//   sysmon_bench [--json] [--filter SUBSTR] [--min-ms N]
+// --json prints one object per case:
+//   {"name":"update_cpu","iters":65536,"ns_per_op":1234.5,
+//    "allocs_per_op":0.00,"syscalls_per_op":3.00,"syscall_source":"tracepoint"}
+#ifndef SYSMON_BENCH_H
+#define SYSMON_BENCH_H
+
+#include <cstdint>
+
+struct BenchCounters {
+    uint64_t ns, allocs, syscalls;
+};
+
+// Parses the command line; false on bad arguments (usage already printed)
+bool BenchInit(int argc, char** argv);
+void BenchDone();
+
+bool BenchWanted(const char* name);
+BenchCounters BenchRead();
+uint64_t BenchMinNs();
+void BenchReport(const char* name, uint64_t iters, const BenchCounters& a, const BenchCounters& b);
+
+// Keeps the optimizer from dropping work whose result is otherwise unused
+inline void BenchKeep(const void* p) { asm volatile("" : : "g"(p) : "memory"); }
+
+template <class F>
+void Bench(const char* name, F fn) {
+    if (!BenchWanted(name)) return;
+    fn();   // warm caches and lazy state
+    uint64_t iters = 1;
+    for (;;) {
+        BenchCounters a = BenchRead();
+        for (uint64_t i = 0; i < iters; i++) fn();
+        BenchCounters b = BenchRead();
+        uint64_t ns = b.ns - a.ns, minNs = BenchMinNs();
+        if (ns >= minNs || iters >= (1ull << 30)) {
+            BenchReport(name, iters, a, b);
+            return;
+        }
+        // Aim a little past the minimum; at most 100x per step
+        uint64_t next = ns ? (uint64_t)((double)iters * minNs * 1.2 / ns) : iters * 100;
+        if (next < iters * 2)   next = iters * 2;
+        if (next > iters * 100) next = iters * 100;
+        iters = next;
+    }
+}
+
+#endif // SYSMON_BENCH_H
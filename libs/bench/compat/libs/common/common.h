@@ -0,0 +1,45 @@
+// SysMonitor - Benchmark stand-in for libs/common/common.h
+// Put ahead of the source root on the include path so the portable parts
+// of the Windows helpers (libs/json, libs/util) build on Linux as they are.
+// Only the few Win32 names those files use are provided.
+#ifndef SYSMON_COMMON_H
+#define SYSMON_COMMON_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cwchar>
+#include <string>
+
+typedef unsigned long long ULONGLONG;
+
+static const unsigned CP_UTF8 = 65001;
+
+inline double _wtof(const wchar_t* s) { return wcstod(s, nullptr); }
+
+template <class... A>
+inline int swprintf_s(wchar_t* buf, size_t len, const wchar_t* fmt, A... a) {
+    return swprintf(buf, len, fmt, a...);
+}
+
+// UTF-8 only; no error flags, invalid bytes map to U+FFFD
+inline int MultiByteToWideChar(unsigned, unsigned, const char* s, int n, wchar_t* out, int cap) {
+    int w = 0;
+    for (int i = 0; i < n;) {
+        unsigned char c = (unsigned char)s[i];
+        uint32_t cp = 0xFFFD;
+        int len = c < 0x80 ? 1 : (c >> 5) == 6 ? 2 : (c >> 4) == 14 ? 3 : (c >> 3) == 30 ? 4 : 1;
+        if (i + len <= n) {
+            if (len == 1 && c < 0x80) cp = c;
+            else if (len > 1) {
+                cp = c & (0x7F >> len);
+                for (int k = 1; k < len; k++) cp = (cp << 6) | ((unsigned char)s[i + k] & 0x3F);
+            }
+        }
+        i += len;
+        if (out && w < cap) out[w] = (wchar_t)cp;
+        w++;
+    }
+    return w;
+}
+
+#endif // SYSMON_COMMON_H
@@ -24,12 +24,17 @@
 #include <winhttp.h>
 #include <commctrl.h>
 #include <dxgi1_4.h>
+#include <wtsapi32.h>
 #include <string>
 #include <vector>
 #include <mutex>
+#include <atomic>
+#include <memory>
 #include <cstdio>
 #include <cmath>
 
+#include "libs/layout/win_spec.h"
+
 #pragma comment(lib, "user32.lib")
 #pragma comment(lib, "gdi32.lib")
 #pragma comment(lib, "gdiplus.lib")
@@ -39,26 +44,27 @@
 #pragma comment(lib, "advapi32.lib")
 #pragma comment(lib, "comctl32.lib")
 #pragma comment(lib, "dxgi.lib")
+#pragma comment(lib, "wtsapi32.lib")
+#pragma comment(lib, "powrprof.lib")
+#pragma comment(lib, "pdh.lib")
+#pragma comment(lib, "psapi.lib")
 #pragma comment(linker,"\"/manifestdependency:type='win32' name='Microsoft.Windows.Common-Controls' version='6.0.0.0' processorArchitecture='*' publicKeyToken='6595b64144ccf1df' language='*'\"")
 
 // ---------------------------------------------------------------------------
 // Constants
 // ---------------------------------------------------------------------------
-static const int    WIDGET_H        = 68;
-static const int    BAR_PAD         = 12;
-static const int    SEC_SEP         = 18;
-static const int    SEC_TIME_W      = 115;
-static const int    SEC_MEM_W       = 238;
-static const int    SEC_IPNET_W     = 190;
-static const int    SEC_WX_W        = 105;
-static const int    SEC_DISK_COL_W  = 95;
+// Widget geometry (WIDGET_H, SEC_*_W, WIN_SPEC): libs/layout/win_spec.h
+static const int    THERM_CELLS     = 6;        // sensor cells shown, two columns
 static const int    UPDATE_MS       = 1000;
+static const int    BACKGROUND_MS   = 10000;    // display off / session locked
 static const int    BG_FETCH_MS     = 300000;   // 5 min
-static const UINT   TIMER_REFRESH   = 1;
 static const UINT   WM_TRAYICON     = WM_USER + 100;
+static const UINT   WM_SNAPSHOT     = WM_USER + 101;
+static const UINT   WM_ALERT        = WM_USER + 102;
 static const UINT   IDM_SHOWHIDE    = 2001;
 static const UINT   IDM_AUTOSTART   = 2002;
 static const UINT   IDM_EXIT        = 2003;
+static const UINT   IDM_DUMPTIMING  = 2004;
 
 static const wchar_t* APP_NAME      = L"SysMonitor";
 static const wchar_t* WND_CLASS     = L"SysMonitorWidgetClass";
@@ -68,12 +74,6 @@ static const wchar_t* REG_APP       = L"Software\\SysMonitor";
 // ---------------------------------------------------------------------------
 // Shared data types
 // ---------------------------------------------------------------------------
-struct VolInfo {
-    wchar_t letter;
-    double  usedGB;
-    double  totalGB;
-};
-
 struct ExtData {
     std::wstring ip     = L"Loading...";
     std::wstring city   = L"Loading...";
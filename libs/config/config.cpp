@@ -0,0 +1,190 @@
+#include "libs/config/config.h"
+
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+SectionConfig g_sections = {
+    { SEC_ID_TIME, SEC_ID_CPU, SEC_ID_MEM, SEC_ID_DISK, SEC_ID_NET, SEC_ID_WX }, 6,
+    { true, true, true, true, true, true, false, false }, true, true,
+};
+
+int g_exporterPort = 0;
+std::string g_historyFile;
+std::vector<std::string> g_alerts;
+std::vector<std::string> g_pluginSpecs;
+std::string              g_budget;
+std::string              g_intervals;
+
+static const char* SEC_NAMES[SEC_ID_COUNT] = { "time", "cpu", "mem", "disk", "net", "weather", "plugins", "thermal" };
+
+bool ParseSections(const char* spec, SectionConfig& c) {
+    SectionConfig r = {};
+    bool gpu = false, ip = false;
+    const char* p = spec;
+    while (*p) {
+        while (*p == ',' || isspace((unsigned char)*p)) p++;
+        const char* b = p;
+        while (*p && *p != ',' && !isspace((unsigned char)*p)) p++;
+        size_t n = (size_t)(p - b);
+        if (!n) continue;
+        auto is = [&](const char* s) { return strlen(s) == n && !strncmp(b, s, n); };
+        if (is("gpu"))     { gpu = true; continue; }
+        if (is("ip"))      { ip  = true; continue; }
+        for (int i = 0; i < SEC_ID_COUNT; i++)
+            if (is(SEC_NAMES[i]) && !r.on[i]) {
+                r.on[i] = true;
+                r.order[r.count++] = i;
+            }
+    }
+    if (!r.count) return false;
+    r.gpu = gpu && r.on[SEC_ID_MEM];
+    r.ip  = ip  && r.on[SEC_ID_NET];
+    c = r;
+    return true;
+}
+
+std::string FormatSections(const SectionConfig& c) {
+    std::string s;
+    for (int i = 0; i < c.count; i++) {
+        if (!s.empty()) s += ',';
+        s += SEC_NAMES[c.order[i]];
+        if (c.order[i] == SEC_ID_MEM && c.gpu) s += ",gpu";
+        if (c.order[i] == SEC_ID_NET && c.ip)  s += ",ip";
+    }
+    return s;
+}
+
+// Configured plugins need somewhere to show up
+static void AddPluginSection(SectionConfig& c) {
+    if (g_pluginSpecs.empty() || c.on[SEC_ID_PLUGIN]) return;
+    c.on[SEC_ID_PLUGIN] = true;
+    c.order[c.count++] = SEC_ID_PLUGIN;
+}
+
+#ifdef _WIN32
+
+// REG_MULTI_SZ: NUL-separated strings, double-NUL terminated
+static void ReadMultiSz(HKEY key, const wchar_t* name, std::vector<std::string>& out) {
+    DWORD type = 0, cb = 0;
+    if (RegQueryValueExW(key, name, nullptr, &type, nullptr, &cb) != ERROR_SUCCESS
+        || type != REG_MULTI_SZ || cb == 0)
+        return;
+    std::vector<wchar_t> buf(cb / sizeof(wchar_t) + 2, 0);
+    if (RegQueryValueExW(key, name, nullptr, &type, (LPBYTE)buf.data(), &cb) != ERROR_SUCCESS) return;
+    for (const wchar_t* w = buf.data(); *w; w += wcslen(w) + 1) {
+        char utf8[512];
+        if (WideCharToMultiByte(CP_UTF8, 0, w, -1, utf8, sizeof(utf8), nullptr, nullptr))
+            out.push_back(utf8);
+    }
+}
+
+// REG_SZ -> UTF-8; out is left alone if the value is missing or not a string
+static bool ReadSz(HKEY key, const wchar_t* name, std::string& out) {
+    DWORD type = 0, cb = 0;
+    if (RegQueryValueExW(key, name, nullptr, &type, nullptr, &cb) != ERROR_SUCCESS || type != REG_SZ)
+        return false;
+    std::vector<wchar_t> buf(cb / sizeof(wchar_t) + 1, 0);
+    if (RegQueryValueExW(key, name, nullptr, &type, (LPBYTE)buf.data(), &cb) != ERROR_SUCCESS) return false;
+    int n = WideCharToMultiByte(CP_UTF8, 0, buf.data(), -1, nullptr, 0, nullptr, nullptr);
+    if (n <= 0) return false;
+    std::string s(n, '\0');
+    WideCharToMultiByte(CP_UTF8, 0, buf.data(), -1, &s[0], n, nullptr, nullptr);
+    s.resize(n - 1);
+    out = s;
+    return true;
+}
+
+void LoadConfig() {
+    wchar_t buf[256] = {};
+    DWORD cb = sizeof(buf) - sizeof(wchar_t), type = 0;
+    HKEY key;
+    if (RegOpenKeyExW(HKEY_CURRENT_USER, L"Software\\SysMonitor", 0, KEY_READ, &key) != ERROR_SUCCESS)
+        return;
+    DWORD port = 0, pcb = sizeof(port);
+    if (RegQueryValueExW(key, L"ExporterPort", nullptr, &type, (LPBYTE)&port, &pcb) == ERROR_SUCCESS
+        && type == REG_DWORD && port < 65536)
+        g_exporterPort = (int)port;
+    ReadSz(key, L"HistoryFile", g_historyFile);
+    ReadMultiSz(key, L"Alerts", g_alerts);
+    ReadMultiSz(key, L"Plugins", g_pluginSpecs);
+    ReadSz(key, L"Budget", g_budget);
+    ReadSz(key, L"Intervals", g_intervals);
+    LONG rc = RegQueryValueExW(key, L"Sections", nullptr, &type, (LPBYTE)buf, &cb);
+    RegCloseKey(key);
+    if (rc == ERROR_SUCCESS && type == REG_SZ) {
+        char spec[256];
+        int n = 0;
+        for (const wchar_t* w = buf; *w && n < 255; w++)
+            spec[n++] = (*w < 128) ? (char)*w : ' ';
+        spec[n] = 0;
+        ParseSections(spec, g_sections);
+    }
+    AddPluginSection(g_sections);
+}
+
+#else
+
+// "key = value" -> value, or nullptr if the line is not about key
+static char* ConfigValue(char* line, const char* key) {
+    char* p = line;
+    while (isspace((unsigned char)*p)) p++;
+    size_t n = strlen(key);
+    if (strncmp(p, key, n)) return nullptr;
+    p += n;
+    while (isspace((unsigned char)*p)) p++;
+    return *p == '=' ? p + 1 : nullptr;
+}
+
+// A value without its surrounding whitespace (and the newline fgets kept)
+static std::string Trimmed(char* v) {
+    while (isspace((unsigned char)*v)) v++;
+    size_t n = strlen(v);
+    while (n && isspace((unsigned char)v[n - 1])) n--;
+    return std::string(v, n);
+}
+
+void LoadConfig() {
+    std::string path;
+    if (const char* x = getenv("XDG_CONFIG_HOME"))
+        path = std::string(x) + "/sysmonitor/config";
+    else if (const char* h = getenv("HOME"))
+        path = std::string(h) + "/.config/sysmonitor/config";
+    else
+        return;
+
+    FILE* f = fopen(path.c_str(), "r");
+    if (!f) return;
+    char line[512];
+    while (fgets(line, sizeof(line), f)) {
+        if (char* v = ConfigValue(line, "sections"))
+            ParseSections(v, g_sections);
+        else if (char* v = ConfigValue(line, "exporter_port")) {
+            long port = strtol(v, nullptr, 10);
+            if (port >= 0 && port < 65536) g_exporterPort = (int)port;
+        }
+        else if (char* v = ConfigValue(line, "history_file"))
+            g_historyFile = Trimmed(v);
+        else if (char* v = ConfigValue(line, "alert")) {
+            std::string s = Trimmed(v);
+            if (!s.empty()) g_alerts.push_back(s);
+        }
+        else if (char* v = ConfigValue(line, "plugin")) {
+            std::string s = Trimmed(v);
+            if (!s.empty()) g_pluginSpecs.push_back(s);
+        }
+        else if (char* v = ConfigValue(line, "budget"))
+            g_budget = Trimmed(v);
+        else if (char* v = ConfigValue(line, "intervals"))
+            g_intervals = Trimmed(v);
+    }
+    fclose(f);
+    AddPluginSection(g_sections);
+}
+
+#endif
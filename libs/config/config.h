@@ -0,0 +1,66 @@
+// SysMonitor - Section configuration
+// Which sections are shown, in what order, and which samplers they need.
+// Stored as a comma-separated list, e.g. "time,cpu,mem,gpu,disk,net,ip,weather,plugins":
+// ("thermal" is off unless listed)
+//   Windows      HKCU\Software\SysMonitor  "Sections" (REG_SZ)
+//   Linux/macOS  $XDG_CONFIG_HOME/sysmonitor/config (or ~/.config/...),
+//                line "sections = ..."
+// The metrics exporter port lives next to it: "ExporterPort" (REG_DWORD) /
+// "exporter_port = 9101", and so does the history file: "HistoryFile"
+// (REG_SZ) / "history_file = <path>|off". Alert rules (libs/rules) are one
+// per string in "Alerts" (REG_MULTI_SZ) / one per "alert = ..." line, and
+// so are plugins: "Plugins" / "plugin = ...". The overhead budget
+// (libs/footprint) is "Budget" (REG_SZ) / "budget = ...", and per-sampler
+// intervals (libs/rates) are "Intervals" (REG_SZ) / "intervals = ...".
+// gpu and ip are rows inside the mem and net sections; their position in
+// the list is ignored. Unknown names are skipped.
+#ifndef SYSMON_CONFIG_H
+#define SYSMON_CONFIG_H
+
+#include "libs/layout/engine.h"
+#include <string>
+#include <vector>
+
+struct SectionConfig {
+    int  order[SEC_ID_COUNT];   // enabled layout sections, display order
+    int  count;
+    bool on[SEC_ID_COUNT];
+    bool gpu;                   // GPU row (needs mem)
+    bool ip;                    // public IP (needs net)
+};
+
+extern SectionConfig g_sections;
+
+inline bool SectionOn(int sec) { return g_sections.on[sec]; }
+// ip-api/weather worker is needed at all
+inline bool WantExternal()     { return g_sections.ip || g_sections.on[SEC_ID_WX]; }
+
+// false (and c left untouched) if spec names no layout section
+bool ParseSections(const char* spec, SectionConfig& c);
+std::string FormatSections(const SectionConfig& c);
+
+// OpenMetrics listener port on 127.0.0.1; 0 = off (default)
+extern int g_exporterPort;
+
+// On-disk history store (libs/tsdb), UTF-8; empty = platform default,
+// "off" = disabled
+extern std::string g_historyFile;
+
+// Alert rule sources, uncompiled
+extern std::vector<std::string> g_alerts;
+
+// Plugin definitions (libs/plugins); the plugins section is appended to
+// the layout when there are any and Sections doesn't place it
+extern std::vector<std::string> g_pluginSpecs;
+
+// Self-footprint budget spec (libs/footprint), unparsed; empty = none
+extern std::string g_budget;
+
+// Per-sampler interval overrides (libs/rates), unparsed; empty = defaults
+extern std::string g_intervals;
+
+// Loads the settings above from the platform store; keeps the defaults
+// for anything unset.
+void LoadConfig();
+
+#endif // SYSMON_CONFIG_H
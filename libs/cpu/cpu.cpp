@@ -1,4 +1,84 @@
 #include "libs/cpu/cpu.h"
+#include "libs/rollup/rollup.h"
+#include "libs/metrics/metrics.h"
+#include "libs/topology/topology.h"
+
+#include <pdh.h>
+#include <pdhmsg.h>
+#include <powrprof.h>
+
+// CallNtPowerInformation(ProcessorInformation) entry; documented there but
+// not declared in the SDK headers
+struct PROC_POWER_INFO {
+    ULONG Number, MaxMhz, CurrentMhz, MhzLimit, MaxIdleState, CurrentIdleState;
+};
+
+// "% Processor Performance" is the clock the processor actually ran at over
+// the last interval as a share of its rated one (APERF/MPERF on x86), one
+// instance per logical processor, "group,number"
+static PDH_HQUERY   g_perfQuery = nullptr;
+static PDH_HCOUNTER g_perfCtr   = nullptr;
+static std::vector<BYTE>            g_perfBuf;
+static std::vector<PROC_POWER_INFO> g_power;
+static bool   g_limited[128];
+static double g_throttle[128];
+
+// ProcessorInformation wants one entry per active processor in every group,
+// and fails outright on a shorter buffer. Win7+, so resolved at run time.
+typedef DWORD (WINAPI *GetActiveProcessorCount_t)(WORD);
+static const WORD ALL_GROUPS = 0xFFFF;      // ALL_PROCESSOR_GROUPS
+
+// Win7+, so resolved at run time like SetWaitableTimerEx (libs/sampler).
+// The SDK only declares it, and EfficiencyClass, for _WIN32_WINNT >= 0x0601;
+// these mirror SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX for RelationProcessorCore.
+struct TOPO_GROUP_AFFINITY {
+    ULONG_PTR Mask;
+    WORD      Group;
+    WORD      Reserved[3];
+};
+struct TOPO_PROC_INFO {
+    DWORD Relationship;
+    DWORD Size;
+    BYTE  Flags;
+    BYTE  EfficiencyClass;          // 0 before Windows 10
+    BYTE  Reserved[20];
+    WORD  GroupCount;
+    TOPO_GROUP_AFFINITY GroupMask[1];
+};
+typedef BOOL (WINAPI *GetLPIEx_t)(int, void*, PDWORD);
+static const int TOPO_RELATION_CORE = 0;    // RelationProcessorCore
+
+// Physical core and efficiency class of each logical processor in group 0
+// (the one NtQuerySystemInformation reports)
+static void InitTopology() {
+    for (int i = 0; i < g_numCores; i++) {
+        g_metrics.SetU(METRIC_CPU_PHYS, (uint64_t)i, i);
+        g_metrics.SetU(METRIC_CPU_CLASS, 0, i);
+    }
+    GetLPIEx_t getLpiEx = (GetLPIEx_t)GetProcAddress(GetModuleHandleW(L"kernel32.dll"),
+                                                     "GetLogicalProcessorInformationEx");
+    DWORD len = 0;
+    if (!getLpiEx || getLpiEx(TOPO_RELATION_CORE, nullptr, &len) ||
+        GetLastError() != ERROR_INSUFFICIENT_BUFFER)
+        return;
+    std::vector<BYTE> buf(len);
+    if (!getLpiEx(TOPO_RELATION_CORE, buf.data(), &len)) return;
+    for (DWORD off = 0; off + sizeof(TOPO_PROC_INFO) <= len;) {
+        const TOPO_PROC_INFO* info = (const TOPO_PROC_INFO*)(buf.data() + off);
+        if (!info->Size) break;
+        off += info->Size;
+        // A core never spans groups; only group 0 has metric slots
+        const TOPO_GROUP_AFFINITY& ga = info->GroupMask[0];
+        if (ga.Group != 0) continue;
+        int first = -1;
+        for (int b = 0; b < 8 * (int)sizeof(ga.Mask) && b < g_numCores; b++) {
+            if (!((ga.Mask >> b) & 1)) continue;
+            if (first < 0) first = b;
+            g_metrics.SetU(METRIC_CPU_PHYS, (uint64_t)first, b);
+            g_metrics.SetU(METRIC_CPU_CLASS, info->EfficiencyClass, b);
+        }
+    }
+}
 
 void InitCpu() {
     HMODULE ntdll = GetModuleHandleW(L"ntdll.dll");
@@ -10,8 +90,18 @@ void InitCpu() {
     g_numCores = (int)si.dwNumberOfProcessors;
     if (g_numCores > 128) g_numCores = 128;
 
-    g_coreUse.resize(g_numCores, 0.0);
+    g_metrics.SetU(METRIC_CPU_CORES, g_numCores);
     g_prevCpu.resize(g_numCores);
+    GetActiveProcessorCount_t activeCount = (GetActiveProcessorCount_t)GetProcAddress(
+        GetModuleHandleW(L"kernel32.dll"), "GetActiveProcessorCount");
+    DWORD all = activeCount ? activeCount(ALL_GROUPS) : 0;
+    g_power.resize(all > si.dwNumberOfProcessors ? all : si.dwNumberOfProcessors);
+    InitTopology();
+
+    if (!g_perfQuery && PdhOpenQueryW(nullptr, 0, &g_perfQuery) == ERROR_SUCCESS &&
+        PdhAddEnglishCounterW(g_perfQuery, L"\\Processor Information(*)\\% Processor Performance",
+                              0, &g_perfCtr) == ERROR_SUCCESS)
+        PdhCollectQueryData(g_perfQuery);
 
     if (g_NtQSI) {
         ULONG ret = 0;
@@ -20,7 +110,49 @@ void InitCpu() {
     }
 }
 
+// Effective clock per core; throttle events are the times the firmware or
+// thermal limit (MhzLimit) dropped below the rated clock since start
+static void UpdateFreq() {
+    ULONG bytes = (ULONG)(g_power.size() * sizeof(PROC_POWER_INFO));
+    if (!bytes || CallNtPowerInformation(ProcessorInformation, nullptr, 0, g_power.data(), bytes) != 0) {
+        // Unknown, not zero: the exporter and tooltip leave them out
+        for (int i = 0; i < g_numCores; i++) {
+            g_metrics.SetF(METRIC_CPU_FREQ, -1, i);
+            g_metrics.SetF(METRIC_CPU_FREQ_MAX, -1, i);
+            g_metrics.SetF(METRIC_CPU_THROTTLE, -1, i);
+        }
+        return;
+    }
+    double perf[128];
+    for (int i = 0; i < g_numCores; i++) perf[i] = -1;
+    DWORD size = 0, count = 0;
+    if (g_perfCtr && PdhCollectQueryData(g_perfQuery) == ERROR_SUCCESS &&
+        PdhGetFormattedCounterArrayW(g_perfCtr, PDH_FMT_DOUBLE, &size, &count, nullptr) == PDH_MORE_DATA) {
+        g_perfBuf.resize(size);
+        PDH_FMT_COUNTERVALUE_ITEM_W* items = (PDH_FMT_COUNTERVALUE_ITEM_W*)g_perfBuf.data();
+        if (PdhGetFormattedCounterArrayW(g_perfCtr, PDH_FMT_DOUBLE, &size, &count, items) == ERROR_SUCCESS) {
+            // "0,_Total" and "_Total" don't parse as two numbers
+            for (DWORD k = 0; k < count; k++) {
+                int grp, num;
+                if (swscanf_s(items[k].szName, L"%d,%d", &grp, &num) == 2 && grp == 0 &&
+                    num >= 0 && num < g_numCores && items[k].FmtValue.CStatus == PDH_CSTATUS_VALID_DATA)
+                    perf[num] = items[k].FmtValue.doubleValue;
+            }
+        }
+    }
+    for (int i = 0; i < g_numCores; i++) {
+        const PROC_POWER_INFO& p = g_power[i];
+        bool limited = p.MhzLimit < p.MaxMhz;
+        if (limited && !g_limited[i]) g_throttle[i]++;
+        g_limited[i] = limited;
+        g_metrics.SetF(METRIC_CPU_FREQ, perf[i] >= 0 ? p.MaxMhz * perf[i] / 100.0 : (double)p.CurrentMhz, i);
+        g_metrics.SetF(METRIC_CPU_FREQ_MAX, p.MaxMhz, i);
+        g_metrics.SetF(METRIC_CPU_THROTTLE, g_throttle[i], i);
+    }
+}
+
 void UpdateCpu() {
+    UpdateFreq();
     if (!g_NtQSI) return;
     std::vector<PROC_PERF_INFO> cur(g_numCores);
     ULONG ret = 0;
@@ -35,9 +167,19 @@ void UpdateCpu() {
         LONGLONG dT = dK + dU;
         double u = (dT > 0) ? (1.0 - (double)dI / dT) * 100.0 : 0.0;
         if (u < 0) u = 0; if (u > 100) u = 100;
-        g_coreUse[i] = u;
+        g_metrics.SetF(METRIC_CPU_CORE, u, i);
+        RollupPushCore(i, (float)u);
         sum += u;
     }
-    g_totalCpu = g_numCores > 0 ? sum / g_numCores : 0;
+    double total = g_numCores > 0 ? sum / g_numCores : 0;
+    g_metrics.SetF(METRIC_CPU_TOTAL, total);
+    TopoAggregate(g_metrics);
     g_prevCpu = cur;
+    RollupPush(HIST_CPU, (float)total);
+}
+
+void CleanupCpu() {
+    if (g_perfQuery) PdhCloseQuery(g_perfQuery);
+    g_perfQuery = nullptr;
+    g_perfCtr   = nullptr;
 }
@@ -3,7 +3,15 @@
 
 #include "libs/globals/globals.h"
 
+// Per-core usage (NtQuerySystemInformation), plus the effective clock
+// (PDH "% Processor Performance" of the rated clock, else the power
+// manager's current clock) and the times the clock limit dropped below
+// the rated clock. InitCpu reads the topology (GetLogicalProcessorInformationEx,
+// Win7+, resolved at run time). Like the usage, all of it covers processor
+// group 0 only: cores in other groups (hosts with more than 64) are not
+// reported.
 void InitCpu();
 void UpdateCpu();
+void CleanupCpu();
 
 #endif
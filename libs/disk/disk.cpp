@@ -1,18 +1,22 @@
 #include "libs/disk/disk.h"
+#include "libs/metrics/metrics.h"
 
 void UpdateDisk() {
-    g_numVols = 0;
+    int n = 0;
     wchar_t drives[128];
-    DWORD len = GetLogicalDriveStringsW(127, drives);
-    for (wchar_t* d = drives; *d && g_numVols < 26; d += wcslen(d) + 1) {
+    GetLogicalDriveStringsW(127, drives);
+    for (wchar_t* d = drives; *d && n < METRIC_MAX_VOLS; d += wcslen(d) + 1) {
         if (GetDriveTypeW(d) == DRIVE_FIXED) {
             ULARGE_INTEGER avail, total;
             if (GetDiskFreeSpaceExW(d, &avail, &total, nullptr)) {
-                g_vols[g_numVols].letter = d[0];
-                g_vols[g_numVols].totalGB = total.QuadPart / (1024.0 * 1024.0 * 1024.0);
-                g_vols[g_numVols].usedGB = (total.QuadPart - avail.QuadPart) / (1024.0 * 1024.0 * 1024.0);
-                g_numVols++;
+                char letter = (char)d[0];
+                snprintf(g_metrics.volLabel[n], sizeof(g_metrics.volLabel[n]), "%c:", letter);
+                snprintf(g_metrics.volPath[n],  sizeof(g_metrics.volPath[n]),  "%c:\\", letter);
+                g_metrics.SetF(METRIC_DISK_TOTAL, total.QuadPart / (1024.0 * 1024.0 * 1024.0), n);
+                g_metrics.SetF(METRIC_DISK_USED, (total.QuadPart - avail.QuadPart) / (1024.0 * 1024.0 * 1024.0), n);
+                n++;
             }
         }
     }
+    g_metrics.SetU(METRIC_DISK_VOLS, n);
 }
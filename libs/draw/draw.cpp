@@ -1,7 +1,9 @@
 #include "libs/draw/draw.h"
 #include "libs/util/util.h"
 #include "libs/layout/layout.h"
+#include "libs/sampler/sampler.h"
 #include "libs/gdip/gdip.h"
+#include "libs/perf/perf.h"
 
 static void FillRoundRect(Gdiplus::Graphics& g, Gdiplus::Brush& br,
                           float x, float y, float w, float h, float r) {
@@ -25,24 +27,226 @@ static void StrokeRoundRect(Gdiplus::Graphics& g, Gdiplus::Pen& pen,
     g.DrawPath(&pen, &p);
 }
 
+static const float CPU_BAR_INSET = 82.f;
+static const float MEM_BAR_W     = 100.f;
+static const float SWAP_BAR_W    = 98.f;
+static const float VOL_BAR_W     = 35.f;
+static const float VAL_INSET     = 144.f;   // RAM/Swap/GPU value column
+static const float NET_SPARK_W   = 90.f;
+static const float SPARK_H       = 18.f;
+static const float PLUG_LABEL_W  = 52.f;
+static const float PLUG_BAR_W    = 40.f;
+static const float THERM_LABEL_W = 48.f;
+static const double THERM_HOT_C  = 85.0;
+static const ULONGLONG THROTTLE_MARK_MS = 5000;
+
+// "coretemp Package id 0" -> "Package id", the chip name is in the tooltip
+static void SensorShort(const char* label, wchar_t* out, int cap) {
+    const char* sp = strchr(label, ' ');
+    MultiByteToWideChar(CP_UTF8, 0, sp ? sp + 1 : label, -1, out, cap);
+    out[cap - 1] = 0;
+}
+
+// Bar fill in quarter pixels: GDI+ antialiases sub-pixel edges, so anything
+// finer than that is invisible.
+static int BarQ(float w, double pct) {
+    return (int)(w * pct / 25.0);
+}
+
 static void DrawBar(Gdiplus::Graphics& g, float x, float y, float w, float h,
-                    double pct, Gdiplus::Color col) {
+                    int fillQ, Gdiplus::Color col) {
     Gdiplus::SolidBrush bg(Gdiplus::Color(40, 255, 255, 255));
     FillRoundRect(g, bg, x, y, w, h, h / 2);
-    float fw = (float)(w * pct / 100.0);
+    float fw = fillQ / 4.f;
     if (fw > h) {
         Gdiplus::SolidBrush fb(col);
         FillRoundRect(g, fb, x, y, fw, h, h / 2);
     }
 }
 
-static Gdiplus::Color UsageCol(double p) {
-    if (p < 50) return Gdiplus::Color(255, 0, 230, 118);
-    if (p < 80) return Gdiplus::Color(255, 255, 171, 0);
+// scale <= 0 autoscales to the largest value in view (at least 1 KB/s)
+static void BuildSpark(SparkModel& s, const History& h, float w, float scale) {
+    float mn[SPARK_COLS], mx[SPARK_COLS];
+    int cols = (int)(w / 2);
+    if (cols > SPARK_COLS) cols = SPARK_COLS;
+    int n = HistMinMax(h, cols, mn, mx);
+    if (scale <= 0) {
+        scale = 1024.f;
+        for (int i = 0; i < n; i++) if (mx[i] > scale) scale = mx[i];
+    }
+    s.cols = (BYTE)cols;
+    s.n    = (BYTE)n;
+    for (int i = 0; i < n; i++) {
+        float lo = mn[i] / scale * SPARK_H, hi = mx[i] / scale * SPARK_H;
+        s.lo[i] = (BYTE)(lo < 0 ? 0 : lo > SPARK_H ? SPARK_H : lo + 0.5f);
+        s.hi[i] = (BYTE)(hi < 0 ? 0 : hi > SPARK_H ? SPARK_H : hi + 0.5f);
+    }
+}
+
+// Faint area up to each column's max, brighter band over its min..max range
+static void DrawSpark(Gdiplus::Graphics& g, const SparkModel& s,
+                      float x, float y, float w, Gdiplus::Color col) {
+    if (s.n == 0) return;
+    Gdiplus::RectF area[SPARK_COLS], band[SPARK_COLS];
+    float cw = w / s.cols;
+    float bottom = y + SPARK_H;
+    for (int i = 0; i < s.n; i++) {
+        float cx = x + w - (s.n - i) * cw;
+        float bh = (float)(s.hi[i] - s.lo[i]);
+        area[i] = Gdiplus::RectF(cx, bottom - s.hi[i], cw, (float)s.hi[i]);
+        band[i] = Gdiplus::RectF(cx, bottom - s.hi[i], cw, bh < 1 ? 1.f : bh);
+    }
+    Gdiplus::SolidBrush ab(Gdiplus::Color(28, col.GetR(), col.GetG(), col.GetB()));
+    Gdiplus::SolidBrush bb(Gdiplus::Color(70, col.GetR(), col.GetG(), col.GetB()));
+    g.FillRectangles(&ab, area, s.n);
+    g.FillRectangles(&bb, band, s.n);
+}
+
+static BYTE UsageIdx(double p) {
+    if (p < 50) return 0;
+    if (p < 80) return 1;
+    return 2;
+}
+
+static Gdiplus::Color UsageCol(BYTE idx) {
+    if (idx == 0) return Gdiplus::Color(255, 0, 230, 118);
+    if (idx == 1) return Gdiplus::Color(255, 255, 171, 0);
     return Gdiplus::Color(255, 255, 23, 68);
 }
 
-void DrawContent(Gdiplus::Graphics& g, int W, int H) {
+// True for THROTTLE_MARK_MS after a core's throttle counter moves; the
+// first reading (events since boot) only sets the baseline
+static bool ThrottledRecently(int i, double count, ULONGLONG now) {
+    static bool      have[128];
+    static double    seen[128];
+    static ULONGLONG until[128];
+    if (count < 0) return false;
+    if (have[i] && count > seen[i]) until[i] = now + THROTTLE_MARK_MS;
+    have[i] = true;
+    seen[i] = count;
+    return now < until[i];
+}
+
+void BuildDisplayModel(DisplayModel& m) {
+    memset(&m, 0, sizeof(m));
+
+    SYSTEMTIME st; GetLocalTime(&st);
+    const wchar_t* days[]   = {L"Sun",L"Mon",L"Tue",L"Wed",L"Thu",L"Fri",L"Sat"};
+    const wchar_t* months[] = {L"Jan",L"Feb",L"Mar",L"Apr",L"May",L"Jun",
+                               L"Jul",L"Aug",L"Sep",L"Oct",L"Nov",L"Dec"};
+    swprintf_s(m.date, L"%s, %s %d, %d", days[st.wDayOfWeek],
+               months[st.wMonth-1], st.wDay, st.wYear);
+    swprintf_s(m.time, L"%02d:%02d:%02d", st.wHour, st.wMinute, st.wSecond);
+
+    const Snapshot&  s  = CurSnapshot();
+    const MetricSet& mt = s.m;
+    double cpu = mt.F(METRIC_CPU_TOTAL);
+    swprintf_s(m.cpu, L"CPU  %.0f%%", cpu);
+    m.cpuBarQ  = BarQ((int)CurLayout().sec[SEC_ID_CPU].w - CPU_BAR_INSET, cpu);
+    m.cpuCol   = UsageIdx(cpu);
+    const Layout& cl = CurLayout();
+    ULONGLONG now = GetTickCount64();
+    int order[128];
+    m.numCores = TopoOrder(mt, order, m.coreMark);
+    for (int k = 0; k < m.numCores; k++) {
+        int i = order[k];
+        double u = mt.F(METRIC_CPU_CORE, i);
+        m.coreAlpha[k] = (BYTE)(80 + u * 1.75);
+        m.coreCol[k]   = UsageIdx(u);
+        // Clock as a share of the core's maximum; turbo above the rated
+        // clock (Windows) pins it at the top
+        double f = mt.F(METRIC_CPU_FREQ, i), fmax = mt.F(METRIC_CPU_FREQ_MAX, i);
+        if (f > 0 && fmax > 0 && k < (int)cl.cores.size())
+            m.coreFreqQ[k] = (BYTE)(cl.cores[k].h * 4 * (f < fmax ? f / fmax : 1.0));
+        m.coreThrottled[k] = ThrottledRecently(i, mt.F(METRIC_CPU_THROTTLE, i), now);
+        if ((m.coreMark[k] & TOPO_SIBLING) && UsageIdx(u) == 2 &&
+            UsageIdx(mt.F(METRIC_CPU_CORE, order[k + 1])) == 2)
+            m.coreMark[k] |= CORE_CONTENDED;
+    }
+
+    ULONGLONG ramUsed  = mt.U(METRIC_RAM_USED),  ramTotal  = mt.U(METRIC_RAM_TOTAL);
+    ULONGLONG swapUsed = mt.U(METRIC_SWAP_USED), swapTotal = mt.U(METRIC_SWAP_TOTAL);
+    wchar_t uBuf[32], tBuf[32];
+    FmtMem(ramUsed, uBuf, 32); FmtMem(ramTotal, tBuf, 32);
+    swprintf_s(m.ram, L"%s / %s", uBuf, tBuf);
+    double ramPct = ramTotal > 0 ? ramUsed * 100.0 / ramTotal : 0;
+    m.ramBarQ = BarQ(MEM_BAR_W, ramPct);
+
+    FmtMem(swapUsed, uBuf, 32); FmtMem(swapTotal, tBuf, 32);
+    swprintf_s(m.swap, L"%s / %s", uBuf, tBuf);
+    double swpPct = swapTotal > 0 ? swapUsed * 100.0 / swapTotal : 0;
+    m.swapBarQ = BarQ(SWAP_BAR_W, swpPct);
+
+    double gpu = mt.F(METRIC_GPU_USAGE);
+    swprintf_s(m.gpu, L"%.0f%%", gpu);
+    m.gpuBarQ = BarQ(SWAP_BAR_W, gpu);
+    m.gpuCol  = UsageIdx(gpu);
+
+    m.numVols = mt.Vols();
+    for (int v = 0; v < m.numVols; v++) {
+        double pct = mt.VolPct(v);
+        swprintf_s(m.vols[v].label, L"%hs", mt.volLabel[v]);
+        swprintf_s(m.vols[v].pct, L"%.0f%%", pct);
+        m.vols[v].barQ = BarQ(VOL_BAR_W, pct);
+        m.vols[v].high = pct >= 80;
+    }
+
+    wchar_t upS[32], dnS[32];
+    FmtSpeed(mt.F(METRIC_NET_UP),   upS, 32);
+    FmtSpeed(mt.F(METRIC_NET_DOWN), dnS, 32);
+    swprintf_s(m.up,   L"\u2191 %s", upS);
+    swprintf_s(m.down, L"\u2193 %s", dnS);
+    swprintf_s(m.lan, L"%s", s.lanIP);
+
+    m.numPlugins = s.numPlugins;
+    for (int i = 0; i < s.numPlugins; i++) {
+        const PluginValue& pv = s.plugins[i];
+        MultiByteToWideChar(CP_UTF8, 0, pv.label, -1, m.plugins[i].label, 24);
+        if (!pv.text[0]) wcscpy_s(m.plugins[i].text, pv.stale ? L"n/a" : L"...");
+        else MultiByteToWideChar(CP_UTF8, 0, pv.text, -1, m.plugins[i].text, 48);
+        m.plugins[i].barQ  = pv.pct >= 0 ? BarQ(PLUG_BAR_W, pv.pct) : -1;
+        m.plugins[i].stale = pv.stale;
+    }
+
+    m.numSensors = ThermCells(mt);
+    for (int i = 0; i < m.numSensors; i++) {
+        if (i < mt.Temps()) {
+            double c = mt.F(METRIC_TEMP, i);
+            SensorShort(mt.tempLabel[i], m.sensors[i].label, 12);
+            swprintf_s(m.sensors[i].text, L"%.0f\u00B0C", c);
+            m.sensors[i].hot = c >= THERM_HOT_C;
+        } else {
+            int f = i - mt.Temps();
+            SensorShort(mt.fanLabel[f], m.sensors[i].label, 12);
+            swprintf_s(m.sensors[i].text, L"%.0f", mt.F(METRIC_FAN, f));
+            m.sensors[i].hot = false;
+        }
+    }
+
+    BuildSpark(m.spark[HIST_CPU],      s.hist[HIST_CPU],      CurLayout().sec[SEC_ID_CPU].w, 100.f);
+    BuildSpark(m.spark[HIST_RAM],      s.hist[HIST_RAM],      SEC_MEM_W - VAL_INSET, 100.f);
+    BuildSpark(m.spark[HIST_GPU],      s.hist[HIST_GPU],      SEC_MEM_W - VAL_INSET, 100.f);
+    BuildSpark(m.spark[HIST_NET_DOWN], s.hist[HIST_NET_DOWN], NET_SPARK_W, 0);
+    BuildSpark(m.spark[HIST_NET_UP],   s.hist[HIST_NET_UP],   NET_SPARK_W, 0);
+
+    std::shared_ptr<const ExtData> ext = std::atomic_load(&g_ext);
+    swprintf_s(m.ip, L"%s", ext->ip.c_str());
+    if (ext->loaded) {
+        if (!ext->country.empty())
+            swprintf_s(m.loc, L"%s, %s", ext->city.c_str(), ext->country.c_str());
+        else
+            swprintf_s(m.loc, L"%s", ext->city.c_str());
+    } else {
+        wcscpy_s(m.loc, L"Loading...");
+    }
+    if (ext->loaded && ext->wcode >= 0) {
+        double f = ext->temp * 9.0 / 5.0 + 32.0;
+        swprintf_s(m.wx, L"%s %.0f\u00B0C/%.0f\u00B0F",
+                   ext->wdesc.c_str(), ext->temp, f);
+    }
+}
+
+void DrawContent(Gdiplus::Graphics& g, const DisplayModel& m, int W, int H) {
     using namespace Gdiplus;
 
     const float R1 = 6.f;
@@ -62,153 +266,156 @@ void DrawContent(Gdiplus::Graphics& g, int W, int H) {
     StringFormat sfR; sfR.SetAlignment(StringAlignmentFar);  sfR.SetFormatFlags(StringFormatFlagsNoWrap);
     StringFormat sfC; sfC.SetAlignment(StringAlignmentCenter); sfC.SetFormatFlags(StringFormatFlagsNoWrap);
 
-    float x = (float)BAR_PAD;
-
-    {
-        float sw = (float)SEC_TIME_W;
-        SYSTEMTIME st; GetLocalTime(&st);
-        const wchar_t* days[]   = {L"Sun",L"Mon",L"Tue",L"Wed",L"Thu",L"Fri",L"Sat"};
-        const wchar_t* months[] = {L"Jan",L"Feb",L"Mar",L"Apr",L"May",L"Jun",
-                                   L"Jul",L"Aug",L"Sep",L"Oct",L"Nov",L"Dec"};
-        wchar_t dateBuf[64];
-        swprintf_s(dateBuf, L"%s, %s %d, %d", days[st.wDayOfWeek],
-                   months[st.wMonth-1], st.wDay, st.wYear);
-        g.DrawString(dateBuf, -1, g_fDate, RectF(x, R1, sw, RH), &sfC, &dim);
-
-        wchar_t timeBuf[16];
-        swprintf_s(timeBuf, L"%02d:%02d:%02d", st.wHour, st.wMinute, st.wSecond);
-        g.DrawString(timeBuf, -1, g_fTime, RectF(x, R2 - 2, sw, RH + 4), &sfC, &white);
-        x += sw;
-    }
-
-    x += 8; g.DrawLine(&sep, x, 6.f, x, (float)H - 6.f); x += 8;
-
-    {
-        float sw = (float)CalcCpuSecW();
-        wchar_t cpuBuf[32];
-        swprintf_s(cpuBuf, L"CPU  %.0f%%", g_totalCpu);
-        g.DrawString(cpuBuf, -1, g_fTitle, RectF(x, R1, 70, RH), &sfL, &accent);
-        DrawBar(g, x + 70, R1 + 6, sw - 82, 7, g_totalCpu, UsageCol(g_totalCpu));
-
-        for (int i = 0; i < g_numCores; i++) {
-            float bx = x + i * 10.f;
-            float by = (float)H - 6.f - 18.f;
-            Color uc = UsageCol(g_coreUse[i]);
-            BYTE alpha = (BYTE)(80 + g_coreUse[i] * 1.75);
-            SolidBrush cb(Color(alpha, uc.GetR(), uc.GetG(), uc.GetB()));
-            FillRoundRect(g, cb, bx, by, 8, 18, 2);
-        }
-        x += sw;
+    const Layout& l = CurLayout();
+    for (int i = 0; i < l.numSeps; i++)
+        g.DrawLine(&sep, l.sepX[i], 6.f, l.sepX[i], (float)H - 6.f);
+
+    if (l.on[SEC_ID_TIME]) {
+        float x = l.sec[SEC_ID_TIME].x, sw = l.sec[SEC_ID_TIME].w;
+        g.DrawString(m.date, -1, g_fDate, RectF(x, R1, sw, RH), &sfC, &dim);
+        g.DrawString(m.time, -1, g_fTime, RectF(x, R2 - 2, sw, RH + 4), &sfC, &white);
     }
 
-    x += 8; g.DrawLine(&sep, x, 6.f, x, (float)H - 6.f); x += 8;
+    if (l.on[SEC_ID_CPU]) {
+        float x = l.sec[SEC_ID_CPU].x, sw = l.sec[SEC_ID_CPU].w;
+        DrawSpark(g, m.spark[HIST_CPU], x, R1, sw, Color(255, 100, 200, 255));
+        g.DrawString(m.cpu, -1, g_fTitle, RectF(x, R1, 70, RH), &sfL, &accent);
+        DrawBar(g, x + 70, R1 + 6, sw - CPU_BAR_INSET, 7, m.cpuBarQ, UsageCol(m.cpuCol));
+
+        for (int i = 0; i < m.numCores; i++) {
+            const LayoutRect& r = l.cores[i];
+            Color uc = UsageCol(m.coreCol[i]);
+            SolidBrush cb(Color(m.coreAlpha[i], uc.GetR(), uc.GetG(), uc.GetB()));
+            FillRoundRect(g, cb, r.x, r.y, r.w, r.h, 2);
+            if (m.coreFreqQ[i]) {
+                SolidBrush fb(Color(200, 255, 255, 255));
+                g.FillRectangle(&fb, r.x, r.y + r.h - m.coreFreqQ[i] / 4.f, r.w, 1.5f);
+            }
+            if (m.coreThrottled[i]) {
+                Pen tp(Color(255, 224, 64, 251), 1.f);
+                StrokeRoundRect(g, tp, r.x + .5f, r.y + .5f, r.w - 1, r.h - 1, 2);
+            }
+            // SMT pairs share a bracket underneath, red while both are busy;
+            // a tick in the gap where the efficiency class changes
+            if ((m.coreMark[i] & TOPO_SIBLING) && i + 1 < m.numCores) {
+                const LayoutRect& n = l.cores[i + 1];
+                SolidBrush sb((m.coreMark[i] & CORE_CONTENDED) ? Color(255, 255, 23, 68)
+                                                               : Color(90, 255, 255, 255));
+                g.FillRectangle(&sb, r.x, r.y + r.h + 2, n.x + n.w - r.x, 1.f);
+            }
+            if (m.coreMark[i] & TOPO_CLASS) {
+                SolidBrush cs(Color(120, 255, 255, 255));
+                g.FillRectangle(&cs, r.x - (r.x - l.cores[i - 1].x - l.cores[i - 1].w) / 2 - .5f, r.y, 1.f, r.h);
+            }
+        }
+    }
 
-    {
-        float sw = (float)SEC_MEM_W;
-        wchar_t uBuf[32], tBuf[32];
+    if (l.on[SEC_ID_MEM]) {
+        float x = l.sec[SEC_ID_MEM].x, sw = l.sec[SEC_ID_MEM].w;
+        DrawSpark(g, m.spark[HIST_RAM], x + VAL_INSET, R1 + 1, sw - VAL_INSET, Color(255, 100, 180, 255));
+        if (g_sections.gpu)
+            DrawSpark(g, m.spark[HIST_GPU], x + VAL_INSET, R3 + 1, sw - VAL_INSET, UsageCol(m.gpuCol));
 
-        FmtMem(g_ramUsedMB, uBuf, 32); FmtMem(g_ramTotalMB, tBuf, 32);
-        wchar_t ramV[64]; swprintf_s(ramV, L"%s / %s", uBuf, tBuf);
         g.DrawString(L"RAM", -1, g_fTitle, RectF(x, R1, 38, RH), &sfL, &accent);
-        double ramPct = g_ramTotalMB > 0 ? g_ramUsedMB * 100.0 / g_ramTotalMB : 0;
-        DrawBar(g, x + 40, R1 + 7, 100, 6, ramPct, Color(255, 100, 180, 255));
-        g.DrawString(ramV, -1, g_fSmall, RectF(x + 144, R1 + 1, sw - 144, RH), &sfL, &dim);
+        DrawBar(g, x + 40, R1 + 7, MEM_BAR_W, 6, m.ramBarQ, Color(255, 100, 180, 255));
+        g.DrawString(m.ram, -1, g_fSmall, RectF(x + VAL_INSET, R1 + 1, sw - VAL_INSET, RH), &sfL, &dim);
 
-        FmtMem(g_swapUsedMB, uBuf, 32); FmtMem(g_swapTotalMB, tBuf, 32);
-        wchar_t swpV[64]; swprintf_s(swpV, L"%s / %s", uBuf, tBuf);
         g.DrawString(L"Swap", -1, g_fTitle, RectF(x, R2, 40, RH), &sfL, &accent);
-        double swpPct = g_swapTotalMB > 0 ? g_swapUsedMB * 100.0 / g_swapTotalMB : 0;
-        DrawBar(g, x + 42, R2 + 7, 98, 6, swpPct, Color(255, 180, 130, 255));
-        g.DrawString(swpV, -1, g_fSmall, RectF(x + 144, R2 + 1, sw - 144, RH), &sfL, &dim);
+        DrawBar(g, x + 42, R2 + 7, SWAP_BAR_W, 6, m.swapBarQ, Color(255, 180, 130, 255));
+        g.DrawString(m.swap, -1, g_fSmall, RectF(x + VAL_INSET, R2 + 1, sw - VAL_INSET, RH), &sfL, &dim);
 
-        wchar_t gpuV[32];
-        swprintf_s(gpuV, L"%.0f%%", g_gpuUsagePct);
-        g.DrawString(L"GPU", -1, g_fTitle, RectF(x, R3, 40, RH), &sfL, &accent);
-        DrawBar(g, x + 42, R3 + 7, 98, 6, g_gpuUsagePct, UsageCol(g_gpuUsagePct));
-        g.DrawString(gpuV, -1, g_fSmall, RectF(x + 144, R3 + 1, sw - 144, RH), &sfL, &dim);
-        x += sw;
+        if (g_sections.gpu) {
+            g.DrawString(L"GPU", -1, g_fTitle, RectF(x, R3, 40, RH), &sfL, &accent);
+            DrawBar(g, x + 42, R3 + 7, SWAP_BAR_W, 6, m.gpuBarQ, UsageCol(m.gpuCol));
+            g.DrawString(m.gpu, -1, g_fSmall, RectF(x + VAL_INSET, R3 + 1, sw - VAL_INSET, RH), &sfL, &dim);
+        }
     }
 
-    x += 8; g.DrawLine(&sep, x, 6.f, x, (float)H - 6.f); x += 8;
+    if (l.on[SEC_ID_DISK]) {
+        for (int v = 0; v < m.numVols && v < (int)l.vols.size(); v++) {
+            float cx = l.vols[v].x, cy = l.vols[v].y;
 
-    {
-        float colW = (float)SEC_DISK_COL_W;
-        for (int v = 0; v < g_numVols; v++) {
-            int col = v / 2;
-            int row = v % 2;
-            float cx = x + col * colW;
-            float cy = (row == 0) ? R1 : R2;
+            g.DrawString(m.vols[v].label, -1, g_fTitle, RectF(cx, cy, 22, RH), &sfL, &accent);
 
-            wchar_t lbl[4]; swprintf_s(lbl, L"%c:", g_vols[v].letter);
-            g.DrawString(lbl, -1, g_fTitle, RectF(cx, cy, 22, RH), &sfL, &accent);
+            Color bc = !m.vols[v].high ? Color(255, 100, 180, 255) : Color(255, 255, 80, 60);
+            DrawBar(g, cx + 24, cy + 7, VOL_BAR_W, 6, m.vols[v].barQ, bc);
 
-            double pct = g_vols[v].totalGB > 0 ? g_vols[v].usedGB * 100.0 / g_vols[v].totalGB : 0;
-            Color bc = pct < 80 ? Color(255, 100, 180, 255) : Color(255, 255, 80, 60);
-            DrawBar(g, cx + 24, cy + 7, 35, 6, pct, bc);
-
-            wchar_t pL[8]; swprintf_s(pL, L"%.0f%%", pct);
             SolidBrush pBr(bc);
-            g.DrawString(pL, -1, g_fSmall, RectF(cx + 62, cy + 1, 32, RH), &sfL, &pBr);
+            g.DrawString(m.vols[v].pct, -1, g_fSmall, RectF(cx + 62, cy + 1, 32, RH), &sfL, &pBr);
         }
-        x += (float)CalcDiskSecW();
     }
 
-    x += 8; g.DrawLine(&sep, x, 6.f, x, (float)H - 6.f); x += 8;
-
-    {
-        float sw = (float)SEC_IPNET_W;
-        wchar_t upS[32], dnS[32];
-        FmtSpeed(g_netUp,   upS, 32);
-        FmtSpeed(g_netDown, dnS, 32);
-        wchar_t upL[48], dnL[48];
-        swprintf_s(upL, L"\u2191 %s", upS);
-        swprintf_s(dnL, L"\u2193 %s", dnS);
+    if (l.on[SEC_ID_NET]) {
+        float x = l.sec[SEC_ID_NET].x, sw = l.sec[SEC_ID_NET].w;
+        DrawSpark(g, m.spark[HIST_NET_UP],   x + sw - NET_SPARK_W, R1, NET_SPARK_W, Color(255, 0, 230, 118));
+        DrawSpark(g, m.spark[HIST_NET_DOWN], x + sw - NET_SPARK_W, R2, NET_SPARK_W, Color(255, 255, 100, 70));
 
-        {
-            std::lock_guard<std::mutex> lk(g_extMtx);
+        if (g_sections.ip) {
             g.DrawString(L"IP", -1, g_fTitle, RectF(x, R1, 18, RH), &sfL, &accent);
-            g.DrawString(g_ext.ip.c_str(), -1, g_fSmall, RectF(x + 18, R1 + 1, sw - 100, RH), &sfL, &dim);
+            g.DrawString(m.ip, -1, g_fSmall, RectF(x + 18, R1 + 1, sw - 100, RH), &sfL, &dim);
         }
-        g.DrawString(upL, -1, g_fVal, RectF(x, R1, sw, RH), &sfR, &green);
+        g.DrawString(m.up, -1, g_fVal, RectF(x, R1, sw, RH), &sfR, &green);
 
         g.DrawString(L"LAN", -1, g_fTitle, RectF(x, R2, 36, RH), &sfL, &accent);
-        g.DrawString(g_lanIP.c_str(), -1, g_fSmall, RectF(x + 36, R2 + 1, sw - 118, RH), &sfL, &dim);
-        g.DrawString(dnL, -1, g_fVal, RectF(x, R2, sw, RH), &sfR, &orange);
-
-        x += sw;
+        g.DrawString(m.lan, -1, g_fSmall, RectF(x + 36, R2 + 1, sw - 118, RH), &sfL, &dim);
+        g.DrawString(m.down, -1, g_fVal, RectF(x, R2, sw, RH), &sfR, &orange);
     }
 
-    x += 8; g.DrawLine(&sep, x, 6.f, x, (float)H - 6.f); x += 8;
+    if (l.on[SEC_ID_WX]) {
+        float x = l.sec[SEC_ID_WX].x, wxW = l.sec[SEC_ID_WX].w;
+        g.DrawString(m.loc, -1, g_fTitle, RectF(x, R1, wxW, RH), &sfL, &accent);
+        if (m.wx[0])
+            g.DrawString(m.wx, -1, g_fVal, RectF(x, R2, wxW, RH), &sfL, &white);
+    }
 
-    {
-        std::lock_guard<std::mutex> lk(g_extMtx);
-        float wxW = (float)SEC_WX_W;
-        wchar_t locL[128];
-        if (g_ext.loaded) {
-            if (!g_ext.country.empty())
-                swprintf_s(locL, L"%s, %s", g_ext.city.c_str(), g_ext.country.c_str());
-            else
-                swprintf_s(locL, L"%s", g_ext.city.c_str());
-        } else {
-            wcscpy_s(locL, L"Loading...");
+    if (l.on[SEC_ID_PLUGIN]) {
+        SolidBrush staleBr(Color(150, 170, 170, 185));
+        for (int i = 0; i < m.numPlugins && i < (int)l.plugins.size(); i++) {
+            const LayoutRect& r = l.plugins[i];
+            g.DrawString(m.plugins[i].label, -1, g_fTitle, RectF(r.x, r.y, PLUG_LABEL_W, RH), &sfL, &accent);
+            float vx = r.x + PLUG_LABEL_W;
+            if (m.plugins[i].barQ >= 0) {
+                DrawBar(g, vx, r.y + 7, PLUG_BAR_W, 6, m.plugins[i].barQ, Color(255, 100, 180, 255));
+                vx += PLUG_BAR_W + 4;
+            }
+            g.DrawString(m.plugins[i].text, -1, g_fSmall, RectF(vx, r.y + 1, r.x + r.w - vx - 4, RH), &sfL,
+                         m.plugins[i].stale ? &staleBr : &dim);
         }
-        g.DrawString(locL, -1, g_fTitle, RectF(x, R1, wxW, RH), &sfL, &accent);
-
-        if (g_ext.loaded && g_ext.wcode >= 0) {
-            double f = g_ext.temp * 9.0 / 5.0 + 32.0;
-            wchar_t wL[128];
-            swprintf_s(wL, L"%s %.0f\u00B0C/%.0f\u00B0F",
-                       g_ext.wdesc.c_str(), g_ext.temp, f);
-            g.DrawString(wL, -1, g_fVal, RectF(x, R2, wxW, RH), &sfL, &white);
+    }
+
+    if (l.on[SEC_ID_THERMAL]) {
+        if (!m.numSensors)
+            g.DrawString(L"no sensors", -1, g_fSmall, RectF(l.sec[SEC_ID_THERMAL].x, R1 + 1,
+                         l.sec[SEC_ID_THERMAL].w, RH), &sfL, &dim);
+        for (int i = 0; i < m.numSensors && i < (int)l.sensors.size(); i++) {
+            const LayoutRect& r = l.sensors[i];
+            g.DrawString(m.sensors[i].label, -1, g_fSmall, RectF(r.x, r.y + 1, THERM_LABEL_W, RH), &sfL, &accent);
+            g.DrawString(m.sensors[i].text, -1, g_fVal, RectF(r.x, r.y, r.w - 6, RH), &sfR,
+                         m.sensors[i].hot ? &orange : &white);
         }
     }
 }
 
-void Render() {
+// Render() is skipped entirely (no GDI+ work, no UpdateLayeredWindow) when
+// the display model matches the last presented frame.
+void Render(bool force) {
     if (!g_hwnd || !g_visible) return;
+    static DisplayModel cur, prev;
+    static bool havePrev = false;
+
     int W = CalcWidth(), H = WIDGET_H;
+    uint64_t t = PerfNow();
+    BuildDisplayModel(cur);
+    t = PerfLap(PERF_MODEL, t);
+    if (!force && havePrev && g_dibW == W && g_dibH == H &&
+        memcmp(&cur, &prev, sizeof(cur)) == 0) {
+        g_framesSkipped++;
+        return;
+    }
+
     EnsureDIB(W, H);
     memset(g_dibBits, 0, W * H * 4);
+    t = PerfLap(PERF_CLEAR, t);
 
     Gdiplus::Graphics g(g_memDC);
     g.SetSmoothingMode(Gdiplus::SmoothingModeAntiAlias);
@@ -219,8 +426,10 @@ void Render() {
 
     Gdiplus::Pen border(Gdiplus::Color(50, 255, 255, 255), 1.f);
     StrokeRoundRect(g, border, 0.5f, 0.5f, W - 1.f, H - 1.f, 10);
+    t = PerfLap(PERF_CHROME, t);
 
-    DrawContent(g, W, H);
+    DrawContent(g, cur, W, H);
+    t = PerfLap(PERF_CONTENT, t);
 
     HDC scr = GetDC(nullptr);
     RECT wr; GetWindowRect(g_hwnd, &wr);
@@ -231,4 +440,9 @@ void Render() {
     bf.SourceConstantAlpha = 255; bf.AlphaFormat = AC_SRC_ALPHA;
     UpdateLayeredWindow(g_hwnd, scr, &dst, &sz, g_memDC, &src, 0, &bf, ULW_ALPHA);
     ReleaseDC(nullptr, scr);
+    PerfLap(PERF_PRESENT, t);
+
+    prev = cur;
+    havePrev = true;
+    g_framesDrawn++;
 }
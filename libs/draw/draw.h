@@ -2,8 +2,81 @@
 #define SYSMON_DRAW_H
 
 #include "libs/globals/globals.h"
+#include "libs/rollup/rollup.h"
+#include "libs/plugins/plugins.h"
+#include "libs/topology/topology.h"
 
-void DrawContent(Gdiplus::Graphics& g, int W, int H);
-void Render();
+static const int SPARK_COLS = 96;
+
+// Slot and its SMT sibling in the next slot are both busy
+static const BYTE CORE_CONTENDED = 0x80;
+
+// A history sparkline reduced to per-column min/max heights in pixels,
+// right-aligned while the history is still filling up.
+struct SparkModel {
+    BYTE cols;
+    BYTE n;
+    BYTE lo[SPARK_COLS];
+    BYTE hi[SPARK_COLS];
+};
+
+// Everything DrawContent() puts on screen, quantized to what is actually
+// visible (formatted text, bar fills in quarter pixels, core block colours).
+// Two models compare equal with memcmp iff the frames would look the same.
+struct DisplayModel {
+    wchar_t date[32];
+    wchar_t time[16];
+
+    wchar_t cpu[16];
+    int     cpuBarQ;
+    BYTE    cpuCol;
+    int     numCores;               // per-core arrays are in display slot order
+    BYTE    coreAlpha[128];
+    BYTE    coreCol[128];
+    BYTE    coreFreqQ[128];         // clock mark height in quarter pixels, 0 = unknown
+    bool    coreThrottled[128];     // throttle counter moved in the last few seconds
+    BYTE    coreMark[128];          // TOPO_* flags, CORE_CONTENDED
+
+    wchar_t ram[64];
+    wchar_t swap[64];
+    wchar_t gpu[16];
+    int     ramBarQ, swapBarQ, gpuBarQ;
+    BYTE    gpuCol;
+
+    int     numVols;
+    struct {
+        wchar_t label[4];
+        wchar_t pct[8];
+        int     barQ;
+        bool    high;
+    } vols[26];
+
+    wchar_t up[48], down[48];
+    wchar_t ip[64];
+    wchar_t lan[48];
+    wchar_t loc[128];
+    wchar_t wx[128];
+
+    int     numPlugins;
+    struct {
+        wchar_t label[24];
+        wchar_t text[48];
+        int     barQ;               // -1 = no bar
+        bool    stale;
+    } plugins[PLUGIN_MAX];
+
+    int     numSensors;
+    struct {
+        wchar_t label[12];
+        wchar_t text[12];
+        bool    hot;
+    } sensors[THERM_CELLS];
+
+    SparkModel spark[HIST_COUNT];
+};
+
+void BuildDisplayModel(DisplayModel& m);
+void DrawContent(Gdiplus::Graphics& g, const DisplayModel& m, int W, int H);
+void Render(bool force = false);
 
 #endif
@@ -0,0 +1,266 @@
+#include "libs/exporter/exporter.h"
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+typedef SOCKET sock_t;
+static const sock_t BAD_SOCK = INVALID_SOCKET;
+static void CloseSock(sock_t s) { closesocket(s); }
+#else
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+typedef int sock_t;
+static const sock_t BAD_SOCK = -1;
+static void CloseSock(sock_t s) { close(s); }
+#endif
+
+#include <atomic>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <thread>
+
+// ---------------------------------------------------------------------------
+// Rendering
+// ---------------------------------------------------------------------------
+// Bounded printf cursor; sticks at !ok once the buffer is full
+struct TextOut {
+    char* p;
+    char* end;
+    bool  ok;
+
+    void Fmt(const char* fmt, ...) {
+        if (!ok) return;
+        va_list ap;
+        va_start(ap, fmt);
+        int n = vsnprintf(p, (size_t)(end - p), fmt, ap);
+        va_end(ap);
+        if (n < 0 || n >= end - p) { ok = false; return; }
+        p += n;
+    }
+};
+
+// Exported unit: MB/GB and MHz are converted to base units (bytes, hertz) as
+// OpenMetrics asks
+static const char* ExportUnit(MetricUnit u, double* scale) {
+    *scale = 1;
+    switch (u) {
+    case UNIT_COUNT:         return "";
+    case UNIT_PERCENT:       return "percent";
+    case UNIT_MB:            *scale = 1024.0 * 1024.0; return "bytes";
+    case UNIT_GB:            *scale = 1024.0 * 1024.0 * 1024.0; return "bytes";
+    case UNIT_BYTES_PER_SEC: return "bytes_per_second";
+    case UNIT_WATTS:         return "watts";
+    case UNIT_SECONDS:       return "seconds";
+    case UNIT_CELSIUS:       return "celsius";
+    case UNIT_RPM:           return "rpm";
+    case UNIT_MHZ:           *scale = 1e6; return "hertz";
+    }
+    return "";
+}
+
+// "disk.used" + "bytes" -> "sysmon_disk_used_bytes"
+static void FamilyName(const char* name, const char* unit, char* out, size_t cap) {
+    size_t n = (size_t)snprintf(out, cap, "sysmon_%s%s%s", name, *unit ? "_" : "", unit);
+    for (size_t i = 0; i < n && i < cap; i++)
+        if (out[i] == '.') out[i] = '_';
+}
+
+// Label value with \, " and newline escaped
+static void LabelValue(TextOut& o, const char* s) {
+    char buf[160];
+    size_t n = 0;
+    for (; *s && n + 2 < sizeof(buf); s++) {
+        if (*s == '\\' || *s == '"') buf[n++] = '\\';
+        if (*s == '\n') { buf[n++] = '\\'; buf[n++] = 'n'; continue; }
+        buf[n++] = *s;
+    }
+    buf[n] = 0;
+    o.Fmt("%s", buf);
+}
+
+size_t RenderOpenMetrics(const MetricSet& m, char* buf, size_t cap) {
+    TextOut o{buf, buf + cap, true};
+    for (int id = 0; id < METRIC_COUNT; id++) {
+        const MetricDesc& d = g_metricDesc[id];
+        // No battery, or no estimate yet: leave the family out
+        if ((id == METRIC_BATTERY || id == METRIC_POWER_DRAW || id == METRIC_POWER_TTE) &&
+            m.F((MetricId)id) < 0) continue;
+        if (id == METRIC_POWER_STATE && m.F(METRIC_BATTERY) < 0) continue;
+        if (id == METRIC_THERM_CPU && (!m.Temps() || m.F(METRIC_THERM_CPU) < 0)) continue;
+        if (id == METRIC_CPU_ECORES && m.F(METRIC_CPU_ECORES) < 0) continue;
+        // No cpufreq / throttle counters on this host
+        if ((id == METRIC_CPU_FREQ || id == METRIC_CPU_FREQ_MAX || id == METRIC_CPU_THROTTLE) &&
+            (!m.Cores() || m.F((MetricId)id) < 0)) continue;
+        double scale;
+        const char* unit = ExportUnit(d.unit, &scale);
+        char fam[64];
+        FamilyName(d.name, unit, fam, sizeof(fam));
+        o.Fmt("# TYPE %s gauge\n", fam);
+        if (*unit) o.Fmt("# UNIT %s %s\n", fam, unit);
+
+        int n = m.Len((MetricId)id);
+        for (int i = 0; i < n; i++) {
+            o.Fmt("%s", fam);
+            if (MetricPerCore(id)) o.Fmt("{core=\"%d\"}", i);
+            else if (id == METRIC_DISK_USED || id == METRIC_DISK_TOTAL) {
+                o.Fmt("{volume=\"");
+                LabelValue(o, m.volPath[i]);
+                o.Fmt("\"}");
+            } else if (id == METRIC_TEMP || id == METRIC_FAN) {
+                o.Fmt(id == METRIC_TEMP ? "{sensor=\"" : "{fan=\"");
+                LabelValue(o, id == METRIC_TEMP ? m.tempLabel[i] : m.fanLabel[i]);
+                o.Fmt("\"}");
+            }
+            if (d.type == MT_F64) o.Fmt(" %.10g\n", m.F((MetricId)id, i) * scale);
+            else                  o.Fmt(" %.10g\n", (double)m.U((MetricId)id, i) * scale);
+        }
+    }
+    o.Fmt("# EOF\n");
+    return o.ok ? (size_t)(o.p - buf) : 0;
+}
+
+// ---------------------------------------------------------------------------
+// Listener
+// ---------------------------------------------------------------------------
+static const int EXPORT_POLL_MS = 250;      // stop-flag latency of the accept loop
+static const int EXPORT_RECV_MS = 1000;     // per-request read timeout
+
+static std::atomic<bool> g_exportOn(false);
+static std::thread       g_exportThread;
+static sock_t            g_listenSock = BAD_SOCK;
+
+// Latest published set; the sampler only try-locks this
+static std::mutex        g_pubMtx;
+static MetricSet         g_pub;
+static bool              g_pubHave = false;
+
+// Owned by the exporter thread, reused for every scrape
+static MetricSet         g_scrape;
+static char              g_body[65536];
+static char              g_req[1024];
+
+void ExporterPublish(const MetricSet& m) {
+    if (!g_exportOn.load(std::memory_order_relaxed)) return;
+    if (!g_pubMtx.try_lock()) return;
+    memcpy(&g_pub, &m, sizeof(g_pub));
+    g_pubHave = true;
+    g_pubMtx.unlock();
+}
+
+static void SendAll(sock_t s, const char* p, size_t n) {
+    while (n > 0) {
+        int w = send(s, p, (int)n, 0);
+        if (w <= 0) return;
+        p += w;
+        n -= (size_t)w;
+    }
+}
+
+static void Reply(sock_t s, const char* status, const char* type, const char* body, size_t len) {
+    char hdr[256];
+    int n = snprintf(hdr, sizeof(hdr),
+        "HTTP/1.1 %s\r\nContent-Type: %s\r\nContent-Length: %u\r\nConnection: close\r\n\r\n",
+        status, type, (unsigned)len);
+    SendAll(s, hdr, (size_t)n);
+    SendAll(s, body, len);
+}
+
+static void Serve(sock_t s) {
+    // Read until the end of the request head; bodies are not expected
+    int n = 0;
+    while (n < (int)sizeof(g_req) - 1) {
+        int r = recv(s, g_req + n, (int)sizeof(g_req) - 1 - n, 0);
+        if (r <= 0) break;
+        n += r;
+        g_req[n] = 0;
+        if (strstr(g_req, "\r\n\r\n")) break;
+    }
+    g_req[n] = 0;
+
+    static const char TEXT[] = "text/plain; charset=utf-8";
+    bool get = strncmp(g_req, "GET ", 4) == 0;
+    const char* path = g_req + 4;
+    if (!get || !(strncmp(path, "/metrics ", 9) == 0 || strncmp(path, "/ ", 2) == 0)) {
+        Reply(s, "404 Not Found", TEXT, "not found\n", 10);
+        return;
+    }
+
+    bool have;
+    {
+        std::lock_guard<std::mutex> lk(g_pubMtx);
+        have = g_pubHave;
+        if (have) memcpy(&g_scrape, &g_pub, sizeof(g_scrape));
+    }
+    size_t len = have ? RenderOpenMetrics(g_scrape, g_body, sizeof(g_body)) : 0;
+    if (!len) {
+        Reply(s, "503 Service Unavailable", TEXT, "no sample yet\n", 14);
+        return;
+    }
+    Reply(s, "200 OK", "application/openmetrics-text; version=1.0.0; charset=utf-8", g_body, len);
+}
+
+static void ExporterThread() {
+    while (g_exportOn.load()) {
+        fd_set rd;
+        FD_ZERO(&rd);
+        FD_SET(g_listenSock, &rd);
+        timeval tv = { 0, EXPORT_POLL_MS * 1000 };
+        if (select((int)g_listenSock + 1, &rd, nullptr, nullptr, &tv) <= 0) continue;
+        sock_t c = accept(g_listenSock, nullptr, nullptr);
+        if (c == BAD_SOCK) continue;
+#ifdef _WIN32
+        DWORD to = EXPORT_RECV_MS;
+#else
+        timeval to = { EXPORT_RECV_MS / 1000, (EXPORT_RECV_MS % 1000) * 1000 };
+#endif
+        setsockopt(c, SOL_SOCKET, SO_RCVTIMEO, (const char*)&to, sizeof(to));
+        setsockopt(c, SOL_SOCKET, SO_SNDTIMEO, (const char*)&to, sizeof(to));
+        Serve(c);
+        CloseSock(c);
+    }
+}
+
+bool StartExporter(int port) {
+    if (port <= 0 || port > 65535 || g_exportOn.load()) return false;
+#ifdef _WIN32
+    WSADATA wsa;
+    if (WSAStartup(MAKEWORD(2, 2), &wsa) != 0) return false;
+#endif
+    sock_t s = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (s == BAD_SOCK) return false;
+#ifndef _WIN32
+    int one = 1;
+    setsockopt(s, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+#endif
+    sockaddr_in a = {};
+    a.sin_family      = AF_INET;
+    a.sin_port        = htons((unsigned short)port);
+    a.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (bind(s, (sockaddr*)&a, sizeof(a)) != 0 || listen(s, 8) != 0) {
+        CloseSock(s);
+#ifdef _WIN32
+        WSACleanup();
+#endif
+        return false;
+    }
+    g_listenSock = s;
+    g_exportOn.store(true);
+    g_exportThread = std::thread(ExporterThread);
+    return true;
+}
+
+void StopExporter() {
+    if (!g_exportOn.exchange(false)) return;
+    if (g_exportThread.joinable()) g_exportThread.join();
+    CloseSock(g_listenSock);
+    g_listenSock = BAD_SOCK;
+#ifdef _WIN32
+    WSACleanup();
+#endif
+}
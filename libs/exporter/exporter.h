@@ -0,0 +1,25 @@
+// SysMonitor - OpenMetrics exporter
+// Portable: shared by the Windows, macOS and Linux builds.
+// Serves GET /metrics on 127.0.0.1:<port> from its own thread. The sampler
+// hands each new MetricSet over with ExporterPublish(), which only ever
+// try-locks: a scrape in progress can make the export skip a tick, but it
+// never stalls sampling.
+#ifndef SYSMON_EXPORTER_H
+#define SYSMON_EXPORTER_H
+
+#include <cstddef>
+
+#include "libs/metrics/metrics.h"
+
+// OpenMetrics text exposition of m, terminated by "# EOF".
+// Bytes written, or 0 if cap is too small.
+size_t RenderOpenMetrics(const MetricSet& m, char* buf, size_t cap);
+
+// false if the port cannot be bound
+bool StartExporter(int port);
+void StopExporter();
+
+// Call from the sampling thread after each tick; no-op unless started
+void ExporterPublish(const MetricSet& m);
+
+#endif // SYSMON_EXPORTER_H
@@ -2,6 +2,8 @@
 #include "libs/http/http.h"
 #include "libs/json/json.h"
 #include "libs/util/util.h"
+#include "libs/config/config.h"
+#include "libs/footprint/footprint.h"
 
 const wchar_t* WeatherDesc(int c) {
     switch (c) {
@@ -35,12 +37,15 @@ static void FetchExternal() {
     double lat = JNum(ij, L"lat");
     double lon = JNum(ij, L"lon");
 
-    wchar_t wpath[512];
-    swprintf_s(wpath,
-        L"/v1/forecast?latitude=%.4f&longitude=%.4f"
-        L"&current=temperature_2m,weather_code&current_weather=true",
-        lat, lon);
-    std::string wResp = HttpGet(L"api.open-meteo.com", wpath, true);
+    std::string wResp;
+    if (SectionOn(SEC_ID_WX)) {
+        wchar_t wpath[512];
+        swprintf_s(wpath,
+            L"/v1/forecast?latitude=%.4f&longitude=%.4f"
+            L"&current=temperature_2m,weather_code&current_weather=true",
+            lat, lon);
+        wResp = HttpGet(L"api.open-meteo.com", wpath, true);
+    }
 
     double temp = 0;
     int wcode = -1;
@@ -64,21 +69,27 @@ static void FetchExternal() {
         }
     }
 
-    std::lock_guard<std::mutex> lk(g_extMtx);
-    g_ext.ip      = ip.empty() ? L"N/A" : ip;
-    g_ext.city    = city.empty() ? L"Unknown" : city;
-    g_ext.country = cc;
-    g_ext.lat     = lat;
-    g_ext.lon     = lon;
-    g_ext.temp    = temp;
-    g_ext.wcode   = wcode;
-    g_ext.wdesc   = (wcode >= 0) ? WeatherDesc(wcode) : L"N/A";
-    g_ext.loaded  = true;
+    auto ext = std::make_shared<ExtData>();
+    ext->ip      = ip.empty() ? L"N/A" : ip;
+    ext->city    = city.empty() ? L"Unknown" : city;
+    ext->country = cc;
+    ext->lat     = lat;
+    ext->lon     = lon;
+    ext->temp    = temp;
+    ext->wcode   = wcode;
+    ext->wdesc   = (wcode >= 0) ? WeatherDesc(wcode) : L"N/A";
+    ext->loaded  = true;
+    std::atomic_store(&g_ext, std::shared_ptr<const ExtData>(std::move(ext)));
 }
 
+// No timer of its own: the sampler's scheduler sets g_fetchEvt every
+// BG_FETCH_MS, on a wakeup it already has
 DWORD WINAPI BgThread(LPVOID) {
+    HANDLE evts[2] = { g_shutdownEvt, g_fetchEvt };
     FetchExternal();
-    while (WaitForSingleObject(g_shutdownEvt, BG_FETCH_MS) == WAIT_TIMEOUT)
+    while (WaitForMultipleObjects(2, evts, FALSE, INFINITE) == WAIT_OBJECT_0 + 1) {
+        FootprintWake();
         FetchExternal();
+    }
     return 0;
 }
@@ -0,0 +1,246 @@
+#include "libs/footprint/footprint.h"
+
+#ifdef _WIN32
+#include <windows.h>
+// GetProcessMemoryInfo from psapi.dll; version 2 maps it to the Win7+
+// K32GetProcessMemoryInfo in kernel32, which Vista doesn't export
+#define PSAPI_VERSION 1
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#include <dirent.h>
+#include <unistd.h>
+#ifdef __APPLE__
+#include <libproc.h>
+#include <mach/mach.h>
+#endif
+#endif
+
+#include <atomic>
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+static const double EMA_MS = 30000.0;
+
+// One raw reading: cumulative CPU and wakeups, current RSS and handles
+struct Reading {
+    uint64_t cpuUs, wakeups;
+    double   rssMB;
+    int      handles;
+};
+
+static std::atomic<uint64_t> g_wakes(0);
+static std::atomic<int>      g_shed(SHED_NONE);
+static FootprintBudget g_budget   = {};
+static Footprint       g_avg      = {};
+static Reading         g_last     = {};
+static uint64_t        g_lastMs   = 0;
+static uint64_t        g_changeMs = 0;      // last level change
+static uint64_t        g_overMs   = 0;      // start of the current over-budget run
+static uint64_t        g_underMs  = 0;      // start of the current all-clear run
+static char            g_note[128];
+
+#ifdef _WIN32
+
+static bool Read(Reading& r) {
+    FILETIME c, e, k, u;
+    if (!GetProcessTimes(GetCurrentProcess(), &c, &e, &k, &u)) return false;
+    ULARGE_INTEGER kk = { { k.dwLowDateTime, k.dwHighDateTime } };
+    ULARGE_INTEGER uu = { { u.dwLowDateTime, u.dwHighDateTime } };
+    r.cpuUs = (kk.QuadPart + uu.QuadPart) / 10;
+    PROCESS_MEMORY_COUNTERS pmc = { sizeof(pmc) };
+    r.rssMB = GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))
+            ? pmc.WorkingSetSize / 1048576.0 : 0;
+    DWORD h = 0;
+    r.handles = GetProcessHandleCount(GetCurrentProcess(), &h) ? (int)h : 0;
+    r.wakeups = g_wakes.load(std::memory_order_relaxed);
+    return true;
+}
+
+#else
+
+static int CountFds() {
+#ifdef __APPLE__
+    int bytes = proc_pidinfo(getpid(), PROC_PIDLISTFDS, 0, nullptr, 0);
+    return bytes > 0 ? bytes / (int)PROC_PIDLISTFD_SIZE : 0;
+#else
+    DIR* d = opendir("/proc/self/fd");
+    if (!d) return 0;
+    int n = 0;
+    while (dirent* e = readdir(d)) if (e->d_name[0] != '.') n++;
+    closedir(d);
+    return n > 0 ? n - 1 : 0;   // minus the directory's own fd
+#endif
+}
+
+static double RssMB() {
+#ifdef __APPLE__
+    mach_task_basic_info_data_t info;
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, (task_info_t)&info, &count) != KERN_SUCCESS)
+        return 0;
+    return info.resident_size / 1048576.0;
+#else
+    long pages = 0, rss = 0;
+    FILE* f = fopen("/proc/self/statm", "r");
+    if (!f) return 0;
+    if (fscanf(f, "%ld %ld", &pages, &rss) != 2) rss = 0;
+    fclose(f);
+    return (double)rss * sysconf(_SC_PAGESIZE) / 1048576.0;
+#endif
+}
+
+static bool Read(Reading& r) {
+    rusage ru;
+    if (getrusage(RUSAGE_SELF, &ru) != 0) return false;
+    r.cpuUs = (uint64_t)(ru.ru_utime.tv_sec + ru.ru_stime.tv_sec) * 1000000ull
+            + (uint64_t)(ru.ru_utime.tv_usec + ru.ru_stime.tv_usec);
+    r.wakeups = (uint64_t)(ru.ru_nvcsw + ru.ru_nivcsw);
+    r.rssMB   = RssMB();
+    r.handles = CountFds();
+    return true;
+}
+
+#endif
+
+void FootprintWake() {
+    g_wakes.fetch_add(1, std::memory_order_relaxed);
+}
+
+bool ParseBudget(const char* spec, FootprintBudget& b, std::string* error) {
+    FootprintBudget out = {};
+    const char* p = spec;
+    for (;;) {
+        while (isspace((unsigned char)*p) || *p == ',') p++;
+        if (!*p) break;
+        const char* key = p;
+        while (isalpha((unsigned char)*p)) p++;
+        size_t kl = (size_t)(p - key);
+        while (isspace((unsigned char)*p)) p++;
+        char* end;
+        double v = strtod(p, &end);
+        if (end == p || v < 0) {
+            if (error) *error = std::string("budget: expected a number after '") + std::string(key, kl) + "'";
+            return false;
+        }
+        p = end;
+        while (isalpha((unsigned char)*p) || *p == '%' || *p == '/') p++;     // unit suffix
+        if (kl == 3 && strncmp(key, "cpu", 3) == 0)            out.cpuPct  = v;
+        else if (kl == 3 && strncmp(key, "rss", 3) == 0)       out.rssMB   = v;
+        else if (kl == 7 && strncmp(key, "wakeups", 7) == 0)  out.wakeups = v;
+        else {
+            if (error) *error = "budget: unknown limit '" + std::string(key, kl) + "' (cpu, rss, wakeups)";
+            return false;
+        }
+    }
+    b = out;
+    return true;
+}
+
+void SetFootprintBudget(const FootprintBudget& b) {
+    g_budget = b;
+}
+
+// Describes the first limit the averages exceed, or returns false
+static bool Over(const Footprint& f, double scale, char* why, size_t cap) {
+    if (g_budget.cpuPct > 0 && f.cpuPct > g_budget.cpuPct * scale) {
+        snprintf(why, cap, "cpu %.1f%% > %.1f%%", f.cpuPct, g_budget.cpuPct * scale);
+        return true;
+    }
+    if (g_budget.rssMB > 0 && f.rssMB > g_budget.rssMB * scale) {
+        snprintf(why, cap, "rss %.0f MB > %.0f MB", f.rssMB, g_budget.rssMB * scale);
+        return true;
+    }
+    if (g_budget.wakeups > 0 && f.wakeups > g_budget.wakeups * scale) {
+        snprintf(why, cap, "wakeups %.1f/s > %.1f/s", f.wakeups, g_budget.wakeups * scale);
+        return true;
+    }
+    return false;
+}
+
+static const char* ShedText(int level) {
+    switch (level) {
+    case SHED_PROBES:  return "optional probes off";
+    case SHED_RATE_2X: return "probes off, sampling period x2";
+    case SHED_RATE_4X: return "probes off, sampling period x4";
+    default:           return "everything back on";
+    }
+}
+
+bool FootprintTick(uint64_t nowMs) {
+    if (g_lastMs && nowMs - g_lastMs < FOOTPRINT_PERIOD_MS) return false;
+    Reading r;
+    if (!Read(r)) return false;
+    if (!g_lastMs) {
+        g_last = r;
+        g_lastMs = nowMs;
+        return false;
+    }
+
+    double dt = (double)(nowMs - g_lastMs);
+    double cpu  = (double)(r.cpuUs - g_last.cpuUs) / 10.0 / dt;     // us/ms -> %
+    double wake = (double)(r.wakeups - g_last.wakeups) * 1000.0 / dt;
+    double a = g_avg.valid ? 1.0 - exp(-dt / EMA_MS) : 1.0;
+    g_avg.cpuPct  += a * (cpu - g_avg.cpuPct);
+    g_avg.wakeups += a * (wake - g_avg.wakeups);
+    g_avg.rssMB   += a * (r.rssMB - g_avg.rssMB);
+    g_avg.handles  = r.handles;
+    g_avg.valid    = true;
+    g_last   = r;
+    g_lastMs = nowMs;
+
+    // Escalate one step per hold period while over; relax after a long
+    // stretch comfortably under, so the level doesn't oscillate
+    char why[64];
+    int level = g_shed.load(std::memory_order_relaxed), next = level;
+    if (Over(g_avg, 1.0, why, sizeof(why))) {
+        g_underMs = 0;
+        if (!g_overMs) g_overMs = nowMs;
+        if (level < SHED_RATE_4X && nowMs - g_overMs >= FOOTPRINT_HOLD_MS &&
+            nowMs - g_changeMs >= FOOTPRINT_HOLD_MS)
+            next = level + 1;
+    } else {
+        g_overMs = 0;
+        if (level > SHED_NONE && !Over(g_avg, 0.6, why, sizeof(why))) {
+            if (!g_underMs) g_underMs = nowMs;
+            if (nowMs - g_underMs >= FOOTPRINT_RELAX_MS) {
+                next = level - 1;
+                g_underMs = 0;
+                snprintf(why, sizeof(why), "back under budget");
+            }
+        } else {
+            g_underMs = 0;
+        }
+    }
+    if (next == level) return false;
+
+    g_shed.store(next, std::memory_order_relaxed);
+    g_changeMs = nowMs;
+    snprintf(g_note, sizeof(g_note), "%s: %s", why, ShedText(next));
+    return true;
+}
+
+Footprint FootprintCur() { return g_avg; }
+
+int FootprintShed() { return g_shed.load(std::memory_order_relaxed); }
+
+int FootprintPeriodScale() {
+    int s = FootprintShed();
+    return s >= SHED_RATE_4X ? 4 : s >= SHED_RATE_2X ? 2 : 1;
+}
+
+const char* FootprintNote() { return g_note; }
+
+size_t FormatFootprint(const Footprint& f, char* buf, size_t cap) {
+    if (!cap) return 0;
+    if (!f.valid) {
+        buf[0] = 0;
+        return 0;
+    }
+    int n = snprintf(buf, cap, "cpu %.1f%%  rss %.1f MB  %d handles  %.1f wakeups/s",
+                     f.cpuPct, f.rssMB, f.handles, f.wakeups);
+    return n < 0 ? 0 : (size_t)n < cap ? (size_t)n : cap - 1;
+}
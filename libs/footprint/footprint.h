@@ -0,0 +1,67 @@
+// SysMonitor - Self-footprint and overhead budget
+// Portable: shared by the Windows, macOS and Linux builds.
+// Measures the process's own CPU time, resident set, open handles (fds on
+// macOS/Linux) and wakeups every FOOTPRINT_PERIOD_MS and keeps ~30 s moving
+// averages. An optional budget caps them:
+//   Windows      HKCU\Software\SysMonitor  "Budget" (REG_SZ)
+//   Linux/macOS  "budget = ..." in the config file
+//   e.g.         cpu 1% rss 80MB wakeups 5
+// While any average is over budget the shed level rises one step per
+// FOOTPRINT_HOLD_MS; it drops a step once everything has stayed under
+// 60% of the budget for FOOTPRINT_RELAX_MS:
+//   SHED_PROBES    optional probes off (GPU query, window-behind, LAN IP)
+//   SHED_RATE_2X   and the sampling period doubled
+//   SHED_RATE_4X   and quadrupled
+// Every change is recorded in FootprintNote().
+// Wakeups are context switches (getrusage) on macOS/Linux. Windows has no
+// cheap per-process counter, so its threads count their own with
+// FootprintWake().
+#ifndef SYSMON_FOOTPRINT_H
+#define SYSMON_FOOTPRINT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+static const uint32_t FOOTPRINT_PERIOD_MS = 5000;
+static const uint32_t FOOTPRINT_HOLD_MS   = 30000;
+static const uint32_t FOOTPRINT_RELAX_MS  = 120000;
+
+struct Footprint {
+    double cpuPct;          // of one core
+    double rssMB;
+    int    handles;
+    double wakeups;         // per second
+    bool   valid;           // false until two measurements exist
+};
+
+struct FootprintBudget {
+    double cpuPct, rssMB, wakeups;      // 0 = no limit
+};
+
+enum ShedLevel { SHED_NONE, SHED_PROBES, SHED_RATE_2X, SHED_RATE_4X };
+
+// "cpu 1% rss 80MB wakeups 5", any subset, any order; "" = no budget.
+// false (b untouched) on a syntax error, described in error.
+bool ParseBudget(const char* spec, FootprintBudget& b, std::string* error);
+void SetFootprintBudget(const FootprintBudget& b);
+
+// Windows threads: count one wakeup
+void FootprintWake();
+
+// Sampling thread, once per pass; measures at most every
+// FOOTPRINT_PERIOD_MS. Returns true when the shed level changed.
+bool FootprintTick(uint64_t nowMs);
+
+// Sampling thread (or a copy taken there)
+Footprint FootprintCur();
+int       FootprintShed();
+inline bool ShedProbes() { return FootprintShed() >= SHED_PROBES; }
+int       FootprintPeriodScale();   // 1, 2 or 4
+// Last shed change, e.g. "over budget (cpu 2.1% > 1%): probes off"; "" if none
+const char* FootprintNote();
+
+// "cpu 0.4%  rss 18.2 MB  42 handles  2.0 wakeups/s"
+size_t FormatFootprint(const Footprint& f, char* buf, size_t cap);
+
+#endif // SYSMON_FOOTPRINT_H
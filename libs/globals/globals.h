@@ -18,6 +18,9 @@ typedef LONG(NTAPI* NtQSI_t)(ULONG, PVOID, ULONG, PULONG);
 extern HWND              g_hwnd;
 extern HINSTANCE         g_hInst;
 extern bool              g_visible;
+extern bool              g_sessionLocked;
+extern bool              g_displayOff;
+extern std::atomic<int>  g_powerMode;
 
 extern NOTIFYICONDATA    g_nid;
 extern HICON             g_trayIcon;
@@ -34,37 +37,29 @@ extern HDC               g_memDC;
 extern HBITMAP           g_dib;
 extern void*             g_dibBits;
 extern int               g_dibW, g_dibH;
+extern ULONGLONG         g_framesDrawn, g_framesSkipped;
 
+// Sampler-private state; published values live in g_metrics (libs/metrics)
 extern NtQSI_t           g_NtQSI;
 extern int               g_numCores;
 extern std::vector<PROC_PERF_INFO> g_prevCpu;
-extern std::vector<double> g_coreUse;
-extern double            g_totalCpu;
 
-extern ULONGLONG         g_ramTotalMB, g_ramUsedMB;
-extern ULONGLONG         g_swapTotalMB, g_swapUsedMB;
-
-extern double            g_gpuUsagePct;
 extern ULONGLONG         g_gpuEngPrev, g_gpuTsPrev;
 extern LUID              g_gpuLuid;
 
-extern VolInfo           g_vols[26];
-extern int               g_numVols;
-
 extern ULONGLONG         g_netPrevIn, g_netPrevOut;
 extern ULONGLONG         g_netTick;
-extern double            g_netDown, g_netUp;
 extern bool              g_netInit;
 extern std::wstring      g_lanIP;
 
-extern std::mutex        g_extMtx;
-extern ExtData           g_ext;
+extern std::shared_ptr<const ExtData> g_ext;    // swapped atomically, never mutated
 
 extern HANDLE            g_bgThread;
 extern HANDLE            g_shutdownEvt;
+extern HANDLE            g_fetchEvt;        // auto-reset; the sampler's scheduler sets it when a fetch is due
 
 extern HWND              g_tip;
-extern int               g_hovCore, g_hovVol;
+extern int               g_hovCore, g_hovVol, g_hovSensor;
 extern bool              g_mouseTracking;
 
 #endif // SYSMON_GLOBALS_H
@@ -1,4 +1,6 @@
 #include "libs/gpu/gpu.h"
+#include "libs/rollup/rollup.h"
+#include "libs/metrics/metrics.h"
 
 typedef struct _D3DKMT_OPENADAPTERFROMLUID {
     LUID  AdapterLuid;
@@ -104,7 +106,7 @@ void InitGpuD3dKmt() {
 
 void UpdateGpu() {
     if (!pfnQueryStats || g_gpuNodeCount == 0) {
-        g_gpuUsagePct = 0.0;
+        g_metrics.SetF(METRIC_GPU_USAGE, 0.0);
         return;
     }
 
@@ -138,7 +140,8 @@ void UpdateGpu() {
         double pct = (deltaSec > 0.0) ? (deltaEng / deltaSec) * 100.0 : 0.0;
         if (pct < 0.0) pct = 0.0;
         if (pct > 100.0) pct = 100.0;
-        g_gpuUsagePct = pct;
+        g_metrics.SetF(METRIC_GPU_USAGE, pct);
+        RollupPush(HIST_GPU, (float)pct);
     }
 
     g_gpuEngPrev = totalRunning;
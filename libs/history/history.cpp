@@ -0,0 +1,82 @@
+#include "libs/history/history.h"
+#include <cfloat>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define HIST_SSE 1
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define HIST_NEON 1
+#endif
+
+History g_hist[HIST_COUNT];
+
+void HistPush(History& h, float v) {
+    h.v[h.head] = v;
+    h.head = (h.head + 1) % HIST_CAP;
+    if (h.count < (uint32_t)HIST_CAP) h.count++;
+}
+
+// min/max of a contiguous span, 4 lanes at a time
+static void MinMaxSpan(const float* p, uint32_t n, float& mn, float& mx) {
+    uint32_t i = 0;
+#if defined(HIST_SSE)
+    if (n >= 4) {
+        __m128 vmn = _mm_loadu_ps(p), vmx = vmn;
+        for (i = 4; i + 4 <= n; i += 4) {
+            __m128 x = _mm_loadu_ps(p + i);
+            vmn = _mm_min_ps(vmn, x);
+            vmx = _mm_max_ps(vmx, x);
+        }
+        float a[4], b[4];
+        _mm_storeu_ps(a, vmn);
+        _mm_storeu_ps(b, vmx);
+        for (int k = 0; k < 4; k++) {
+            if (a[k] < mn) mn = a[k];
+            if (b[k] > mx) mx = b[k];
+        }
+    }
+#elif defined(HIST_NEON)
+    if (n >= 4) {
+        float32x4_t vmn = vld1q_f32(p), vmx = vmn;
+        for (i = 4; i + 4 <= n; i += 4) {
+            float32x4_t x = vld1q_f32(p + i);
+            vmn = vminq_f32(vmn, x);
+            vmx = vmaxq_f32(vmx, x);
+        }
+        float a[4], b[4];
+        vst1q_f32(a, vmn);
+        vst1q_f32(b, vmx);
+        for (int k = 0; k < 4; k++) {
+            if (a[k] < mn) mn = a[k];
+            if (b[k] > mx) mx = b[k];
+        }
+    }
+#endif
+    for (; i < n; i++) {
+        if (p[i] < mn) mn = p[i];
+        if (p[i] > mx) mx = p[i];
+    }
+}
+
+// Logical samples [a, b) (0 = oldest) span at most two physical runs
+static void RangeMinMax(const History& h, uint32_t a, uint32_t b, float& mn, float& mx) {
+    uint32_t start = (h.head + HIST_CAP - h.count + a) % HIST_CAP;
+    uint32_t n     = b - a;
+    uint32_t first = n < HIST_CAP - start ? n : HIST_CAP - start;
+    MinMaxSpan(h.v + start, first, mn, mx);
+    if (n > first) MinMaxSpan(h.v, n - first, mn, mx);
+}
+
+int HistMinMax(const History& h, int width, float* mn, float* mx) {
+    if (width <= 0 || h.count == 0) return 0;
+    int cols = (int)h.count < width ? (int)h.count : width;
+    for (int c = 0; c < cols; c++) {
+        uint32_t a = (uint32_t)((uint64_t)c * h.count / cols);
+        uint32_t b = (uint32_t)((uint64_t)(c + 1) * h.count / cols);
+        mn[c] = FLT_MAX;
+        mx[c] = -FLT_MAX;
+        RangeMinMax(h, a, b, mn[c], mx[c]);
+    }
+    return cols;
+}
@@ -0,0 +1,29 @@
+// SysMonitor - Per-metric history (fixed-capacity ring buffers)
+// Portable: shared by the Windows and macOS front ends.
+#ifndef SYSMON_HISTORY_H
+#define SYSMON_HISTORY_H
+
+#include <cstdint>
+
+static const int HIST_CAP = 600;    // 10 min at 1 s
+
+// One metric's last HIST_CAP samples. Fixed size, no allocation, cache-line
+// aligned so a downsample pass streams through contiguous floats.
+struct alignas(64) History {
+    float    v[HIST_CAP];
+    uint32_t head;                  // next write slot
+    uint32_t count;                 // valid samples (<= HIST_CAP)
+};
+
+enum HistId { HIST_CPU, HIST_RAM, HIST_GPU, HIST_NET_DOWN, HIST_NET_UP, HIST_COUNT };
+
+extern History g_hist[HIST_COUNT];
+
+void HistPush(History& h, float v);
+
+// Map the whole history onto `width` columns, oldest first, writing the
+// min and max of each column. Returns the number of columns written: `width`,
+// or fewer (one per sample) while the history is still filling up.
+int  HistMinMax(const History& h, int width, float* mn, float* mx);
+
+#endif // SYSMON_HISTORY_H
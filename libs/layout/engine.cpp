@@ -0,0 +1,131 @@
+#include "libs/layout/engine.h"
+
+#include <cmath>
+#include <cstring>
+
+static LayoutRect Scaled(float x, float y, float w, float h, float s) {
+    return { x * s, y * s, w * s, h * s };
+}
+
+static void AddElem(Layout& l, HitKind kind, int index, const LayoutRect& r) {
+    l.elems.push_back({ (uint8_t)kind, (uint16_t)index, r });
+    uint16_t id = (uint16_t)l.elems.size();
+    // Columns [floor(x), ceil(x + w)): a rect ending exactly on a column
+    // boundary doesn't claim the next one, which belongs to its neighbour
+    int c0 = (int)r.x, c1 = (int)std::ceil(r.x + r.w) - 1;
+    if (c0 < 0) c0 = 0;
+    if (c1 > l.width - 1) c1 = l.width - 1;
+    for (int c = c0; c <= c1; c++) {
+        uint16_t* slot = &l.hitCols[c * HIT_PER_COL];
+        for (int k = 0; k < HIT_PER_COL; k++)
+            if (!slot[k]) { slot[k] = id; break; }
+    }
+}
+
+static void BuildLayout(Layout& l, const LayoutSpec& sp, const int* order, int numSecs,
+                        int numCores, int numVols, int numPlugins, int numSensors, float s) {
+    float secW[SEC_ID_COUNT];
+    float blocksW = numCores * sp.corePitch;
+    int   diskCols = (numVols + 1) / 2;
+    if (diskCols < 1) diskCols = 1;
+    int   plugCols = (numPlugins + sp.plugRows - 1) / sp.plugRows;
+    if (plugCols < 1) plugCols = 1;
+    int   thermCols = (numSensors + sp.plugRows - 1) / sp.plugRows;
+    if (thermCols < 1) thermCols = 1;
+    secW[SEC_ID_TIME] = (float)sp.timeW;
+    secW[SEC_ID_CPU]  = (blocksW > sp.cpuMinW ? blocksW : sp.cpuMinW) + sp.cpuExtraW;
+    secW[SEC_ID_MEM]  = (float)sp.memW;
+    secW[SEC_ID_DISK] = (float)(diskCols * sp.diskColW);
+    secW[SEC_ID_NET]  = (float)sp.netW;
+    secW[SEC_ID_WX]   = (float)sp.wxW;
+    secW[SEC_ID_PLUGIN] = (float)(plugCols * sp.plugColW);
+    secW[SEC_ID_THERMAL] = (float)(thermCols * sp.thermColW);
+
+    memset(l.on, 0, sizeof(l.on));
+    memset(l.sec, 0, sizeof(l.sec));
+    float x = (float)sp.pad;
+    l.numSeps = 0;
+    for (int k = 0; k < numSecs; k++) {
+        int i = order[k];
+        if (k > 0) {
+            l.sepX[l.numSeps++] = (x + sp.gap / 2.f) * s;
+            x += sp.gap;
+        }
+        l.on[i]  = true;
+        l.sec[i] = Scaled(x, 0, secW[i], (float)sp.height, s);
+        x += secW[i];
+    }
+    if (!l.on[SEC_ID_CPU])  numCores = 0;
+    if (!l.on[SEC_ID_DISK]) numVols  = 0;
+    if (!l.on[SEC_ID_PLUGIN]) numPlugins = 0;
+    if (!l.on[SEC_ID_THERMAL]) numSensors = 0;
+    l.width  = (int)((x + sp.pad) * s + 0.5f);
+    l.height = (int)(sp.height * s + 0.5f);
+    l.scale  = s;
+
+    float cpuX = l.sec[SEC_ID_CPU].x / s;
+    l.cores.resize(numCores);
+    for (int i = 0; i < numCores; i++)
+        l.cores[i] = Scaled(cpuX + i * sp.corePitch, sp.coreY, sp.coreW, sp.coreH, s);
+
+    float diskX = l.sec[SEC_ID_DISK].x / s;
+    l.vols.resize(numVols);
+    for (int v = 0; v < numVols; v++)
+        l.vols[v] = Scaled(diskX + (v / 2) * sp.diskColW, sp.volRowY[v % 2],
+                           (float)sp.diskColW, sp.volH, s);
+
+    float plugX = l.sec[SEC_ID_PLUGIN].x / s;
+    l.plugins.resize(numPlugins);
+    for (int i = 0; i < numPlugins; i++)
+        l.plugins[i] = Scaled(plugX + (i / sp.plugRows) * sp.plugColW, sp.plugRowY[i % sp.plugRows],
+                              (float)sp.plugColW, sp.plugH, s);
+
+    float thermX = l.sec[SEC_ID_THERMAL].x / s;
+    l.sensors.resize(numSensors);
+    for (int i = 0; i < numSensors; i++)
+        l.sensors[i] = Scaled(thermX + (i / sp.plugRows) * sp.thermColW, sp.plugRowY[i % sp.plugRows],
+                              (float)sp.thermColW, sp.plugH, s);
+
+    l.elems.clear();
+    l.hitCols.assign((size_t)l.width * HIT_PER_COL, 0);
+    for (int i = 0; i < numCores; i++) AddElem(l, HIT_CORE, i, l.cores[i]);
+    for (int v = 0; v < numVols; v++)  AddElem(l, HIT_VOL,  v, l.vols[v]);
+    for (int i = 0; i < numSensors; i++) AddElem(l, HIT_SENSOR, i, l.sensors[i]);
+}
+
+const Layout& GetLayout(const LayoutSpec& spec, const int* order, int numSecs,
+                        int numCores, int numVols, int numPlugins, int numSensors, float scale) {
+    static Layout            l;
+    static const LayoutSpec* lastSpec  = nullptr;
+    static int               lastOrder[SEC_ID_COUNT], lastSecs = -1;
+    static int               lastCores = -1, lastVols = -1, lastPlugins = -1, lastSensors = -1;
+    static float             lastScale = 0;
+    if (&spec != lastSpec || numSecs != lastSecs || memcmp(order, lastOrder, numSecs * sizeof(int)) ||
+        numCores != lastCores || numVols != lastVols || numPlugins != lastPlugins ||
+        numSensors != lastSensors || scale != lastScale) {
+        BuildLayout(l, spec, order, numSecs, numCores, numVols, numPlugins, numSensors, scale);
+        lastSpec  = &spec;
+        lastSecs  = numSecs;
+        memcpy(lastOrder, order, numSecs * sizeof(int));
+        lastCores = numCores;
+        lastVols  = numVols;
+        lastPlugins = numPlugins;
+        lastSensors = numSensors;
+        lastScale = scale;
+    }
+    return l;
+}
+
+HitKind LayoutHitTest(const Layout& l, float x, float y, int* index) {
+    int c = (int)x;
+    if (x < 0 || c >= l.width) return HIT_NONE;
+    const uint16_t* slot = &l.hitCols[c * HIT_PER_COL];
+    for (int k = 0; k < HIT_PER_COL && slot[k]; k++) {
+        const LayoutElem& e = l.elems[slot[k] - 1];
+        if (e.r.Contains(x, y)) {
+            *index = e.index;
+            return (HitKind)e.kind;
+        }
+    }
+    return HIT_NONE;
+}
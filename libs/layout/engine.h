@@ -0,0 +1,64 @@
+// SysMonitor - Layout engine: section/element rect table + hit grid
+// Portable: shared by the Windows and macOS front ends, which only differ
+// in the LayoutSpec they pass in.
+#ifndef SYSMON_LAYOUT_ENGINE_H
+#define SYSMON_LAYOUT_ENGINE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+enum SectionId { SEC_ID_TIME, SEC_ID_CPU, SEC_ID_MEM, SEC_ID_DISK, SEC_ID_NET, SEC_ID_WX,
+                 SEC_ID_PLUGIN, SEC_ID_THERMAL, SEC_ID_COUNT };
+enum HitKind   { HIT_NONE, HIT_CORE, HIT_VOL, HIT_SENSOR };
+
+struct LayoutRect {
+    float x, y, w, h;
+    bool Contains(float px, float py) const {
+        return px >= x && px < x + w && py >= y && py < y + h;
+    }
+};
+
+// Per-platform geometry, unscaled
+struct LayoutSpec {
+    int   height, pad, gap;                 // gap = space between sections
+    int   timeW, cpuMinW, cpuExtraW, memW, diskColW, netW, wxW;
+    float corePitch, coreY, coreW, coreH;   // per-core blocks
+    float volRowY[2], volH;                 // disk cells, two rows per column
+    int   plugColW, plugRows;               // plugin cells, plugRows per column
+    float plugRowY[3], plugH;
+    int   thermColW;                        // sensor cells, on the plugin row grid
+};
+
+struct LayoutElem {
+    uint8_t    kind;
+    uint16_t   index;
+    LayoutRect r;
+};
+
+static const int HIT_PER_COL = 4;
+
+struct Layout {
+    int        width, height;
+    float      scale;
+    bool       on[SEC_ID_COUNT];
+    LayoutRect sec[SEC_ID_COUNT];           // zero-width when !on
+    float      sepX[SEC_ID_COUNT];          // separator before each section
+    int        numSeps;
+    std::vector<LayoutRect> cores, vols, plugins, sensors;
+
+    // Hit grid: for every pixel column, up to HIT_PER_COL element ids (+1,
+    // 0 = empty) whose rect spans that column.
+    std::vector<LayoutElem> elems;
+    std::vector<uint16_t>   hitCols;
+};
+
+// Returns the cached table for the sections in order[0..numSecs); it is
+// rebuilt only when the spec, section list, core, volume, plugin or sensor
+// count or scale changes.
+const Layout& GetLayout(const LayoutSpec& spec, const int* order, int numSecs,
+                        int numCores, int numVols, int numPlugins, int numSensors, float scale);
+
+HitKind LayoutHitTest(const Layout& l, float x, float y, int* index);
+
+#endif // SYSMON_LAYOUT_ENGINE_H
@@ -1,18 +1,15 @@
 #include "libs/layout/layout.h"
+#include "libs/layout/win_spec.h"
+#include "libs/sampler/sampler.h"
 
-int CalcCpuSecW() {
-    int blocksW = g_numCores * 10;
-    return (blocksW > 110 ? blocksW : 110) + 12;
-}
-
-int CalcDiskSecW() {
-    int cols = (g_numVols + 1) / 2;
-    if (cols < 1) cols = 1;
-    return cols * SEC_DISK_COL_W;
+// The widget draws in physical pixels (process is system-DPI aware and the
+// fonts are pixel-sized), so the table is built unscaled.
+const Layout& CurLayout() {
+    const Snapshot& s = CurSnapshot();
+    return GetLayout(WIN_SPEC, g_sections.order, g_sections.count, s.m.Cores(), s.m.Vols(),
+                     s.numPlugins, ThermCells(s.m), 1.f);
 }
 
 int CalcWidth() {
-    return BAR_PAD + SEC_TIME_W + SEC_SEP + CalcCpuSecW() + SEC_SEP
-         + SEC_MEM_W + SEC_SEP + CalcDiskSecW() + SEC_SEP
-         + SEC_IPNET_W + SEC_SEP + SEC_WX_W + BAR_PAD;
+    return CurLayout().width;
 }
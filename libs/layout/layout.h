@@ -2,9 +2,17 @@
 #define SYSMON_LAYOUT_H
 
 #include "libs/globals/globals.h"
+#include "libs/layout/engine.h"
+#include "libs/config/config.h"
+#include "libs/metrics/metrics.h"
 
-int CalcCpuSecW();
-int CalcDiskSecW();
+// Cached rect table for the configured sections and current core/volume count
+const Layout& CurLayout();
+// Sensor cells in the thermal section: temperatures, then fans
+inline int ThermCells(const MetricSet& m) {
+    int n = m.Temps() + m.Fans();
+    return n < THERM_CELLS ? n : THERM_CELLS;
+}
 int CalcWidth();
 
 #endif
@@ -0,0 +1,29 @@
+// SysMonitor - Windows widget geometry
+// Kept free of <windows.h> so the Linux benchmark and scale tools lay out
+// the same widget the Windows build draws.
+#ifndef SYSMON_LAYOUT_WIN_SPEC_H
+#define SYSMON_LAYOUT_WIN_SPEC_H
+
+#include "libs/layout/engine.h"
+
+static const int    WIDGET_H        = 68;
+static const int    BAR_PAD         = 12;
+static const int    SEC_SEP         = 16;
+static const int    SEC_TIME_W      = 115;
+static const int    SEC_MEM_W       = 238;
+static const int    SEC_IPNET_W     = 190;
+static const int    SEC_WX_W        = 105;
+static const int    SEC_PLUG_COL_W  = 150;
+static const int    SEC_THERM_COL_W = 90;
+static const int    SEC_DISK_COL_W  = 95;
+
+static const LayoutSpec WIN_SPEC = {
+    WIDGET_H, BAR_PAD, SEC_SEP,
+    SEC_TIME_W, 110, 12, SEC_MEM_W, SEC_DISK_COL_W, SEC_IPNET_W, SEC_WX_W,
+    10.f, WIDGET_H - 6.f - 18.f, 8.f, 18.f,
+    { 6.f, 25.f }, 18.f,
+    SEC_PLUG_COL_W, 3, { 6.f, 25.f, 44.f }, 18.f,
+    SEC_THERM_COL_W,
+};
+
+#endif
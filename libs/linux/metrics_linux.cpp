@@ -0,0 +1,878 @@
+// SysMonitor Linux - System metrics from /proc and /sys
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <linux/netlink.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/statvfs.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+
+#include "libs/linux/metrics_linux.h"
+#include "libs/metrics/metrics.h"
+#include "libs/trace/trace.h"
+#include "libs/battery/battery.h"
+#include "libs/topology/topology.h"
+
+// ---------------------------------------------------------------------------
+// Helpers
+// ---------------------------------------------------------------------------
+uint64_t TickMs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000ULL + ts.tv_nsec / 1000000ULL;
+}
+
+// Whole file into buf (NUL-terminated, truncated to cap-1). -1 on error.
+static int ReadFile(const char* path, char* buf, int cap) {
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return -1;
+    int n = 0;
+    while (n < cap - 1) {
+        ssize_t r = read(fd, buf + n, cap - 1 - n);
+        if (r <= 0) break;
+        n += (int)r;
+    }
+    close(fd);
+    buf[n] = 0;
+    return n;
+}
+
+// First line of a small sysfs file, newline stripped
+static bool ReadLine(const char* path, char* buf, int cap) {
+    if (ReadFile(path, buf, cap) <= 0) return false;
+    buf[strcspn(buf, "\n")] = 0;
+    return true;
+}
+
+static const char* NextLine(const char* p) {
+    p = strchr(p, '\n');
+    return p ? p + 1 : nullptr;
+}
+
+// Value of "Key:   1234 kB" in a /proc/meminfo-style buffer, 0 if missing
+static uint64_t FieldKB(const char* buf, const char* key) {
+    size_t kl = strlen(key);
+    for (const char* p = buf; p && *p; p = NextLine(p))
+        if (strncmp(p, key, kl) == 0 && p[kl] == ':')
+            return strtoull(p + kl + 1, nullptr, 10);
+    return 0;
+}
+
+// Every backend read fills g_raw, which is recorded when a trace is being
+// written and then applied. Replay feeds trace records to the same Apply*.
+static TraceSample g_raw;
+
+static RawSource   g_source = nullptr;
+
+static void BeginRaw(TraceKind kind) {
+    g_raw.kind    = (uint8_t)kind;
+    g_raw.tickMs  = TickMs();
+    g_raw.numVals = 0;
+    g_raw.numStrs = 0;
+}
+
+void SetRawSource(RawSource fn) { g_source = fn; }
+
+// Fills g_raw from the installed source, else from the system
+static bool ReadRaw(TraceKind kind, bool (*read)()) {
+    BeginRaw(kind);
+    return g_source ? g_source(g_raw) : read();
+}
+
+// Warns once when the host has more of something than the fixed slots
+static void WarnCap(bool& warned, int have, int cap, const char* what) {
+    if (have <= cap || warned) return;
+    warned = true;
+    fprintf(stderr, "sysmon: %d %s, only the first %d are reported\n", have, what, cap);
+}
+
+// ---------------------------------------------------------------------------
+// CPU
+// ---------------------------------------------------------------------------
+static const int CPU_FIELDS = 8;
+
+static char     g_statBuf[32768];
+static bool     g_cpuInit = false;
+static int      g_numCores = 0;
+static uint64_t g_prevBusy[METRIC_MAX_CORES + 1];   // [0] = aggregate line
+static uint64_t g_prevAll[METRIC_MAX_CORES + 1];
+
+// Raw "cpu" / "cpuN" lines: CPU_FIELDS jiffy counters each
+static bool ReadCpuRaw() {
+    if (ReadFile("/proc/stat", g_statBuf, sizeof(g_statBuf)) <= 0) return false;
+    int n = 0;
+    for (const char* p = g_statBuf; p && (n + 1) * CPU_FIELDS <= TRACE_MAX_VALS; p = NextLine(p)) {
+        if (strncmp(p, "cpu", 3) != 0) break;
+        char* q = (char*)p + 3;
+        while (*q && *q != ' ') q++;
+        // user nice system idle iowait irq softirq steal (guest is in user)
+        uint64_t* t = &g_raw.vals[n * CPU_FIELDS];
+        for (int i = 0; i < CPU_FIELDS; i++) t[i] = strtoull(q, &q, 10);
+        n++;
+    }
+    g_raw.numVals = n * CPU_FIELDS;
+    return n > 0;
+}
+
+// Busy/all jiffies per line. Returns lines.
+static int CpuTimes(const TraceSample& s, uint64_t* busy, uint64_t* all) {
+    static bool warned = false;
+    WarnCap(warned, s.numVals / CPU_FIELDS - 1, METRIC_MAX_CORES, "cores");
+    int n = std::min(s.numVals / CPU_FIELDS, METRIC_MAX_CORES + 1);
+    for (int i = 0; i < n; i++) {
+        const uint64_t* t = &s.vals[i * CPU_FIELDS];
+        uint64_t idle = t[3] + t[4];
+        all[i]  = t[0] + t[1] + t[2] + t[3] + t[4] + t[5] + t[6] + t[7];
+        busy[i] = all[i] - idle;
+    }
+    return n;
+}
+
+static double Pct(uint64_t busy, uint64_t all, uint64_t pBusy, uint64_t pAll) {
+    if (all <= pAll || busy < pBusy) return 0;
+    double u = (double)(busy - pBusy) * 100.0 / (double)(all - pAll);
+    return u < 0 ? 0 : u > 100 ? 100 : u;
+}
+
+// The first sample after start only sets the baseline
+static void ApplyCpu(const TraceSample& s) {
+    uint64_t busy[METRIC_MAX_CORES + 1], all[METRIC_MAX_CORES + 1];
+    int n = CpuTimes(s, busy, all);
+    if (n == 0) return;
+    if (!g_cpuInit) {
+        g_cpuInit = true;
+        g_numCores = std::max(0, std::min(n - 1, METRIC_MAX_CORES));
+        g_metrics.SetU(METRIC_CPU_CORES, g_numCores);
+        // One class, no siblings, until the topology record says otherwise
+        for (int i = 0; i < g_numCores; i++) {
+            g_metrics.SetU(METRIC_CPU_PHYS, (uint64_t)i, i);
+            g_metrics.SetU(METRIC_CPU_CLASS, 0, i);
+        }
+        memcpy(g_prevBusy, busy, n * sizeof(uint64_t));
+        memcpy(g_prevAll,  all,  n * sizeof(uint64_t));
+        return;
+    }
+    g_metrics.SetF(METRIC_CPU_TOTAL, Pct(busy[0], all[0], g_prevBusy[0], g_prevAll[0]));
+    for (int i = 0; i < g_numCores && i + 1 < n; i++)
+        g_metrics.SetF(METRIC_CPU_CORE, Pct(busy[i + 1], all[i + 1], g_prevBusy[i + 1], g_prevAll[i + 1]), i);
+    TopoAggregate(g_metrics);
+    memcpy(g_prevBusy, busy, n * sizeof(uint64_t));
+    memcpy(g_prevAll,  all,  n * sizeof(uint64_t));
+}
+
+// ---------------------------------------------------------------------------
+// CPU clocks
+// ---------------------------------------------------------------------------
+// Per core, opened once: cpufreq's scaling_cur_freq, the thermal_throttle
+// event counters and, where /dev/cpu/N/msr opens (root, msr module), the
+// APERF/MPERF MSRs. Those count actual and base-rate cycles while the core
+// is not halted, so base * dAPERF / dMPERF is the clock it really ran at
+// over the tick, throttling included; scaling_cur_freq is the kernel's last
+// estimate and the fallback. Cores follow /proc/stat: the online CPUs in order.
+static const uint32_t MSR_MPERF   = 0xE7;
+static const uint32_t MSR_APERF   = 0xE8;
+static const int      FREQ_FIELDS = 5;
+static const uint64_t FREQ_NONE   = ~0ull;      // raw value not reported
+
+struct FreqCore {
+    int      cur, coreThr, pkgThr, msr;         // fds, -1 = absent
+    uint64_t maxKHz;
+};
+
+static FreqCore g_freq[METRIC_MAX_CORES];
+static int      g_numFreq  = 0;
+static bool     g_freqInit = false;
+static uint64_t g_baseKHz  = 0;                 // 0 = no APERF/MPERF
+static bool     g_freqPrev = false;             // APERF/MPERF baseline taken
+static uint64_t g_prevAperf[METRIC_MAX_CORES], g_prevMperf[METRIC_MAX_CORES];
+
+// "0-7,9,12-15" -> ids, in order. Returns the count (at most cap).
+static int ParseCpuList(const char* s, int* ids, int cap) {
+    int n = 0;
+    for (const char* p = s; *p;) {
+        char* end;
+        long a = strtol(p, &end, 10), b = a;
+        if (end == p) break;
+        if (*end == '-') b = strtol(end + 1, &end, 10);
+        for (long i = a; i <= b && n < cap; i++) ids[n++] = (int)i;
+        p = *end == ',' ? end + 1 : end;
+    }
+    return n;
+}
+
+// The online CPUs, in the order of their /proc/stat lines
+static int OnlineCpus(int* ids, int cap) {
+    char buf[512];
+    return ReadLine("/sys/devices/system/cpu/online", buf, sizeof(buf)) ? ParseCpuList(buf, ids, cap) : 0;
+}
+
+static int OpenCpuAttr(int cpu, const char* attr) {
+    char path[96];
+    snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/%s", cpu, attr);
+    return open(path, O_RDONLY | O_CLOEXEC);
+}
+
+// Decimal value of an open sysfs attribute, FREQ_NONE if it can't be read
+static uint64_t ReadAttr(int fd) {
+    char buf[24];
+    ssize_t r = fd >= 0 ? pread(fd, buf, sizeof(buf) - 1, 0) : -1;
+    if (r <= 0) return FREQ_NONE;
+    buf[r] = 0;
+    return strtoull(buf, nullptr, 10);
+}
+
+static uint64_t ReadCpuAttr(int cpu, const char* attr) {
+    int fd = OpenCpuAttr(cpu, attr);
+    uint64_t v = ReadAttr(fd);
+    if (fd >= 0) close(fd);
+    return v;
+}
+
+static void AddFreqCore(int cpu) {
+    FreqCore& c = g_freq[g_numFreq++];
+    c.cur     = OpenCpuAttr(cpu, "cpufreq/scaling_cur_freq");
+    c.coreThr = OpenCpuAttr(cpu, "thermal_throttle/core_throttle_count");
+    c.pkgThr  = OpenCpuAttr(cpu, "thermal_throttle/package_throttle_count");
+    c.maxKHz  = ReadCpuAttr(cpu, "cpufreq/cpuinfo_max_freq");
+    char path[32];
+    snprintf(path, sizeof(path), "/dev/cpu/%d/msr", cpu);
+    c.msr = open(path, O_RDONLY | O_CLOEXEC);
+}
+
+static void FindFreq() {
+    g_freqInit = true;
+    int ids[METRIC_MAX_CORES];
+    int n = OnlineCpus(ids, METRIC_MAX_CORES);
+    for (int i = 0; i < n; i++) AddFreqCore(ids[i]);
+    int first = n ? ids[0] : -1;
+    // APERF/MPERF only when every core has them and the base clock is known
+    // (intel_pstate's base_frequency)
+    bool msr = g_numFreq > 0;
+    for (int i = 0; i < g_numFreq; i++) msr = msr && g_freq[i].msr >= 0;
+    uint64_t base = first >= 0 ? ReadCpuAttr(first, "cpufreq/base_frequency") : FREQ_NONE;
+    g_baseKHz = msr && base != FREQ_NONE ? base : 0;
+    if (g_baseKHz) return;
+    for (int i = 0; i < g_numFreq; i++) {
+        if (g_freq[i].msr >= 0) close(g_freq[i].msr);
+        g_freq[i].msr = -1;
+    }
+}
+
+static bool ReadFreqRaw() {
+    if (!g_freqInit) FindFreq();
+    if (!g_numFreq) return false;
+    g_raw.vals[0] = g_baseKHz;
+    for (int i = 0; i < g_numFreq; i++) {
+        const FreqCore& c = g_freq[i];
+        uint64_t* v = &g_raw.vals[1 + i * FREQ_FIELDS];
+        // Package events count against every core of the package
+        uint64_t ct = ReadAttr(c.coreThr), pt = ReadAttr(c.pkgThr);
+        v[0] = ReadAttr(c.cur);
+        v[1] = c.maxKHz;
+        v[2] = ct == FREQ_NONE ? FREQ_NONE : ct + (pt == FREQ_NONE ? 0 : pt);
+        v[3] = v[4] = 0;
+        if (g_baseKHz && (pread(c.msr, &v[3], 8, MSR_APERF) != 8 || pread(c.msr, &v[4], 8, MSR_MPERF) != 8))
+            v[3] = v[4] = 0;
+    }
+    g_raw.numVals = 1 + g_numFreq * FREQ_FIELDS;
+    return true;
+}
+
+static double KHzToMHz(uint64_t v) { return v == FREQ_NONE || !v ? -1 : v / 1000.0; }
+
+// The first sample with APERF/MPERF only sets their baseline
+static void ApplyFreq(const TraceSample& s) {
+    int n = std::min((s.numVals - 1) / FREQ_FIELDS, METRIC_MAX_CORES);
+    if (n <= 0) return;
+    uint64_t base = s.vals[0];
+    for (int i = 0; i < n; i++) {
+        const uint64_t* v = &s.vals[1 + i * FREQ_FIELDS];
+        double mhz = KHzToMHz(v[0]);
+        // A core halted for the whole tick has no MPERF delta
+        if (base && g_freqPrev && v[3] >= g_prevAperf[i] && v[4] > g_prevMperf[i])
+            mhz = base / 1000.0 * (double)(v[3] - g_prevAperf[i]) / (double)(v[4] - g_prevMperf[i]);
+        g_prevAperf[i] = v[3];
+        g_prevMperf[i] = v[4];
+        g_metrics.SetF(METRIC_CPU_FREQ, mhz, i);
+        g_metrics.SetF(METRIC_CPU_FREQ_MAX, KHzToMHz(v[1]), i);
+        g_metrics.SetF(METRIC_CPU_THROTTLE, v[2] == FREQ_NONE ? -1 : (double)v[2], i);
+    }
+    for (int i = n; i < g_numCores; i++) {
+        g_metrics.SetF(METRIC_CPU_FREQ, -1, i);
+        g_metrics.SetF(METRIC_CPU_FREQ_MAX, -1, i);
+        g_metrics.SetF(METRIC_CPU_THROTTLE, -1, i);
+    }
+    g_freqPrev = base != 0;
+}
+
+// ---------------------------------------------------------------------------
+// CPU topology
+// ---------------------------------------------------------------------------
+// Read once. Siblings come from topology/core_cpus_list (thread_siblings_list
+// before 5.7); the class from /sys/devices/cpu_atom/cpus on Intel hybrid
+// parts (E-cores 0, P-cores 1), else from the ranking of cpu_capacity
+// (arm big.LITTLE), else every core is class 0.
+// Raw record: vals[2i] = index of core i's first sibling, vals[2i + 1] = class
+static int IndexOf(const int* ids, int n, int id) {
+    for (int i = 0; i < n; i++)
+        if (ids[i] == id) return i;
+    return -1;
+}
+
+static bool ReadTopoRaw() {
+    int ids[METRIC_MAX_CORES], atom[METRIC_MAX_CORES], sib[1];
+    uint64_t cap[METRIC_MAX_CORES];
+    int n = OnlineCpus(ids, METRIC_MAX_CORES);
+    if (!n) return false;
+    char buf[512], path[96];
+    int numAtom = ReadLine("/sys/devices/cpu_atom/cpus", buf, sizeof(buf))
+                ? ParseCpuList(buf, atom, METRIC_MAX_CORES) : 0;
+    for (int i = 0; i < n; i++) {
+        int first = -1;
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/topology/core_cpus_list", ids[i]);
+        bool ok = ReadLine(path, buf, sizeof(buf));
+        if (!ok) {
+            snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/topology/thread_siblings_list", ids[i]);
+            ok = ReadLine(path, buf, sizeof(buf));
+        }
+        if (ok && ParseCpuList(buf, sib, 1)) first = IndexOf(ids, n, sib[0]);
+        g_raw.vals[i * 2] = (uint64_t)(first >= 0 ? first : i);
+        cap[i] = numAtom ? 0 : ReadCpuAttr(ids[i], "cpu_capacity");
+    }
+    for (int i = 0; i < n; i++) {
+        uint64_t cls = 0;
+        if (numAtom) cls = IndexOf(atom, numAtom, ids[i]) >= 0 ? 0 : 1;
+        else if (cap[i] != FREQ_NONE) {
+            // Distinct capacities below this one
+            for (int j = 0; j < n; j++) {
+                bool seen = false;
+                for (int k = 0; k < j && !seen; k++) seen = cap[k] == cap[j];
+                if (!seen && cap[j] != FREQ_NONE && cap[j] < cap[i]) cls++;
+            }
+        }
+        g_raw.vals[i * 2 + 1] = cls;
+    }
+    g_raw.numVals = n * 2;
+    return true;
+}
+
+static void ApplyTopo(const TraceSample& s) {
+    int n = std::min(s.numVals / 2, g_numCores);
+    for (int i = 0; i < n; i++) {
+        g_metrics.SetU(METRIC_CPU_PHYS, s.vals[i * 2], i);
+        g_metrics.SetU(METRIC_CPU_CLASS, s.vals[i * 2 + 1], i);
+    }
+}
+
+void InitCpu() {
+    g_cpuInit  = false;
+    g_freqPrev = false;
+    UpdateCpu();
+    if (ReadRaw(TRACE_CPUTOPO, ReadTopoRaw)) {
+        TraceWrite(g_raw);
+        ApplyTopo(g_raw);
+    }
+}
+
+void UpdateCpu() {
+    if (ReadRaw(TRACE_CPU, ReadCpuRaw)) {
+        TraceWrite(g_raw);
+        ApplyCpu(g_raw);
+    }
+    if (ReadRaw(TRACE_CPUFREQ, ReadFreqRaw)) {
+        TraceWrite(g_raw);
+        ApplyFreq(g_raw);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Memory
+// ---------------------------------------------------------------------------
+static void ApplyMem(const TraceSample& s) {
+    if (s.numVals < 4) return;
+    uint64_t total = s.vals[0], avail = s.vals[1], swapT = s.vals[2], swapF = s.vals[3];
+    g_metrics.SetU(METRIC_RAM_TOTAL,  total / 1024);
+    g_metrics.SetU(METRIC_RAM_USED,   (total > avail ? total - avail : 0) / 1024);
+    g_metrics.SetU(METRIC_SWAP_TOTAL, swapT / 1024);
+    g_metrics.SetU(METRIC_SWAP_USED,  (swapT > swapF ? swapT - swapF : 0) / 1024);
+}
+
+static bool ReadMemRaw() {
+    static char buf[4096];
+    if (ReadFile("/proc/meminfo", buf, sizeof(buf)) <= 0) return false;
+    g_raw.vals[0] = FieldKB(buf, "MemTotal");
+    g_raw.vals[1] = FieldKB(buf, "MemAvailable");
+    g_raw.vals[2] = FieldKB(buf, "SwapTotal");
+    g_raw.vals[3] = FieldKB(buf, "SwapFree");
+    g_raw.numVals = 4;
+    return true;
+}
+
+void UpdateMem() {
+    if (!ReadRaw(TRACE_MEM, ReadMemRaw)) return;
+    TraceWrite(g_raw);
+    ApplyMem(g_raw);
+}
+
+// ---------------------------------------------------------------------------
+// Disk
+// ---------------------------------------------------------------------------
+// Copies one space-separated /proc/mounts field, decoding \040-style escapes
+static const char* MountField(const char* p, char* out, int cap) {
+    int n = 0;
+    while (*p && *p != ' ' && *p != '\n') {
+        char c = *p++;
+        if (c == '\\' && p[0] >= '0' && p[0] <= '7' && p[1] && p[2]) {
+            c = (char)((p[0] - '0') * 64 + (p[1] - '0') * 8 + (p[2] - '0'));
+            p += 3;
+        }
+        if (n < cap - 1) out[n++] = c;
+    }
+    out[n] = 0;
+    return *p == ' ' ? p + 1 : p;
+}
+
+static void ApplyDisk(const TraceSample& s) {
+    static bool warned = false;
+    int have = std::min(s.numVals / 2, s.numStrs);
+    WarnCap(warned, have, METRIC_MAX_VOLS, "volumes");
+    int nv = std::min(have, METRIC_MAX_VOLS);
+    for (int i = 0; i < nv; i++) {
+        const char* mp = s.strs[i];
+        double totalGB = (double)s.vals[i * 2]     / (1024.0*1024.0*1024.0);
+        double freeGB  = (double)s.vals[i * 2 + 1] / (1024.0*1024.0*1024.0);
+        const char* name = strrchr(mp, '/');
+        name = (name && name[1]) ? name + 1 : mp;
+        snprintf(g_metrics.volLabel[i], sizeof(g_metrics.volLabel[i]), "%c:", name[0]);
+        snprintf(g_metrics.volPath[i],  sizeof(g_metrics.volPath[i]),  "%s", mp);
+        g_metrics.SetF(METRIC_DISK_TOTAL, totalGB, i);
+        g_metrics.SetF(METRIC_DISK_USED,  totalGB - freeGB, i);
+    }
+    g_metrics.SetU(METRIC_DISK_VOLS, nv);
+}
+
+static bool ReadDiskRaw() {
+    static char buf[65536];
+    static dev_t seen[TRACE_MAX_STRS];
+    if (ReadFile("/proc/self/mounts", buf, sizeof(buf)) <= 0) return false;
+
+    int nv = 0;
+    for (const char* p = buf; p && *p && nv < TRACE_MAX_STRS; p = NextLine(p)) {
+        char dev[128], mp[64], fs[32];
+        const char* q = MountField(p, dev, sizeof(dev));
+        q = MountField(q, mp, sizeof(mp));
+        MountField(q, fs, sizeof(fs));
+        if (strncmp(dev, "/dev/", 5) != 0) continue;
+        if (strcmp(fs, "squashfs") == 0 || strncmp(mp, "/snap/", 6) == 0) continue;
+
+        // Bind mounts and btrfs subvolumes show the same device more than once
+        struct stat st;
+        if (stat(mp, &st) != 0) continue;
+        bool dup = false;
+        for (int i = 0; i < nv; i++) if (seen[i] == st.st_dev) dup = true;
+        if (dup) continue;
+
+        struct statvfs vs;
+        if (statvfs(mp, &vs) != 0) continue;
+        uint64_t total = (uint64_t)vs.f_blocks * vs.f_frsize;
+        if (total / (1024.0*1024.0*1024.0) < 0.1) continue;
+
+        snprintf(g_raw.strs[nv], TRACE_STR_LEN, "%s", mp);
+        g_raw.vals[nv * 2]     = total;
+        g_raw.vals[nv * 2 + 1] = (uint64_t)vs.f_bavail * vs.f_frsize;
+        seen[nv++] = st.st_dev;
+    }
+    g_raw.numVals = nv * 2;
+    g_raw.numStrs = nv;
+    return true;
+}
+
+void UpdateDisk() {
+    if (!ReadRaw(TRACE_DISK, ReadDiskRaw)) return;
+    TraceWrite(g_raw);
+    ApplyDisk(g_raw);
+}
+
+// ---------------------------------------------------------------------------
+// Battery
+// ---------------------------------------------------------------------------
+// vals: capacity * 100, PsuState, power uW, energy now uWh (-1 = not
+// reported); no values = no battery. Traces from before the power module
+// carry the capacity only.
+static void ApplyBattery(const TraceSample& s) {
+    PsuReading r = { s.tickMs, PSU_NONE, -1, -1, -1, -1 };
+    if (s.numVals > 0) {
+        r.pct   = (double)(int64_t)s.vals[0] / 100.0;
+        r.state = s.numVals > 1 ? (int)s.vals[1] : PSU_DISCHARGING;
+    }
+    if (s.numVals > 3) {
+        int64_t uw = (int64_t)s.vals[2], uwh = (int64_t)s.vals[3];
+        r.watts    = uw  >= 0 ? uw  / 1e6 : -1;
+        r.energyWh = uwh >= 0 ? uwh / 1e6 : -1;
+    }
+    PsuPush(r);
+    PsuApply(g_metrics);
+}
+
+// The supply directory is looked up once; a power_supply uevent (a battery
+// added or removed) makes the next read look again
+static char g_batDir[96];
+static bool g_batScanned = false;
+
+static void FindBattery() {
+    g_batScanned = true;
+    g_batDir[0] = 0;
+    DIR* d = opendir("/sys/class/power_supply");
+    if (!d) return;
+    char path[160], buf[32];
+    while (dirent* e = readdir(d)) {
+        if (e->d_name[0] == '.') continue;
+        snprintf(path, sizeof(path), "/sys/class/power_supply/%.64s/type", e->d_name);
+        if (ReadFile(path, buf, sizeof(buf)) <= 0 || strncmp(buf, "Battery", 7) != 0) continue;
+        // Mice and headsets report themselves as scope Device
+        snprintf(path, sizeof(path), "/sys/class/power_supply/%.64s/scope", e->d_name);
+        if (ReadFile(path, buf, sizeof(buf)) > 0 && strncmp(buf, "Device", 6) == 0) continue;
+        snprintf(g_batDir, sizeof(g_batDir), "/sys/class/power_supply/%.64s", e->d_name);
+        break;
+    }
+    closedir(d);
+}
+
+// Integer attribute of the battery; false if absent
+static bool BatAttr(const char* name, int64_t& v) {
+    char path[160], buf[32];
+    snprintf(path, sizeof(path), "%s/%s", g_batDir, name);
+    if (ReadFile(path, buf, sizeof(buf)) <= 0) return false;
+    v = strtoll(buf, nullptr, 10);
+    return true;
+}
+
+static bool ReadBatteryRaw() {
+    if (!g_batScanned) FindBattery();
+    if (!g_batDir[0]) return true;
+    int64_t cap;
+    if (!BatAttr("capacity", cap)) return true;
+
+    char path[160], status[32] = "";
+    snprintf(path, sizeof(path), "%s/status", g_batDir);
+    ReadFile(path, status, sizeof(status));
+    int state = strncmp(status, "Charging", 8) == 0    ? PSU_CHARGING
+              : strncmp(status, "Discharging", 11) == 0 ? PSU_DISCHARGING
+              :                                           PSU_FULL;   // Full, Not charging, Unknown
+
+    // Drivers report either power/energy or current/charge (with voltage);
+    // some sign the current/power by direction
+    int64_t uv = 0, uw = -1, uwh = -1, ua, uah;
+    BatAttr("voltage_now", uv);
+    if (BatAttr("power_now", uw)) uw = uw < 0 ? -uw : uw;
+    else if (BatAttr("current_now", ua) && uv > 0) uw = (int64_t)((double)(ua < 0 ? -ua : ua) * uv / 1e6);
+    if (!BatAttr("energy_now", uwh) && BatAttr("charge_now", uah) && uv > 0)
+        uwh = (int64_t)((double)uah * uv / 1e6);
+    g_raw.vals[0] = (uint64_t)(cap * 100);
+    g_raw.vals[1] = (uint64_t)state;
+    g_raw.vals[2] = (uint64_t)uw;
+    g_raw.vals[3] = (uint64_t)uwh;
+    g_raw.numVals = 4;
+    return true;
+}
+
+int OpenPowerEvents() {
+    int fd = socket(AF_NETLINK, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, NETLINK_KOBJECT_UEVENT);
+    if (fd < 0) return -1;
+    sockaddr_nl sa = {};
+    sa.nl_family = AF_NETLINK;
+    sa.nl_groups = 1;                   // kernel uevents
+    if (bind(fd, (sockaddr*)&sa, sizeof(sa)) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+bool PowerEventsPending(int fd) {
+    static char buf[8192];
+    bool power = false;
+    ssize_t n;
+    while ((n = recv(fd, buf, sizeof(buf) - 1, 0)) > 0) {
+        // "ACTION@DEVPATH\0KEY=VALUE\0..."
+        buf[n] = 0;
+        for (const char* p = buf; p < buf + n; p += strlen(p) + 1)
+            if (strcmp(p, "SUBSYSTEM=power_supply") == 0) power = true;
+    }
+    if (power) g_batScanned = false;
+    return power;
+}
+
+void UpdateBattery() {
+    ReadRaw(TRACE_BATTERY, ReadBatteryRaw);
+    TraceWrite(g_raw);
+    ApplyBattery(g_raw);
+}
+
+// ---------------------------------------------------------------------------
+// Network
+// ---------------------------------------------------------------------------
+static bool     g_netInit = false;
+static uint64_t g_netPrevIn = 0, g_netPrevOut = 0, g_netTick = 0;
+
+// Per-interface rx/tx octets from /proc/net/dev, loopback included. An
+// unreadable file counts as no interfaces.
+static bool ReadNetRaw() {
+    static char buf[65536];
+    if (ReadFile("/proc/net/dev", buf, sizeof(buf)) <= 0) return true;
+    int n = 0;
+    const char* p = NextLine(buf);
+    for (p = p ? NextLine(p) : nullptr; p && *p && n < TRACE_MAX_STRS; p = NextLine(p)) {
+        while (*p == ' ') p++;
+        const char* colon = strchr(p, ':');
+        if (!colon) continue;
+        // rx: bytes packets errs drop fifo frame compressed multicast; tx: bytes ...
+        char* q = (char*)colon + 1;
+        uint64_t f[9];
+        for (int i = 0; i < 9; i++) f[i] = strtoull(q, &q, 10);
+        snprintf(g_raw.strs[n], TRACE_STR_LEN, "%.*s", (int)(colon - p), p);
+        g_raw.vals[n * 2]     = f[0];
+        g_raw.vals[n * 2 + 1] = f[8];
+        n++;
+    }
+    g_raw.numVals = n * 2;
+    g_raw.numStrs = n;
+    return true;
+}
+
+// The first sample after start only sets the baseline
+static void ApplyNet(const TraceSample& s) {
+    uint64_t ci = 0, co = 0;
+    int n = std::min(s.numVals / 2, s.numStrs);
+    for (int i = 0; i < n; i++) {
+        if (strcmp(s.strs[i], "lo") == 0) continue;
+        ci += s.vals[i * 2];
+        co += s.vals[i * 2 + 1];
+    }
+    uint64_t now = s.tickMs;
+    if (!g_netInit) {
+        g_netInit = true;
+        g_netPrevIn  = ci;
+        g_netPrevOut = co;
+        g_netTick    = now;
+        return;
+    }
+    double dt = (now - g_netTick) / 1000.0;
+    if (dt > 0.05) {
+        g_metrics.SetF(METRIC_NET_DOWN, ci >= g_netPrevIn  ? (ci - g_netPrevIn)  / dt : 0);
+        g_metrics.SetF(METRIC_NET_UP,   co >= g_netPrevOut ? (co - g_netPrevOut) / dt : 0);
+    }
+    g_netPrevIn  = ci;
+    g_netPrevOut = co;
+    g_netTick    = now;
+}
+
+void InitNet() {
+    g_netInit = false;
+    UpdateNet();
+}
+
+void UpdateNet() {
+    ReadRaw(TRACE_NET, ReadNetRaw);
+    TraceWrite(g_raw);
+    ApplyNet(g_raw);
+}
+
+// ---------------------------------------------------------------------------
+// Thermal
+// ---------------------------------------------------------------------------
+// Sensors are discovered once: every hwmon temp*_input / fan*_input, then
+// every thermal zone that has no hwmon twin. Each stays open with its
+// label, so a tick is one pread per sensor. If one stops reading (driver
+// unloaded, device gone) the set is looked up again, at most once per
+// THERM_RESCAN_MS.
+static const int      THERM_MAX       = 64;
+static const uint64_t THERM_RESCAN_MS = 60000;
+
+// Raw record: vals[2i] = THERM_* flags, vals[2i + 1] = millidegrees C or rpm, strs[i] = label
+enum { THERM_FAN = 1, THERM_IS_CPU = 2, THERM_LOST = 4 };
+
+struct ThermSensor {
+    int  fd;
+    int  flags;
+    char label[32];
+};
+
+static ThermSensor g_therm[THERM_MAX];
+static int         g_numTherm    = 0;
+static bool        g_thermInit   = false;
+static bool        g_thermLost   = false;
+static uint64_t    g_thermScanMs = 0;
+
+// Package / die sensors of the CPU drivers, or a thermal zone named for it
+static bool IsCpuSensor(const char* chip) {
+    static const char* kCpu[] = { "coretemp", "k10temp", "zenpower", "x86_pkg_temp", "cpu_thermal",
+                                  "cpu-thermal" };
+    for (const char* c : kCpu)
+        if (strcmp(chip, c) == 0) return true;
+    return false;
+}
+
+static void AddSensor(const char* path, int flags, const char* chip, const char* label) {
+    if (g_numTherm == THERM_MAX) return;
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return;
+    ThermSensor& t = g_therm[g_numTherm++];
+    t.fd    = fd;
+    t.flags = flags | (IsCpuSensor(chip) ? THERM_IS_CPU : 0);
+    snprintf(t.label, sizeof(t.label), "%s %s", chip, label);
+}
+
+static void ScanHwmon(char chips[][32], int& numChips) {
+    DIR* d = opendir("/sys/class/hwmon");
+    if (!d) return;
+    char path[160], chip[32], label[32];
+    while (dirent* e = readdir(d)) {
+        if (e->d_name[0] == '.') continue;
+        snprintf(path, sizeof(path), "/sys/class/hwmon/%.32s/name", e->d_name);
+        if (!ReadLine(path, chip, sizeof(chip))) continue;
+        if (numChips < THERM_MAX) snprintf(chips[numChips++], 32, "%s", chip);
+        snprintf(path, sizeof(path), "/sys/class/hwmon/%.32s", e->d_name);
+        DIR* h = opendir(path);
+        if (!h) continue;
+        while (dirent* a = readdir(h)) {
+            int idx;
+            char kind[8], tail[16];
+            // temp3_input, fan1_input
+            if (sscanf(a->d_name, "%7[a-z]%d_%15s", kind, &idx, tail) != 3 || strcmp(tail, "input") != 0) continue;
+            bool fan = strcmp(kind, "fan") == 0;
+            if (!fan && strcmp(kind, "temp") != 0) continue;
+            snprintf(path, sizeof(path), "/sys/class/hwmon/%.32s/%s%d_label", e->d_name, kind, idx);
+            if (!ReadLine(path, label, sizeof(label))) snprintf(label, sizeof(label), "%s%d", kind, idx);
+            snprintf(path, sizeof(path), "/sys/class/hwmon/%.32s/%.32s", e->d_name, a->d_name);
+            AddSensor(path, fan ? THERM_FAN : 0, chip, label);
+        }
+        closedir(h);
+    }
+    closedir(d);
+}
+
+// Zones registered with hwmon already showed up there, under the zone type
+// with '-' as '_'
+static void ScanZones(char chips[][32], int numChips) {
+    DIR* d = opendir("/sys/class/thermal");
+    if (!d) return;
+    char path[160], type[32], alias[32];
+    while (dirent* e = readdir(d)) {
+        if (strncmp(e->d_name, "thermal_zone", 12) != 0) continue;
+        snprintf(path, sizeof(path), "/sys/class/thermal/%.32s/type", e->d_name);
+        if (!ReadLine(path, type, sizeof(type))) continue;
+        snprintf(alias, sizeof(alias), "%s", type);
+        for (char* c = alias; *c; c++)
+            if (*c == '-') *c = '_';
+        bool twin = false;
+        for (int i = 0; i < numChips && !twin; i++) twin = strcmp(chips[i], alias) == 0;
+        if (twin) continue;
+        snprintf(path, sizeof(path), "/sys/class/thermal/%.32s/temp", e->d_name);
+        AddSensor(path, 0, type, e->d_name + 8);    // "x86_pkg_temp zone0"
+    }
+    closedir(d);
+}
+
+static void FindSensors(uint64_t now) {
+    for (int i = 0; i < g_numTherm; i++) close(g_therm[i].fd);
+    g_numTherm    = 0;
+    g_thermInit   = true;
+    g_thermLost   = false;
+    g_thermScanMs = now;
+    static char chips[THERM_MAX][32];
+    int numChips = 0;
+    ScanHwmon(chips, numChips);
+    ScanZones(chips, numChips);
+    // CPU sensors first, then the rest in discovery order
+    std::stable_partition(g_therm, g_therm + g_numTherm,
+                          [](const ThermSensor& t) { return (t.flags & THERM_IS_CPU) != 0; });
+}
+
+static bool ReadThermalRaw() {
+    uint64_t now = TickMs();
+    if (!g_thermInit || (g_thermLost && now - g_thermScanMs >= THERM_RESCAN_MS)) FindSensors(now);
+    int n = 0;
+    for (; n < g_numTherm && n < TRACE_MAX_STRS; n++) {
+        ThermSensor& t = g_therm[n];
+        char buf[24];
+        ssize_t r = pread(t.fd, buf, sizeof(buf) - 1, 0);
+        int flags = t.flags;
+        int64_t v = 0;
+        if (r > 0) {
+            buf[r] = 0;
+            v = strtoll(buf, nullptr, 10);
+        } else {
+            flags |= THERM_LOST;
+            g_thermLost = true;
+        }
+        g_raw.vals[n * 2]     = (uint64_t)flags;
+        g_raw.vals[n * 2 + 1] = (uint64_t)v;
+        snprintf(g_raw.strs[n], TRACE_STR_LEN, "%s", t.label);
+    }
+    g_raw.numVals = n * 2;
+    g_raw.numStrs = n;
+    return true;
+}
+
+static void ApplyThermal(const TraceSample& s) {
+    static bool warnedT = false, warnedF = false;
+    int nt = 0, nf = 0, haveT = 0, haveF = 0;
+    double cpu = -1;
+    for (int i = 0; i < s.numStrs && i * 2 + 1 < s.numVals; i++) {
+        int flags = (int)s.vals[i * 2];
+        if (flags & THERM_LOST) continue;
+        double v = (double)(int64_t)s.vals[i * 2 + 1];
+        if (flags & THERM_FAN) {
+            haveF++;
+            if (nf == METRIC_MAX_FANS) continue;
+            g_metrics.SetF(METRIC_FAN, v, nf);
+            snprintf(g_metrics.fanLabel[nf], sizeof(g_metrics.fanLabel[nf]), "%s", s.strs[i]);
+            nf++;
+            continue;
+        }
+        v /= 1000.0;
+        if ((flags & THERM_IS_CPU) && v > cpu) cpu = v;
+        haveT++;
+        if (nt == METRIC_MAX_TEMPS) continue;
+        g_metrics.SetF(METRIC_TEMP, v, nt);
+        snprintf(g_metrics.tempLabel[nt], sizeof(g_metrics.tempLabel[nt]), "%s", s.strs[i]);
+        nt++;
+    }
+    WarnCap(warnedT, haveT, METRIC_MAX_TEMPS, "temperature sensors");
+    WarnCap(warnedF, haveF, METRIC_MAX_FANS, "fans");
+    g_metrics.SetF(METRIC_THERM_CPU, cpu);
+    g_metrics.SetU(METRIC_TEMP_COUNT, (uint64_t)nt);
+    g_metrics.SetU(METRIC_FAN_COUNT, (uint64_t)nf);
+}
+
+void UpdateThermal() {
+    ReadRaw(TRACE_THERMAL, ReadThermalRaw);
+    TraceWrite(g_raw);
+    ApplyThermal(g_raw);
+}
+
+// ---------------------------------------------------------------------------
+// Replay
+// ---------------------------------------------------------------------------
+void ReplaySample(const TraceSample& s) {
+    switch (s.kind) {
+    case TRACE_CPU:     ApplyCpu(s);     break;
+    case TRACE_MEM:     ApplyMem(s);     break;
+    case TRACE_DISK:    ApplyDisk(s);    break;
+    case TRACE_NET:     ApplyNet(s);     break;
+    case TRACE_BATTERY: ApplyBattery(s); break;
+    case TRACE_THERMAL: ApplyThermal(s); break;
+    case TRACE_CPUFREQ: ApplyFreq(s);    break;
+    case TRACE_CPUTOPO: ApplyTopo(s);    break;
+    default: break;
+    }
+}
@@ -0,0 +1,53 @@
+// SysMonitor Linux - System metrics from /proc and /sys (headless agent)
+// All readers use fixed static buffers; nothing allocates after Init*.
+// Each Update* reads its raw inputs, records them when a trace is being
+// written (libs/trace), then computes the metrics from the raw values.
+#ifndef SYSMON_LINUX_METRICS_H
+#define SYSMON_LINUX_METRICS_H
+
+#include <cstdint>
+
+struct TraceSample;
+
+// Monotonic clock, ms
+uint64_t TickMs();
+
+// CPU (/proc/stat), per-core clocks and throttle events (cpufreq,
+// thermal_throttle, APERF/MPERF through /dev/cpu/N/msr when readable).
+// InitCpu also reads the topology (SMT siblings, P/E class) once.
+void InitCpu();
+void UpdateCpu();
+
+// Memory (/proc/meminfo)
+void UpdateMem();
+
+// Block-device mounts (/proc/self/mounts + statvfs)
+void UpdateDisk();
+
+// Battery (/sys/class/power_supply), smoothed by libs/battery
+void UpdateBattery();
+// Kernel uevent socket for power-supply changes (plug, unplug, battery
+// added), non-blocking; -1 if unavailable. PowerEventsPending drains it and
+// returns true if any event was about a power supply.
+int  OpenPowerEvents();
+bool PowerEventsPending(int fd);
+
+// Temperatures and fans (/sys/class/hwmon, /sys/class/thermal); sensors
+// are looked up on the first call and kept open
+void UpdateThermal();
+
+// Network throughput (/proc/net/dev)
+void InitNet();
+void UpdateNet();
+
+// Feeds one recorded backend read (libs/trace) through the same math as the
+// live Update*; TRACE_TICK and unknown kinds are ignored.
+void ReplaySample(const TraceSample& s);
+
+// Fake backend hook (libs/sim): when set, every Update* asks fn for its raw
+// inputs instead of reading /proc and /sys. s.kind and s.tickMs are preset;
+// fn fills the rest and returns false for a failed read. nullptr = live.
+typedef bool (*RawSource)(TraceSample& s);
+void SetRawSource(RawSource fn);
+
+#endif // SYSMON_LINUX_METRICS_H
@@ -14,6 +14,7 @@
 #include <cstring>
 
 #include "libs/mac/mac_globals.h"
+#include "libs/config/config.h"
 
 // ---------------------------------------------------------------------------
 // Minimal JSON helpers (for known API shapes, narrow-string variant)
@@ -144,7 +145,7 @@ static void FetchExternal() {
     }
 
     // --- Phase 2: Weather (uses cached lat/lon if IP fetch failed) ---
-    if (lat == 0 && lon == 0) return;
+    if (!SectionOn(SEC_ID_WX) || (lat == 0 && lon == 0)) return;
 
     char wurl[256];
     std::snprintf(wurl, sizeof(wurl),
@@ -195,7 +196,7 @@ void BgThreadFunc() {
         {
             std::lock_guard<std::mutex> lk(g_extMtx);
             bool ipOk = !g_ext.ip.empty() && g_ext.ip != "Loading...";
-            bool wxOk = g_ext.wcode >= 0;
+            bool wxOk = g_ext.wcode >= 0 || !SectionOn(SEC_ID_WX);
             if (ipOk && wxOk) { waitSec = BG_FETCH_SEC; failures = 0; }
             else { failures++; waitSec = std::min(15 * failures, 120); }
         }
@@ -14,13 +14,18 @@ void UpdateMem();
 // Disk volumes
 void UpdateDisk();
 
-// Battery
+// Battery (libs/battery); StartPowerWatch calls onChange on the main
+// thread on every power-source change, false if unavailable
 void UpdateBattery();
+bool StartPowerWatch(void (*onChange)());
 
 // Network throughput + LAN IP
 void InitNet();
 void UpdateNet();
 void UpdateLanIP();
+// Calls onChange on the main queue whenever an interface address changes
+// (routing socket); false if the socket can't be opened
+bool StartAddrWatch(void (*onChange)());
 
 #endif // SYSMON_MAC_METRICS_H
 
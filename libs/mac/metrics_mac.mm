@@ -10,11 +10,21 @@
 #include <sys/mount.h>
 #include <net/if.h>
 #include <net/if_dl.h>
+#include <net/route.h>
+#include <sys/socket.h>
+#include <fcntl.h>
+#include <unistd.h>
 #include <ifaddrs.h>
 #include <arpa/inet.h>
 
+#include <algorithm>
+
 #include "libs/mac/mac_globals.h"
 #include "libs/mac/metrics_mac.h"
+#include "libs/rollup/rollup.h"
+#include "libs/metrics/metrics.h"
+#include "libs/battery/battery.h"
+#include "libs/topology/topology.h"
 
 // ---------------------------------------------------------------------------
 // Time helper
@@ -38,8 +48,25 @@ void InitCpu() {
     mach_msg_type_number_t cpuMsgCount = 0;
     if (host_processor_info(mach_host_self(), PROCESSOR_CPU_LOAD_INFO,
             &numCPUs, (processor_info_array_t *)&cpuLoad, &cpuMsgCount) == KERN_SUCCESS) {
-        g_numCores = (int)numCPUs;
-        g_coreUse.resize(g_numCores, 0.0);
+        g_numCores = std::min((int)numCPUs, METRIC_MAX_CORES);
+        g_metrics.SetU(METRIC_CPU_CORES, g_numCores);
+        // No public per-core clock or throttle counters
+        for (int i = 0; i < g_numCores; i++) {
+            g_metrics.SetF(METRIC_CPU_FREQ, -1, i);
+            g_metrics.SetF(METRIC_CPU_FREQ_MAX, -1, i);
+            g_metrics.SetF(METRIC_CPU_THROTTLE, -1, i);
+        }
+        // Apple silicon: hw.perflevel1 is the efficiency cluster, which the
+        // kernel numbers first. No SMT there; Intel Macs report one level.
+        int levels = 0, eCores = 0;
+        size_t len = sizeof(levels);
+        if (sysctlbyname("hw.nperflevels", &levels, &len, nullptr, 0) != 0 || levels < 2 ||
+            (len = sizeof(eCores), sysctlbyname("hw.perflevel1.logicalcpu", &eCores, &len, nullptr, 0)) != 0)
+            eCores = 0;
+        for (int i = 0; i < g_numCores; i++) {
+            g_metrics.SetU(METRIC_CPU_PHYS, (uint64_t)i, i);
+            g_metrics.SetU(METRIC_CPU_CLASS, (uint64_t)(eCores && i >= eCores), i);
+        }
         g_prevLoad = cpuLoad;
         g_prevCount = cpuMsgCount;
     }
@@ -65,11 +92,15 @@ void UpdateCpu() {
             unsigned int dTotal = dUser + dSys + dNice + dIdle;
             double u = dTotal > 0 ? (double)(dUser + dSys + dNice) / dTotal * 100.0 : 0;
             if (u < 0) u = 0; if (u > 100) u = 100;
-            g_coreUse[i] = u;
+            g_metrics.SetF(METRIC_CPU_CORE, u, i);
+            RollupPushCore(i, (float)u);
             sum += u;
         }
     }
-    g_totalCpu = g_numCores > 0 ? sum / g_numCores : 0;
+    double total = g_numCores > 0 ? sum / g_numCores : 0;
+    g_metrics.SetF(METRIC_CPU_TOTAL, total);
+    TopoAggregate(g_metrics);
+    RollupPush(HIST_CPU, (float)total);
 
     if (g_prevLoad)
         vm_deallocate(mach_task_self(), (vm_address_t)g_prevLoad, g_prevCount * sizeof(int));
@@ -84,7 +115,9 @@ void UpdateMem() {
     int64_t totalMem = 0;
     size_t len = sizeof(totalMem);
     sysctlbyname("hw.memsize", &totalMem, &len, nullptr, 0);
-    g_ramTotalMB = totalMem / (1024 * 1024);
+    uint64_t ramTotal = totalMem / (1024 * 1024);
+    uint64_t ramUsed  = g_metrics.U(METRIC_RAM_USED);
+    g_metrics.SetU(METRIC_RAM_TOTAL, ramTotal);
 
     vm_statistics64_data_t vm;
     mach_msg_type_number_t count = HOST_VM_INFO64_COUNT;
@@ -92,14 +125,16 @@ void UpdateMem() {
         vm_size_t pageSize = 0;
         host_page_size(mach_host_self(), &pageSize);
         uint64_t usedPages = vm.active_count + vm.wire_count + vm.compressor_page_count;
-        g_ramUsedMB = (usedPages * pageSize) / (1024 * 1024);
+        ramUsed = (usedPages * pageSize) / (1024 * 1024);
+        g_metrics.SetU(METRIC_RAM_USED, ramUsed);
     }
+    RollupPush(HIST_RAM, ramTotal > 0 ? (float)((double)ramUsed * 100.0 / ramTotal) : 0.f);
 
     struct xsw_usage swap;
     len = sizeof(swap);
     if (sysctlbyname("vm.swapusage", &swap, &len, nullptr, 0) == 0) {
-        g_swapTotalMB = swap.xsu_total / (1024 * 1024);
-        g_swapUsedMB  = swap.xsu_used / (1024 * 1024);
+        g_metrics.SetU(METRIC_SWAP_TOTAL, swap.xsu_total / (1024 * 1024));
+        g_metrics.SetU(METRIC_SWAP_USED,  swap.xsu_used / (1024 * 1024));
     }
 }
 
@@ -109,8 +144,8 @@ void UpdateMem() {
 void UpdateDisk() {
     struct statfs *mounts = nullptr;
     int n = getmntinfo(&mounts, MNT_NOWAIT);
-    std::vector<VolInfo> vols;
-    for (int i = 0; i < n; i++) {
+    int nv = 0;
+    for (int i = 0; i < n && nv < METRIC_MAX_VOLS; i++) {
         std::string fstype = mounts[i].f_fstypename;
         std::string mp = mounts[i].f_mntonname;
         if (fstype != "apfs" && fstype != "hfs") continue;
@@ -121,47 +156,80 @@ void UpdateDisk() {
         double freeGB  = (double)mounts[i].f_bavail * mounts[i].f_bsize / (1024.0*1024.0*1024.0);
         if (totalGB < 0.1) continue;
 
-        VolInfo v;
+        char letter;
         if (mp == "/" || mp == "/System/Volumes/Data")
-            v.letter = '/';
+            letter = '/';
         else {
             size_t last = mp.rfind('/');
-            v.mount = (last != std::string::npos) ? mp.substr(last + 1) : mp;
-            v.letter = v.mount.empty() ? '?' : v.mount[0];
+            std::string name = (last != std::string::npos) ? mp.substr(last + 1) : mp;
+            letter = name.empty() ? '?' : name[0];
         }
-        v.totalGB = totalGB;
-        v.usedGB  = totalGB - freeGB;
-        v.mount   = mp;
-        vols.push_back(v);
+        snprintf(g_metrics.volLabel[nv], sizeof(g_metrics.volLabel[nv]), "%c:", letter);
+        snprintf(g_metrics.volPath[nv],  sizeof(g_metrics.volPath[nv]),  "%s", mp.c_str());
+        g_metrics.SetF(METRIC_DISK_TOTAL, totalGB, nv);
+        g_metrics.SetF(METRIC_DISK_USED,  totalGB - freeGB, nv);
+        nv++;
     }
-    g_vols = vols;
+    g_metrics.SetU(METRIC_DISK_VOLS, nv);
 }
 
 // ---------------------------------------------------------------------------
 // Battery
 // ---------------------------------------------------------------------------
+// One reading per call into libs/battery; IOKit reports the current (mA,
+// signed by direction) and voltage (mV) but no remaining energy, so time to
+// empty comes from the charge slope or the OS estimate
+static int DictInt(CFDictionaryRef d, CFStringRef key, int def) {
+    CFNumberRef n = (CFNumberRef)CFDictionaryGetValue(d, key);
+    int v = def;
+    if (n) CFNumberGetValue(n, kCFNumberIntType, &v);
+    return v;
+}
+
+static bool DictTrue(CFDictionaryRef d, CFStringRef key) {
+    CFBooleanRef b = (CFBooleanRef)CFDictionaryGetValue(d, key);
+    return b && CFBooleanGetValue(b);
+}
+
 void UpdateBattery() {
-    g_batteryPct = -1;
+    PsuReading r = { TickMs(), PSU_NONE, -1, -1, -1, -1 };
     CFTypeRef blob = IOPSCopyPowerSourcesInfo();
-    if (!blob) return;
-    CFArrayRef list = IOPSCopyPowerSourcesList(blob);
-    if (!list) { CFRelease(blob); return; }
-    CFIndex count = CFArrayGetCount(list);
+    CFArrayRef list = blob ? IOPSCopyPowerSourcesList(blob) : nullptr;
+    CFIndex count = list ? CFArrayGetCount(list) : 0;
     for (CFIndex i = 0; i < count; i++) {
-        CFTypeRef ps = CFArrayGetValueAtIndex(list, i);
-        CFDictionaryRef desc = IOPSGetPowerSourceDescription(blob, ps);
+        CFDictionaryRef desc = IOPSGetPowerSourceDescription(blob, CFArrayGetValueAtIndex(list, i));
         if (!desc) continue;
-        CFNumberRef cur = (CFNumberRef)CFDictionaryGetValue(desc, CFSTR(kIOPSCurrentCapacityKey));
-        CFNumberRef max = (CFNumberRef)CFDictionaryGetValue(desc, CFSTR(kIOPSMaxCapacityKey));
-        if (!cur || !max) continue;
-        int c = 0, m = 0;
-        CFNumberGetValue(cur, kCFNumberIntType, &c);
-        CFNumberGetValue(max, kCFNumberIntType, &m);
-        if (m > 0) g_batteryPct = (int)lrint((double)c * 100.0 / (double)m);
+        int c = DictInt(desc, CFSTR(kIOPSCurrentCapacityKey), 0);
+        int m = DictInt(desc, CFSTR(kIOPSMaxCapacityKey), 0);
+        if (m <= 0) continue;
+        CFStringRef src = (CFStringRef)CFDictionaryGetValue(desc, CFSTR(kIOPSPowerSourceStateKey));
+        bool onAC = src && CFStringCompare(src, CFSTR(kIOPSACPowerValue), 0) == kCFCompareEqualTo;
+        r.state = DictTrue(desc, CFSTR(kIOPSIsChargingKey)) ? PSU_CHARGING
+                : onAC                                      ? PSU_FULL
+                :                                             PSU_DISCHARGING;
+        r.pct = lrint((double)c * 100.0 / (double)m);
+        int ma = DictInt(desc, CFSTR(kIOPSCurrentKey), 0);
+        int mv = DictInt(desc, CFSTR(kIOPSVoltageKey), 0);
+        if (ma && mv > 0) r.watts = (double)(ma < 0 ? -ma : ma) * mv / 1e6;
+        int tte = DictInt(desc, CFSTR(kIOPSTimeToEmptyKey), -1);    // minutes, -1 = calculating
+        if (tte > 0) r.osTteSec = tte * 60.0;
         break;
     }
-    CFRelease(list);
-    CFRelease(blob);
+    if (list) CFRelease(list);
+    if (blob) CFRelease(blob);
+    PsuPush(r);
+    PsuApply(g_metrics);
+}
+
+// IOKit posts a notification on every power-source change (adapter, each
+// percent); the run-loop source calls onChange on the main thread
+bool StartPowerWatch(void (*onChange)()) {
+    CFRunLoopSourceRef src = IOPSNotificationCreateRunLoopSource(
+        [](void* ctx) { ((void (*)())ctx)(); }, (void*)onChange);
+    if (!src) return false;
+    CFRunLoopAddSource(CFRunLoopGetMain(), src, kCFRunLoopDefaultMode);
+    CFRelease(src);
+    return true;
 }
 
 // ---------------------------------------------------------------------------
@@ -194,14 +262,45 @@ void UpdateNet() {
     uint64_t now = TickMs();
     double dt = (now - g_netTick) / 1000.0;
     if (dt > 0.05 && g_netInit) {
-        g_netDown = (ci >= g_netPrevIn)  ? (ci - g_netPrevIn)  / dt : 0;
-        g_netUp   = (co >= g_netPrevOut) ? (co - g_netPrevOut) / dt : 0;
+        double down = (ci >= g_netPrevIn)  ? (ci - g_netPrevIn)  / dt : 0;
+        double up   = (co >= g_netPrevOut) ? (co - g_netPrevOut) / dt : 0;
+        g_metrics.SetF(METRIC_NET_DOWN, down);
+        g_metrics.SetF(METRIC_NET_UP,   up);
+        RollupPush(HIST_NET_DOWN, (float)down);
+        RollupPush(HIST_NET_UP,   (float)up);
     }
     g_netPrevIn  = ci;
     g_netPrevOut = co;
     g_netTick    = now;
 }
 
+// The kernel posts RTM_NEWADDR / RTM_DELADDR / RTM_IFINFO on every address
+// or link change; a read source on the main queue drains the socket
+static dispatch_source_t g_addrSrc = nil;
+
+bool StartAddrWatch(void (*onChange)()) {
+    int fd = socket(PF_ROUTE, SOCK_RAW, AF_INET);
+    if (fd < 0) return false;
+    fcntl(fd, F_SETFL, O_NONBLOCK);
+    g_addrSrc = dispatch_source_create(DISPATCH_SOURCE_TYPE_READ, (uintptr_t)fd, 0, dispatch_get_main_queue());
+    if (!g_addrSrc) {
+        close(fd);
+        return false;
+    }
+    dispatch_source_set_event_handler(g_addrSrc, ^{
+        char buf[2048];
+        bool changed = false;
+        while (read(fd, buf, sizeof(buf)) > 0) {
+            int type = ((const struct rt_msghdr *)buf)->rtm_type;
+            if (type == RTM_NEWADDR || type == RTM_DELADDR || type == RTM_IFINFO) changed = true;
+        }
+        if (changed) onChange();
+    });
+    dispatch_source_set_cancel_handler(g_addrSrc, ^{ close(fd); });
+    dispatch_resume(g_addrSrc);
+    return true;
+}
+
 void UpdateLanIP() {
     struct ifaddrs *ifap = nullptr;
     if (getifaddrs(&ifap) != 0) return;
@@ -1,10 +1,15 @@
 #include "libs/mem/mem.h"
+#include "libs/rollup/rollup.h"
+#include "libs/metrics/metrics.h"
 
 void UpdateMem() {
     MEMORYSTATUSEX ms = {}; ms.dwLength = sizeof(ms);
     GlobalMemoryStatusEx(&ms);
-    g_ramTotalMB  = ms.ullTotalPhys / (1024 * 1024);
-    g_ramUsedMB   = (ms.ullTotalPhys - ms.ullAvailPhys) / (1024 * 1024);
-    g_swapTotalMB = ms.ullTotalPageFile / (1024 * 1024);
-    g_swapUsedMB  = (ms.ullTotalPageFile - ms.ullAvailPageFile) / (1024 * 1024);
+    ULONGLONG ramTotal = ms.ullTotalPhys / (1024 * 1024);
+    ULONGLONG ramUsed  = (ms.ullTotalPhys - ms.ullAvailPhys) / (1024 * 1024);
+    g_metrics.SetU(METRIC_RAM_TOTAL,  ramTotal);
+    g_metrics.SetU(METRIC_RAM_USED,   ramUsed);
+    g_metrics.SetU(METRIC_SWAP_TOTAL, ms.ullTotalPageFile / (1024 * 1024));
+    g_metrics.SetU(METRIC_SWAP_USED,  (ms.ullTotalPageFile - ms.ullAvailPageFile) / (1024 * 1024));
+    RollupPush(HIST_RAM, ramTotal > 0 ? (float)(ramUsed * 100.0 / ramTotal) : 0.f);
 }
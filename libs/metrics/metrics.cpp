@@ -0,0 +1,26 @@
+#include "libs/metrics/metrics.h"
+
+const MetricDesc g_metricDesc[METRIC_COUNT] = {
+#define SYSMON_METRIC_DESC(id, name, unit, type, n) \
+    { name, unit, type, n, MetricBase(METRIC_##id) },
+    SYSMON_METRICS(SYSMON_METRIC_DESC)
+#undef SYSMON_METRIC_DESC
+};
+
+MetricSet g_metrics = {};
+
+const char* MetricUnitName(MetricUnit u) {
+    switch (u) {
+    case UNIT_COUNT:          return "";
+    case UNIT_PERCENT:        return "percent";
+    case UNIT_MB:             return "megabytes";
+    case UNIT_GB:             return "gigabytes";
+    case UNIT_BYTES_PER_SEC:  return "bytes_per_second";
+    case UNIT_WATTS:          return "watts";
+    case UNIT_SECONDS:        return "seconds";
+    case UNIT_CELSIUS:        return "celsius";
+    case UNIT_RPM:            return "rpm";
+    case UNIT_MHZ:            return "megahertz";
+    }
+    return "";
+}
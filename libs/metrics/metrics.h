@@ -0,0 +1,127 @@
+// SysMonitor - Typed metrics registry
+// Portable: shared by the Windows and macOS front ends.
+// Every metric is declared once below with a compile-time id, unit, value
+// type and slot count. Values live in one contiguous cache-aligned array
+// (MetricSet), so handing a consistent copy to another thread is a memcpy.
+#ifndef SYSMON_METRICS_H
+#define SYSMON_METRICS_H
+
+#include <cstdint>
+
+static const int METRIC_MAX_CORES = 128;
+static const int METRIC_MAX_VOLS  = 26;
+static const int METRIC_MAX_TEMPS = 16;
+static const int METRIC_MAX_FANS  = 8;
+
+enum MetricUnit { UNIT_COUNT, UNIT_PERCENT, UNIT_MB, UNIT_GB, UNIT_BYTES_PER_SEC,
+                  UNIT_WATTS, UNIT_SECONDS, UNIT_CELSIUS, UNIT_RPM, UNIT_MHZ };
+enum MetricType { MT_F64, MT_U64 };
+
+//  X(id,           name,             unit,                type,   slots)
+#define SYSMON_METRICS(X)                                                          \
+    X(CPU_TOTAL,    "cpu.total",      UNIT_PERCENT,        MT_F64, 1)                \
+    X(CPU_CORES,    "cpu.cores",      UNIT_COUNT,          MT_U64, 1)                \
+    X(CPU_CORE,     "cpu.core",       UNIT_PERCENT,        MT_F64, METRIC_MAX_CORES) \
+    X(CPU_FREQ,     "cpu.freq",       UNIT_MHZ,            MT_F64, METRIC_MAX_CORES) \
+    X(CPU_FREQ_MAX, "cpu.freq.max",   UNIT_MHZ,            MT_F64, METRIC_MAX_CORES) \
+    X(CPU_THROTTLE, "cpu.throttle",   UNIT_COUNT,          MT_F64, METRIC_MAX_CORES) \
+    X(CPU_PHYS,     "cpu.phys",       UNIT_COUNT,          MT_U64, METRIC_MAX_CORES) \
+    X(CPU_CLASS,    "cpu.class",      UNIT_COUNT,          MT_U64, METRIC_MAX_CORES) \
+    X(CPU_PCORES,   "cpu.pcores",     UNIT_PERCENT,        MT_F64, 1)                \
+    X(CPU_ECORES,   "cpu.ecores",     UNIT_PERCENT,        MT_F64, 1)                \
+    X(RAM_TOTAL,    "mem.ram.total",  UNIT_MB,             MT_U64, 1)                \
+    X(RAM_USED,     "mem.ram.used",   UNIT_MB,             MT_U64, 1)                \
+    X(SWAP_TOTAL,   "mem.swap.total", UNIT_MB,             MT_U64, 1)                \
+    X(SWAP_USED,    "mem.swap.used",  UNIT_MB,             MT_U64, 1)                \
+    X(GPU_USAGE,    "gpu.usage",      UNIT_PERCENT,        MT_F64, 1)                \
+    X(DISK_VOLS,    "disk.volumes",   UNIT_COUNT,          MT_U64, 1)                \
+    X(DISK_USED,    "disk.used",      UNIT_GB,             MT_F64, METRIC_MAX_VOLS)  \
+    X(DISK_TOTAL,   "disk.total",     UNIT_GB,             MT_F64, METRIC_MAX_VOLS)  \
+    X(NET_DOWN,     "net.down",       UNIT_BYTES_PER_SEC,  MT_F64, 1)                \
+    X(NET_UP,       "net.up",         UNIT_BYTES_PER_SEC,  MT_F64, 1)                \
+    X(BATTERY,      "power.battery",  UNIT_PERCENT,        MT_F64, 1)                \
+    X(POWER_STATE,  "power.state",    UNIT_COUNT,          MT_U64, 1)                \
+    X(POWER_DRAW,   "power.draw",     UNIT_WATTS,          MT_F64, 1)                \
+    X(POWER_TTE,    "power.time_to_empty", UNIT_SECONDS,   MT_F64, 1)                \
+    X(THERM_CPU,    "thermal.cpu",    UNIT_CELSIUS,        MT_F64, 1)                \
+    X(TEMP_COUNT,   "thermal.sensors", UNIT_COUNT,         MT_U64, 1)                \
+    X(TEMP,         "thermal.temp",   UNIT_CELSIUS,        MT_F64, METRIC_MAX_TEMPS) \
+    X(FAN_COUNT,    "thermal.fans",   UNIT_COUNT,          MT_U64, 1)                \
+    X(FAN,          "thermal.fan",    UNIT_RPM,            MT_F64, METRIC_MAX_FANS)
+
+enum MetricId {
+#define SYSMON_METRIC_ID(id, name, unit, type, n) METRIC_##id,
+    SYSMON_METRICS(SYSMON_METRIC_ID)
+#undef SYSMON_METRIC_ID
+    METRIC_COUNT
+};
+
+// First slot of each metric, and the total slot count
+constexpr int METRIC_LEN[] = {
+#define SYSMON_METRIC_LEN(id, name, unit, type, n) n,
+    SYSMON_METRICS(SYSMON_METRIC_LEN)
+#undef SYSMON_METRIC_LEN
+};
+constexpr int MetricBase(int id) { return id == 0 ? 0 : MetricBase(id - 1) + METRIC_LEN[id - 1]; }
+constexpr int METRIC_SLOTS = MetricBase(METRIC_COUNT);
+
+struct MetricDesc {
+    const char* name;
+    MetricUnit  unit;
+    MetricType  type;
+    int         slots;
+    int         base;
+};
+
+extern const MetricDesc g_metricDesc[METRIC_COUNT];
+
+union MetricValue {
+    double   f;
+    uint64_t u;
+};
+
+// One slot per logical core
+constexpr bool MetricPerCore(int id) {
+    return id == METRIC_CPU_CORE || id == METRIC_CPU_FREQ || id == METRIC_CPU_FREQ_MAX ||
+           id == METRIC_CPU_THROTTLE || id == METRIC_CPU_PHYS || id == METRIC_CPU_CLASS;
+}
+
+// Live element count of a metric: array metrics are cut to the current
+// cores / volumes / temperature sensors / fans
+constexpr int MetricLen(MetricId id, int cores, int vols, int temps, int fans) {
+    return MetricPerCore(id) ? cores
+         : (id == METRIC_DISK_USED || id == METRIC_DISK_TOTAL) ? vols
+         : id == METRIC_TEMP ? temps
+         : id == METRIC_FAN  ? fans
+         : METRIC_LEN[id];
+}
+
+struct alignas(64) MetricSet {
+    MetricValue v[METRIC_SLOTS];
+    char        volLabel[METRIC_MAX_VOLS][8];    // UTF-8 display label, "C:" / "/:"
+    char        volPath[METRIC_MAX_VOLS][64];    // UTF-8 mount point
+    char        tempLabel[METRIC_MAX_TEMPS][32]; // UTF-8 "coretemp Package id 0"
+    char        fanLabel[METRIC_MAX_FANS][32];
+
+    double   F(MetricId id, int i = 0) const     { return v[MetricBase(id) + i].f; }
+    uint64_t U(MetricId id, int i = 0) const     { return v[MetricBase(id) + i].u; }
+    void     SetF(MetricId id, double x, int i = 0)   { v[MetricBase(id) + i].f = x; }
+    void     SetU(MetricId id, uint64_t x, int i = 0) { v[MetricBase(id) + i].u = x; }
+
+    int      Cores() const { return (int)U(METRIC_CPU_CORES); }
+    int      Vols()  const { return (int)U(METRIC_DISK_VOLS); }
+    int      Temps() const { return (int)U(METRIC_TEMP_COUNT); }
+    int      Fans()  const { return (int)U(METRIC_FAN_COUNT); }
+    int      Len(MetricId id) const { return MetricLen(id, Cores(), Vols(), Temps(), Fans()); }
+    double   VolPct(int i) const {
+        double t = F(METRIC_DISK_TOTAL, i);
+        return t > 0 ? F(METRIC_DISK_USED, i) * 100.0 / t : 0;
+    }
+};
+
+// Live values, written by the samplers only
+extern MetricSet g_metrics;
+
+const char* MetricUnitName(MetricUnit u);
+
+#endif // SYSMON_METRICS_H
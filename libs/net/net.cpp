@@ -1,4 +1,6 @@
 #include "libs/net/net.h"
+#include "libs/rollup/rollup.h"
+#include "libs/metrics/metrics.h"
 
 static void GetNetTotals(ULONGLONG& in, ULONGLONG& out) {
     in = out = 0;
@@ -30,14 +32,44 @@ void UpdateNet() {
     ULONGLONG now = GetTickCount64();
     double dt = (now - g_netTick) / 1000.0;
     if (dt > 0.05 && g_netInit) {
-        g_netDown = (ci >= g_netPrevIn)  ? (ci - g_netPrevIn)  / dt : 0;
-        g_netUp   = (co >= g_netPrevOut) ? (co - g_netPrevOut) / dt : 0;
+        double down = (ci >= g_netPrevIn)  ? (ci - g_netPrevIn)  / dt : 0;
+        double up   = (co >= g_netPrevOut) ? (co - g_netPrevOut) / dt : 0;
+        g_metrics.SetF(METRIC_NET_DOWN, down);
+        g_metrics.SetF(METRIC_NET_UP,   up);
+        RollupPush(HIST_NET_DOWN, (float)down);
+        RollupPush(HIST_NET_UP,   (float)up);
     }
     g_netPrevIn  = ci;
     g_netPrevOut = co;
     g_netTick    = now;
 }
 
+static OVERLAPPED g_addrOv = {};
+static HANDLE     g_addrHandle = nullptr;
+
+HANDLE StartAddrWatch() {
+    g_addrOv.hEvent = CreateEventW(nullptr, FALSE, FALSE, nullptr);
+    if (!g_addrOv.hEvent) return nullptr;
+    DWORD rc = NotifyAddrChange(&g_addrHandle, &g_addrOv);
+    if (rc != ERROR_IO_PENDING) {
+        CloseHandle(g_addrOv.hEvent);
+        g_addrOv.hEvent = nullptr;
+        return nullptr;
+    }
+    return g_addrOv.hEvent;
+}
+
+void RearmAddrWatch() {
+    if (g_addrOv.hEvent) NotifyAddrChange(&g_addrHandle, &g_addrOv);
+}
+
+void StopAddrWatch() {
+    if (!g_addrOv.hEvent) return;
+    CancelIPChangeNotify(&g_addrOv);
+    CloseHandle(g_addrOv.hEvent);
+    g_addrOv.hEvent = nullptr;
+}
+
 void UpdateLanIP() {
     ULONG size = 0;
     GetAdaptersInfo(nullptr, &size);
@@ -7,4 +7,10 @@ void InitNet();
 void UpdateNet();
 void UpdateLanIP();
 
+// Address-change notification (NotifyAddrChange): an event that is set when
+// any IPv4 address changes, nullptr if unavailable. Rearm after each signal.
+HANDLE StartAddrWatch();
+void   RearmAddrWatch();
+void   StopAddrWatch();
+
 #endif
@@ -0,0 +1,97 @@
+#include "libs/perf/perf.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+
+// Each stage is written by a single thread; readers may see a sample being
+// overwritten, which only ever skews a percentile by one sample.
+struct PerfRing {
+    std::atomic<uint32_t> ns[PERF_WINDOW];
+    std::atomic<uint32_t> head{0};
+    std::atomic<uint32_t> count{0};
+};
+
+static PerfRing g_perf[PERF_STAGE_COUNT];
+
+static const char* kStageNames[PERF_STAGE_COUNT] = {
+    "cpu", "mem", "gpu", "disk", "net", "lanip", "battery", "thermal", "winbehind", "store", "rules",
+    "model", "clear", "chrome", "content", "present",
+};
+
+uint64_t PerfNow() {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void PerfRecord(int stage, uint64_t ns) {
+    PerfRing& r = g_perf[stage];
+    uint32_t h = r.head.load(std::memory_order_relaxed);
+    r.ns[h].store(ns > UINT32_MAX ? UINT32_MAX : (uint32_t)ns, std::memory_order_relaxed);
+    r.head.store((h + 1) % PERF_WINDOW, std::memory_order_relaxed);
+    if (r.count.load(std::memory_order_relaxed) < (uint32_t)PERF_WINDOW)
+        r.count.fetch_add(1, std::memory_order_relaxed);
+}
+
+const char* PerfStageName(int stage) {
+    return (stage >= 0 && stage < PERF_STAGE_COUNT) ? kStageNames[stage] : "?";
+}
+
+static int CopyStage(int stage, uint32_t* out) {
+    const PerfRing& r = g_perf[stage];
+    int n = (int)r.count.load(std::memory_order_relaxed);
+    for (int i = 0; i < n; i++) out[i] = r.ns[i].load(std::memory_order_relaxed);
+    return n;
+}
+
+static double Pct(uint32_t* v, int n, double q) {
+    int k = (int)(q * (n - 1) + 0.5);
+    std::nth_element(v, v + k, v + n);
+    return v[k] / 1000.0;
+}
+
+bool PerfPercentiles(int stage, double& p50, double& p99) {
+    uint32_t v[PERF_WINDOW];
+    int n = CopyStage(stage, v);
+    if (n == 0) return false;
+    p50 = Pct(v, n, 0.50);
+    p99 = Pct(v, n, 0.99);
+    return true;
+}
+
+bool PerfMean(int stage, double& mean) {
+    const PerfRing& r = g_perf[stage];
+    int n = (int)r.count.load(std::memory_order_relaxed);
+    if (n == 0) return false;
+    double sum = 0;
+    for (int i = 0; i < n; i++) sum += r.ns[i].load(std::memory_order_relaxed);
+    mean = sum / n / 1000.0;
+    return true;
+}
+
+std::string PerfReport() {
+    std::string out;
+    char line[128];
+    snprintf(line, sizeof(line), "%-10s %7s %10s %10s %10s %10s\n",
+             "stage", "samples", "p50 us", "p99 us", "max us", "mean us");
+    out += line;
+
+    double tickMean = 0;
+    for (int s = 0; s < PERF_STAGE_COUNT; s++) {
+        uint32_t v[PERF_WINDOW];
+        int n = CopyStage(s, v);
+        if (n == 0) continue;
+        double sum = 0, mx = 0;
+        for (int i = 0; i < n; i++) { sum += v[i]; if (v[i] > mx) mx = v[i]; }
+        double mean = sum / n / 1000.0;
+        tickMean += mean;
+        double p50 = Pct(v, n, 0.50), p99 = Pct(v, n, 0.99);
+        snprintf(line, sizeof(line), "%-10s %7d %10.1f %10.1f %10.1f %10.1f\n",
+                 kStageNames[s], n, p50, p99, mx / 1000.0, mean);
+        out += line;
+    }
+    snprintf(line, sizeof(line), "%-10s %7s %10s %10s %10s %10.1f\n",
+             "tick", "", "", "", "", tickMean);
+    out += line;
+    return out;
+}
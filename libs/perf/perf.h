@@ -0,0 +1,50 @@
+// SysMonitor - Per-stage timing (sampling + render phases)
+// Portable: shared by the Windows and macOS front ends.
+#ifndef SYSMON_PERF_H
+#define SYSMON_PERF_H
+
+#include <cstdint>
+#include <string>
+
+enum PerfStage {
+    // samplers
+    PERF_CPU, PERF_MEM, PERF_GPU, PERF_DISK, PERF_NET, PERF_LANIP,
+    PERF_BATTERY, PERF_THERMAL, PERF_WINBEHIND, PERF_STORE, PERF_RULES,
+    // render phases
+    PERF_MODEL, PERF_CLEAR, PERF_CHROME, PERF_CONTENT, PERF_PRESENT,
+    PERF_STAGE_COUNT
+};
+
+static const int PERF_WINDOW = 256;     // rolling samples kept per stage
+
+uint64_t PerfNow();                     // monotonic, ns
+void     PerfRecord(int stage, uint64_t ns);
+
+// Record the time since t0 against `stage` and return "now", so
+// back-to-back phases can be chained: t = PerfLap(PERF_CLEAR, t);
+inline uint64_t PerfLap(int stage, uint64_t t0) {
+    uint64_t now = PerfNow();
+    PerfRecord(stage, now - t0);
+    return now;
+}
+
+struct PerfScope {
+    int      stage;
+    uint64_t t0;
+    explicit PerfScope(int s) : stage(s), t0(PerfNow()) {}
+    ~PerfScope() { PerfRecord(stage, PerfNow() - t0); }
+};
+
+const char* PerfStageName(int stage);
+
+// Percentiles over the rolling window, in microseconds.
+// Returns false if the stage has no samples yet.
+bool PerfPercentiles(int stage, double& p50, double& p99);
+// Mean over the rolling window, in microseconds; no sort
+bool PerfMean(int stage, double& mean);
+
+// Plain-text table of every stage with samples (p50/p99/max/mean) plus the
+// summed mean per tick.
+std::string PerfReport();
+
+#endif // SYSMON_PERF_H
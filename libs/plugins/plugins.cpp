@@ -0,0 +1,414 @@
+#include "libs/plugins/plugins.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+extern char** environ;
+#endif
+
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+static const uint32_t PLUGIN_LIMIT_MAX = 65536;
+
+struct Plugin {
+    // config, fixed once the workers run
+    std::string label, source, unit;
+    bool        cmd;
+    uint32_t    everyMs, timeoutMs, limit;
+    double      barMin, barMax;
+    bool        bar;
+    // state, under g_plugMtx
+    bool        running;
+    uint64_t    due;
+    PluginValue v;
+};
+
+static std::vector<Plugin>      g_plugins;
+static std::mutex               g_plugMtx;
+static std::condition_variable  g_plugCv;
+static std::deque<int>          g_plugQueue;
+static std::vector<std::thread> g_plugWorkers;
+static bool                     g_plugStop = false;
+
+static uint64_t MonoMs() {
+    using namespace std::chrono;
+    return (uint64_t)duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+// ---------------------------------------------------------------------------
+// Config
+// ---------------------------------------------------------------------------
+// 500ms / 2s / 5m / 1h, bare numbers are seconds
+static bool ParseDuration(const std::string& s, uint32_t* ms) {
+    char* end;
+    double v = strtod(s.c_str(), &end);
+    if (end == s.c_str() || v < 0) return false;
+    double mul = !strcmp(end, "ms") ? 1 : !strcmp(end, "m") ? 60000 : !strcmp(end, "h") ? 3600000
+               : (!*end || !strcmp(end, "s")) ? 1000 : -1;
+    if (mul < 0) return false;
+    *ms = (uint32_t)(v * mul);
+    return true;
+}
+
+static bool ParsePlugin(const std::string& spec, Plugin& p, std::string* err) {
+    p = Plugin();
+    p.everyMs   = 5000;
+    p.timeoutMs = 2000;
+    p.limit     = 4096;
+    p.v.pct     = -1;
+
+    const char* s = spec.c_str();
+    std::vector<std::string> words;
+    for (;;) {
+        while (isspace((unsigned char)*s)) s++;
+        if (!*s) { *err = "missing file: or cmd:"; return false; }
+        if (!strncmp(s, "file:", 5) || !strncmp(s, "cmd:", 4)) break;
+        const char* b = s;
+        while (*s && !isspace((unsigned char)*s)) s++;
+        words.emplace_back(b, s);
+    }
+    p.cmd = s[0] == 'c';
+    s += p.cmd ? 4 : 5;
+    while (isspace((unsigned char)*s)) s++;
+    p.source = s;
+    while (!p.source.empty() && isspace((unsigned char)p.source.back())) p.source.pop_back();
+    if (p.source.empty()) { *err = "empty source"; return false; }
+    if (words.empty()) { *err = "missing label"; return false; }
+
+    p.label = words[0];
+    for (size_t i = 1; i < words.size(); i++) {
+        const std::string& k = words[i];
+        if (i + 1 == words.size()) { *err = "missing value for " + k; return false; }
+        const std::string& v = words[++i];
+        if (k == "every") {
+            if (!ParseDuration(v, &p.everyMs) || p.everyMs < 100) { *err = "bad interval " + v; return false; }
+        } else if (k == "timeout") {
+            if (!ParseDuration(v, &p.timeoutMs) || !p.timeoutMs) { *err = "bad timeout " + v; return false; }
+        } else if (k == "limit") {
+            long n = strtol(v.c_str(), nullptr, 10);
+            if (n <= 0 || n > (long)PLUGIN_LIMIT_MAX) { *err = "bad limit " + v; return false; }
+            p.limit = (uint32_t)n;
+        } else if (k == "bar") {
+            size_t dots = v.find("..");
+            char* end = nullptr;
+            if (dots != std::string::npos) {
+                p.barMin = strtod(v.substr(0, dots).c_str(), nullptr);
+                p.barMax = strtod(v.c_str() + dots + 2, &end);
+            }
+            if (!end || *end || p.barMax <= p.barMin) {
+                *err = "bad bar range " + v; return false;
+            }
+            p.bar = true;
+        } else if (k == "unit") {
+            p.unit = v;
+        } else {
+            *err = "unknown option " + k; return false;
+        }
+    }
+    snprintf(p.v.label, sizeof(p.v.label), "%s", p.label.c_str());
+    return true;
+}
+
+int ConfigurePlugins(const std::vector<std::string>& specs, std::vector<std::string>* errors) {
+    std::lock_guard<std::mutex> lk(g_plugMtx);
+    g_plugins.clear();
+    for (const std::string& s : specs) {
+        Plugin p;
+        std::string err;
+        if ((int)g_plugins.size() == PLUGIN_MAX) err = "more than " + std::to_string(PLUGIN_MAX) + " plugins";
+        else if (ParsePlugin(s, p, &err)) { g_plugins.push_back(p); continue; }
+        if (errors) errors->push_back("plugin \"" + s + "\": " + err);
+    }
+    return (int)g_plugins.size();
+}
+
+int PluginCount() {
+    std::lock_guard<std::mutex> lk(g_plugMtx);
+    return (int)g_plugins.size();
+}
+
+// ---------------------------------------------------------------------------
+// Runs (worker threads, no lock held)
+// ---------------------------------------------------------------------------
+static bool ReadSource(const Plugin& p, std::string* out) {
+    FILE* f = fopen(p.source.c_str(), "rb");
+    if (!f) return false;
+    char buf[1024];
+    size_t n;
+    while (out->size() < p.limit && (n = fread(buf, 1, sizeof(buf), f)) > 0) out->append(buf, n);
+    fclose(f);
+    return true;
+}
+
+#ifdef _WIN32
+
+// cmd.exe /c in a kill-on-close job, so a timeout takes its children too
+static bool RunCommand(const Plugin& p, std::string* out) {
+    std::string line = "cmd.exe /d /s /c \"" + p.source + "\"";
+    std::vector<wchar_t> wline(line.size() + 1);
+    if (!MultiByteToWideChar(CP_UTF8, 0, line.c_str(), -1, wline.data(), (int)wline.size())) return false;
+
+    SECURITY_ATTRIBUTES sa = { sizeof(sa), nullptr, TRUE };
+    HANDLE rd, wr;
+    if (!CreatePipe(&rd, &wr, &sa, 0)) return false;
+    SetHandleInformation(rd, HANDLE_FLAG_INHERIT, 0);
+    HANDLE job = CreateJobObjectW(nullptr, nullptr);
+    JOBOBJECT_EXTENDED_LIMIT_INFORMATION li = {};
+    li.BasicLimitInformation.LimitFlags = JOB_OBJECT_LIMIT_KILL_ON_JOB_CLOSE;
+    if (job) SetInformationJobObject(job, JobObjectExtendedLimitInformation, &li, sizeof(li));
+
+    // Inherit only this run's write end: another worker's pipe, inheritable
+    // between its CreatePipe and CloseHandle, must not reach this child
+    SIZE_T attrLen = 0;
+    InitializeProcThreadAttributeList(nullptr, 1, 0, &attrLen);
+    std::vector<BYTE> attrBuf(attrLen);
+    LPPROC_THREAD_ATTRIBUTE_LIST attrs = (LPPROC_THREAD_ATTRIBUTE_LIST)attrBuf.data();
+    PROCESS_INFORMATION pi;
+    BOOL started = InitializeProcThreadAttributeList(attrs, 1, 0, &attrLen);
+    if (started) {
+        started = UpdateProcThreadAttribute(attrs, 0, PROC_THREAD_ATTRIBUTE_HANDLE_LIST,
+                                            &wr, sizeof(wr), nullptr, nullptr);
+        STARTUPINFOEXW si = {};
+        si.StartupInfo.cb         = sizeof(si);
+        si.StartupInfo.dwFlags    = STARTF_USESTDHANDLES;
+        si.StartupInfo.hStdOutput = wr;
+        si.lpAttributeList        = attrs;
+        if (started)
+            started = CreateProcessW(nullptr, wline.data(), nullptr, nullptr, TRUE,
+                                     CREATE_NO_WINDOW | CREATE_SUSPENDED | EXTENDED_STARTUPINFO_PRESENT,
+                                     nullptr, nullptr, &si.StartupInfo, &pi);
+        DeleteProcThreadAttributeList(attrs);
+    }
+    CloseHandle(wr);
+    if (!started) {
+        CloseHandle(rd);
+        if (job) CloseHandle(job);
+        return false;
+    }
+    if (job) AssignProcessToJobObject(job, pi.hProcess);
+    ResumeThread(pi.hThread);
+    CloseHandle(pi.hThread);
+
+    ULONGLONG deadline = GetTickCount64() + p.timeoutMs;
+    bool ok = true;
+    for (;;) {
+        DWORD avail = 0;
+        // Fails with ERROR_BROKEN_PIPE once every writer has exited: EOF
+        if (!PeekNamedPipe(rd, nullptr, 0, nullptr, &avail, nullptr)) break;
+        if (avail) {
+            char buf[1024];
+            DWORD n = 0;
+            if (!ReadFile(rd, buf, avail < sizeof(buf) ? avail : sizeof(buf), &n, nullptr) || !n) break;
+            out->append(buf, n);
+            if (out->size() > p.limit) { ok = false; break; }
+            continue;
+        }
+        if (GetTickCount64() >= deadline) { ok = false; break; }
+        Sleep(10);
+    }
+    CloseHandle(rd);
+
+    DWORD code = 1;
+    if (ok) {
+        ULONGLONG now = GetTickCount64();
+        DWORD left = now < deadline ? (DWORD)(deadline - now) : 0;
+        ok = WaitForSingleObject(pi.hProcess, left) == WAIT_OBJECT_0 &&
+             GetExitCodeProcess(pi.hProcess, &code) && code == 0;
+    }
+    if (!ok) {
+        if (job) TerminateJobObject(job, 1);
+        else TerminateProcess(pi.hProcess, 1);
+    }
+    CloseHandle(pi.hProcess);
+    if (job) CloseHandle(job);
+    return ok;
+}
+
+#else
+
+// /bin/sh -c in its own process group, so a timeout takes its children too
+static bool RunCommand(const Plugin& p, std::string* out) {
+    // Both ends close-on-exec from the start, so a pipe another worker is
+    // creating right now never reaches this child (dup2 onto 1 clears the
+    // flag for the intended one). macOS has no pipe2; CLOEXEC_DEFAULT below
+    // closes everything not named in the file actions instead.
+    int fds[2];
+#ifdef __APPLE__
+    if (pipe(fds) != 0) return false;
+    fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+    fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+#else
+    if (pipe2(fds, O_CLOEXEC) != 0) return false;
+#endif
+
+    posix_spawn_file_actions_t fa;
+    posix_spawn_file_actions_init(&fa);
+    posix_spawn_file_actions_addopen(&fa, 0, "/dev/null", O_RDONLY, 0);
+    posix_spawn_file_actions_adddup2(&fa, fds[1], 1);
+    posix_spawn_file_actions_addopen(&fa, 2, "/dev/null", O_WRONLY, 0);
+    posix_spawnattr_t at;
+    posix_spawnattr_init(&at);
+#ifdef __APPLE__
+    posix_spawnattr_setflags(&at, POSIX_SPAWN_SETPGROUP | POSIX_SPAWN_CLOEXEC_DEFAULT);
+#else
+    posix_spawnattr_setflags(&at, POSIX_SPAWN_SETPGROUP);
+#endif
+    posix_spawnattr_setpgroup(&at, 0);
+    const char* argv[] = { "/bin/sh", "-c", p.source.c_str(), nullptr };
+    pid_t pid;
+    int rc = posix_spawn(&pid, "/bin/sh", &fa, &at, (char* const*)argv, environ);
+    posix_spawn_file_actions_destroy(&fa);
+    posix_spawnattr_destroy(&at);
+    close(fds[1]);
+    if (rc != 0) {
+        close(fds[0]);
+        return false;
+    }
+
+    uint64_t deadline = MonoMs() + p.timeoutMs;
+    bool ok = true;
+    char buf[1024];
+    for (;;) {
+        uint64_t now = MonoMs();
+        if (now >= deadline) { ok = false; break; }
+        struct pollfd pf = { fds[0], POLLIN, 0 };
+        int r = poll(&pf, 1, (int)(deadline - now));
+        if (r < 0 && errno == EINTR) continue;
+        if (r <= 0) { ok = false; break; }
+        ssize_t n = read(fds[0], buf, sizeof(buf));
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;
+        out->append(buf, (size_t)n);
+        if (out->size() > p.limit) { ok = false; break; }
+    }
+    close(fds[0]);
+
+    // Reap; anything still running past the deadline (or over the limit)
+    // is killed with its whole group
+    int status = 0;
+    for (;;) {
+        pid_t w = waitpid(pid, &status, WNOHANG);
+        if (w == pid) break;
+        if (w < 0 && errno != EINTR) { ok = false; break; }
+        if (!ok || MonoMs() >= deadline) {
+            kill(-pid, SIGKILL);
+            while (waitpid(pid, &status, 0) < 0 && errno == EINTR) {}
+            ok = false;
+            break;
+        }
+        usleep(5000);
+    }
+    return ok && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+#endif
+
+// First output line -> display text (and bar fill if numeric)
+static void Format(const Plugin& p, const std::string& out, PluginValue& v) {
+    size_t b = out.find_first_not_of(" \t\r\n");
+    size_t e = b == std::string::npos ? b : out.find_first_of("\r\n", b);
+    std::string line = b == std::string::npos ? std::string() : out.substr(b, e - b);
+    while (!line.empty() && isspace((unsigned char)line.back())) line.pop_back();
+
+    char* end;
+    double x = strtod(line.c_str(), &end);
+    v.pct = -1;
+    if (end != line.c_str()) {
+        snprintf(v.text, sizeof(v.text), "%.4g%s%s", x, p.unit.empty() ? "" : " ", p.unit.c_str());
+        if (p.bar) {
+            double pct = (x - p.barMin) * 100.0 / (p.barMax - p.barMin);
+            v.pct = (float)(pct < 0 ? 0 : pct > 100 ? 100 : pct);
+        }
+        return;
+    }
+    // Don't cut a UTF-8 sequence in half
+    size_t n = line.size() < sizeof(v.text) - 1 ? line.size() : sizeof(v.text) - 1;
+    while (n > 0 && n < line.size() && ((unsigned char)line[n] & 0xC0) == 0x80) n--;
+    memcpy(v.text, line.data(), n);
+    v.text[n] = 0;
+}
+
+static void Worker() {
+    std::unique_lock<std::mutex> lk(g_plugMtx);
+    for (;;) {
+        g_plugCv.wait(lk, [] { return g_plugStop || !g_plugQueue.empty(); });
+        if (g_plugStop) return;
+        int i = g_plugQueue.front();
+        g_plugQueue.pop_front();
+        const Plugin& p = g_plugins[i];
+        PluginValue v = p.v;
+        lk.unlock();
+
+        std::string out;
+        bool ok = p.cmd ? RunCommand(p, &out) : ReadSource(p, &out);
+        if (ok) Format(p, out, v);
+        v.stale = !ok;
+
+        lk.lock();
+        Plugin& q = g_plugins[i];
+        q.v       = v;
+        q.running = false;
+        q.due     = MonoMs() + q.everyMs;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Public
+// ---------------------------------------------------------------------------
+void StartPlugins() {
+    std::lock_guard<std::mutex> lk(g_plugMtx);
+    if (g_plugins.empty() || !g_plugWorkers.empty()) return;
+    g_plugStop = false;
+    int n = (int)g_plugins.size() < PLUGIN_WORKERS ? (int)g_plugins.size() : PLUGIN_WORKERS;
+    for (int i = 0; i < n; i++) g_plugWorkers.emplace_back(Worker);
+}
+
+void StopPlugins() {
+    {
+        std::lock_guard<std::mutex> lk(g_plugMtx);
+        g_plugStop = true;
+        g_plugQueue.clear();
+    }
+    g_plugCv.notify_all();
+    for (std::thread& t : g_plugWorkers) t.join();
+    g_plugWorkers.clear();
+}
+
+void PluginTick() {
+    uint64_t now = MonoMs();
+    bool queued = false;
+    {
+        std::lock_guard<std::mutex> lk(g_plugMtx);
+        if (g_plugWorkers.empty()) return;
+        for (int i = 0; i < (int)g_plugins.size(); i++) {
+            Plugin& p = g_plugins[i];
+            if (p.running || now < p.due) continue;
+            p.running = true;
+            g_plugQueue.push_back(i);
+            queued = true;
+        }
+    }
+    if (queued) g_plugCv.notify_all();
+}
+
+int PluginValues(PluginValue* out, int cap) {
+    std::lock_guard<std::mutex> lk(g_plugMtx);
+    int n = 0;
+    for (; n < cap && n < (int)g_plugins.size(); n++) out[n] = g_plugins[n].v;
+    return n;
+}
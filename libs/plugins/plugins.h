@@ -0,0 +1,48 @@
+// SysMonitor - Custom metric plugins
+// Portable: shared by the Windows and macOS front ends.
+// One plugin per line:
+//   label [every DUR] [timeout DUR] [limit BYTES] [bar MIN..MAX] [unit U] file: PATH
+//   label [every DUR] [timeout DUR] [limit BYTES] [bar MIN..MAX] [unit U] cmd: COMMAND
+// e.g.
+//   Fan  every 2s bar 0..5000 unit rpm  file: /sys/class/hwmon/hwmon1/fan1_input
+//   Jobs every 30s timeout 5s           cmd: curl -s http://farm/api/queued
+// The first line of the output is shown; if it starts with a number the
+// value gets the unit and, with bar, a bar scaled to MIN..MAX.
+// Runs happen on a small worker pool, never on the sampling or UI thread.
+// PluginTick() only queues plugins that are due and not already running,
+// so a hung plugin holds at most one worker and is never queued twice.
+// Commands are killed at their timeout (default 2s) or once they print
+// more than the limit (default 4 KB); the last good result stays cached
+// and is shown as stale.
+#ifndef SYSMON_PLUGINS_H
+#define SYSMON_PLUGINS_H
+
+#include <string>
+#include <vector>
+
+static const int PLUGIN_MAX     = 12;
+static const int PLUGIN_WORKERS = 2;
+
+struct PluginValue {
+    char  label[24];
+    char  text[48];         // value + unit, or the first output line (UTF-8)
+    float pct;              // bar fill 0..100, or -1 for no bar
+    bool  stale;            // last run failed or timed out
+};
+
+// Replaces the plugin list; must run before StartPlugins(). Lines that
+// don't parse are skipped and described in errors. Returns the count.
+int  ConfigurePlugins(const std::vector<std::string>& specs, std::vector<std::string>* errors);
+int  PluginCount();
+
+void StartPlugins();
+// Waits for running workers, which a command may hold until its timeout
+void StopPlugins();
+
+// Sampling thread, once per tick: queues due plugins. Never blocks on a run.
+void PluginTick();
+
+// Cached results, in configuration order; returns the number written
+int  PluginValues(PluginValue* out, int cap);
+
+#endif // SYSMON_PLUGINS_H
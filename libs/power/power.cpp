@@ -0,0 +1,67 @@
+#include "libs/power/power.h"
+#include "libs/sampler/sampler.h"
+#include "libs/rates/rates.h"
+
+// GUID_CONSOLE_DISPLAY_STATE (Win8+ SDKs only); Data: 0 = off, 1 = on, 2 = dimmed
+static const GUID DISPLAY_STATE_GUID =
+    { 0x6fe69556, 0x704a, 0x47a0, { 0x8f, 0x24, 0xc2, 0x8d, 0x93, 0x6f, 0xda, 0x47 } };
+
+// GUID_ACDC_POWER_SOURCE, GUID_BATTERY_PERCENTAGE_REMAINING
+static const GUID ACDC_GUID =
+    { 0x5d3e9a59, 0xe9d5, 0x4b00, { 0xa6, 0xbd, 0xff, 0x34, 0xff, 0x51, 0x65, 0x48 } };
+static const GUID BATTERY_PCT_GUID =
+    { 0xa7ad8041, 0xb45a, 0x4cae, { 0x87, 0xa3, 0xee, 0xcb, 0xb4, 0x68, 0xa9, 0xe1 } };
+
+static HPOWERNOTIFY g_displayNotify = nullptr;
+static HPOWERNOTIFY g_acdcNotify    = nullptr;
+static HPOWERNOTIFY g_batteryNotify = nullptr;
+
+void InitPowerState(HWND hw) {
+    WTSRegisterSessionNotification(hw, NOTIFY_FOR_THIS_SESSION);
+    g_displayNotify = RegisterPowerSettingNotification(hw, &DISPLAY_STATE_GUID,
+        DEVICE_NOTIFY_WINDOW_HANDLE);
+    // Plug / unplug and each percent step resample the battery
+    g_acdcNotify    = RegisterPowerSettingNotification(hw, &ACDC_GUID, DEVICE_NOTIFY_WINDOW_HANDLE);
+    g_batteryNotify = RegisterPowerSettingNotification(hw, &BATTERY_PCT_GUID, DEVICE_NOTIFY_WINDOW_HANDLE);
+}
+
+void CleanupPowerState(HWND hw) {
+    WTSUnRegisterSessionNotification(hw);
+    if (g_displayNotify) UnregisterPowerSettingNotification(g_displayNotify);
+    g_displayNotify = nullptr;
+    if (g_acdcNotify) UnregisterPowerSettingNotification(g_acdcNotify);
+    if (g_batteryNotify) UnregisterPowerSettingNotification(g_batteryNotify);
+    g_acdcNotify = g_batteryNotify = nullptr;
+}
+
+void OnSessionChange(HWND hw, WPARAM wp) {
+    if (wp == WTS_SESSION_LOCK || wp == WTS_CONSOLE_DISCONNECT)
+        g_sessionLocked = true;
+    else if (wp == WTS_SESSION_UNLOCK || wp == WTS_CONSOLE_CONNECT)
+        g_sessionLocked = false;
+    else
+        return;
+    ApplyPowerMode(hw);
+}
+
+void OnPowerSetting(HWND hw, const POWERBROADCAST_SETTING* ps) {
+    if (ps && (IsEqualGUID(ps->PowerSetting, ACDC_GUID) || IsEqualGUID(ps->PowerSetting, BATTERY_PCT_GUID))) {
+        RateTrigger(RATE_BATTERY);      // rides along on the next tick
+        return;
+    }
+    if (!ps || !IsEqualGUID(ps->PowerSetting, DISPLAY_STATE_GUID) || ps->DataLength < 1)
+        return;
+    g_displayOff = ps->Data[0] == 0;
+    ApplyPowerMode(hw);
+}
+
+void ApplyPowerMode(HWND hw) {
+    int mode = (g_sessionLocked || g_displayOff) ? PM_BACKGROUND
+             : g_visible                         ? PM_ACTIVE
+             :                                     PM_HIDDEN;
+    if (mode == g_powerMode) return;
+    g_powerMode = mode;
+    // Re-arms the sampling period; on PM_ACTIVE it also refreshes the LAN
+    // IP, which is not sampled while off screen, so a stale one isn't shown.
+    WakeSampler();
+}
@@ -0,0 +1,18 @@
+#ifndef SYSMON_POWER_H
+#define SYSMON_POWER_H
+
+#include "libs/globals/globals.h"
+
+// PM_ACTIVE     - widget on screen: sample + render every UPDATE_MS
+//                 (the sampler thread reads g_powerMode to pick its period)
+// PM_HIDDEN     - widget hidden: keep sampling, skip rendering-only work
+// PM_BACKGROUND - display off or session locked: sample every BACKGROUND_MS
+enum PowerMode { PM_ACTIVE, PM_HIDDEN, PM_BACKGROUND };
+
+void InitPowerState(HWND hw);
+void CleanupPowerState(HWND hw);
+void OnSessionChange(HWND hw, WPARAM wp);
+void OnPowerSetting(HWND hw, const POWERBROADCAST_SETTING* ps);
+void ApplyPowerMode(HWND hw);
+
+#endif
@@ -0,0 +1,226 @@
+#include "libs/rates/rates.h"
+#include "libs/perf/perf.h"
+
+#include <atomic>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+static const char* kRateNames[RATE_COUNT] = {
+    "cpu", "mem", "gpu", "disk", "net", "lanip", "battery", "thermal",
+};
+static const int kRateStage[RATE_COUNT] = {
+    PERF_CPU, PERF_MEM, PERF_GPU, PERF_DISK, PERF_NET, PERF_LANIP, PERF_BATTERY, PERF_THERMAL,
+};
+
+// Timer wheel: level L has 64 slots of 64^L ticks each. An entry sits on
+// the lowest level whose span still reaches its expiry and cascades one
+// level down whenever the level below wraps. Expiring is a walk of one
+// level-0 slot, so its cost is the number of entries due.
+static const int      WHEEL_LEVELS = 4;
+static const int      WHEEL_BITS   = 6;
+static const int      WHEEL_SLOTS  = 1 << WHEEL_BITS;
+static const uint32_t WHEEL_MAX    = (1u << (WHEEL_BITS * WHEEL_LEVELS)) - 1;    // ticks
+
+struct WheelEntry {
+    uint64_t expires;           // in ticks
+    uint32_t period;            // 0 = not on the wheel
+    int      next;              // in its slot's list, -1 = last
+};
+
+static WheelEntry g_ent[RATE_COUNT];
+static int        g_slot[WHEEL_LEVELS][WHEEL_SLOTS];
+static uint64_t   g_now = 0;
+
+static RateConfig g_cfg;
+static uint32_t   g_baseMs = 0;
+static bool       g_ready  = false;    // wheel built by SetRates
+
+static uint32_t   g_prevActive = 0;
+
+static std::atomic<uint32_t> g_triggered(0);
+static std::atomic<uint32_t> g_ticks(0);
+static std::atomic<uint32_t> g_skipped[RATE_COUNT];
+
+static void WheelInsert(int id) {
+    WheelEntry& e = g_ent[id];
+    int lvl = 0;
+    while (lvl < WHEEL_LEVELS - 1 &&
+           (e.expires >> (WHEEL_BITS * lvl)) - (g_now >> (WHEEL_BITS * lvl)) >= (uint64_t)WHEEL_SLOTS)
+        lvl++;
+    int slot = (int)((e.expires >> (WHEEL_BITS * lvl)) & (WHEEL_SLOTS - 1));
+    e.next = g_slot[lvl][slot];
+    g_slot[lvl][slot] = id;
+}
+
+// Detaches a whole slot and returns its list
+static int WheelTake(int lvl, int slot) {
+    int head = g_slot[lvl][slot];
+    g_slot[lvl][slot] = -1;
+    return head;
+}
+
+static uint32_t WheelAdvance() {
+    g_now++;
+    for (int lvl = WHEEL_LEVELS - 1; lvl >= 1; lvl--) {
+        if (g_now & ((1ull << (WHEEL_BITS * lvl)) - 1)) continue;
+        for (int id = WheelTake(lvl, (int)((g_now >> (WHEEL_BITS * lvl)) & (WHEEL_SLOTS - 1))); id >= 0;) {
+            int next = g_ent[id].next;
+            WheelInsert(id);
+            id = next;
+        }
+    }
+    uint32_t due = 0;
+    for (int id = WheelTake(0, (int)(g_now & (WHEEL_SLOTS - 1))); id >= 0;) {
+        int next = g_ent[id].next;
+        due |= 1u << id;
+        g_ent[id].expires = g_now + g_ent[id].period;
+        WheelInsert(id);
+        id = next;
+    }
+    return due;
+}
+
+static uint32_t Ticks(uint32_t ms, uint32_t baseMs) {
+    uint32_t t = baseMs ? (ms + baseMs - 1) / baseMs : 1;
+    return t < 1 ? 1 : t > WHEEL_MAX ? WHEEL_MAX : t;
+}
+
+static void Schedule() {
+    for (int l = 0; l < WHEEL_LEVELS; l++)
+        for (int s = 0; s < WHEEL_SLOTS; s++) g_slot[l][s] = -1;
+    for (int i = 0; i < RATE_COUNT; i++) {
+        WheelEntry& e = g_ent[i];
+        e.period = g_cfg.ms[i] == RATE_ON_CHANGE ? 0 : Ticks(g_cfg.ms[i], g_baseMs);
+        if (!e.period) continue;
+        e.expires = g_now + e.period;
+        WheelInsert(i);
+    }
+    g_ready = true;
+}
+
+RateConfig DefaultRates() {
+    RateConfig c;
+    c.ms[RATE_CPU]     = 1000;
+    c.ms[RATE_MEM]     = 1000;
+    c.ms[RATE_GPU]     = 1000;
+    c.ms[RATE_DISK]    = 30000;
+    c.ms[RATE_NET]     = 1000;
+    c.ms[RATE_LANIP]   = RATE_ON_CHANGE;
+    c.ms[RATE_BATTERY] = 60000;
+    c.ms[RATE_THERMAL] = 1000;
+    return c;
+}
+
+bool ParseRates(const char* spec, RateConfig& c, std::string* error) {
+    RateConfig out = c;
+    const char* p = spec;
+    for (;;) {
+        while (isspace((unsigned char)*p) || *p == ',') p++;
+        if (!*p) break;
+        const char* key = p;
+        while (isalpha((unsigned char)*p)) p++;
+        std::string name(key, (size_t)(p - key));
+        int src = -1;
+        for (int i = 0; i < RATE_COUNT; i++)
+            if (name == kRateNames[i]) src = i;
+        if (src < 0) {
+            if (error) *error = "intervals: unknown sampler '" + name + "' (cpu, mem, gpu, disk, net, lanip, battery, thermal)";
+            return false;
+        }
+        while (isspace((unsigned char)*p)) p++;
+        if (strncmp(p, "change", 6) == 0 && !isalnum((unsigned char)p[6])) {
+            if (src != RATE_LANIP && src != RATE_BATTERY) {
+                if (error) *error = "intervals: only lanip and battery can be 'change'";
+                return false;
+            }
+            out.ms[src] = RATE_ON_CHANGE;
+            p += 6;
+            continue;
+        }
+        // 500ms / 2s / 5m, bare numbers are seconds
+        char* end;
+        double v = strtod(p, &end);
+        double mul = 1000;
+        if (end[0] == 'm' && end[1] == 's') { mul = 1; end += 2; }
+        else if (*end == 's') end++;
+        else if (*end == 'm') { mul = 60000; end++; }
+        if (end == p || v <= 0 || isalnum((unsigned char)*end)) {
+            if (error) *error = "intervals: '" + name + "' needs a duration or 'change'";
+            return false;
+        }
+        out.ms[src] = (uint32_t)(v * mul);
+        p = end;
+    }
+    c = out;
+    return true;
+}
+
+void SetRates(const RateConfig& c, uint32_t baseMs) {
+    g_cfg    = c;
+    g_baseMs = baseMs;
+    Schedule();
+}
+
+void SetRateBase(uint32_t baseMs) {
+    if (!g_ready) g_baseMs = baseMs;
+    else if (baseMs != g_baseMs) SetRates(g_cfg, baseMs);
+}
+
+void SetRate(int src, uint32_t ms) {
+    if (src < 0 || src >= RATE_COUNT || g_cfg.ms[src] == ms) return;
+    g_cfg.ms[src] = ms;
+    Schedule();
+}
+
+uint32_t RateMs(int src) {
+    return (src >= 0 && src < RATE_COUNT) ? g_cfg.ms[src] : 0;
+}
+
+uint32_t RatesTick(uint32_t active) {
+    if (!g_ready) return active;
+    // A source that just became active (widget shown, probes back on) runs
+    // now rather than up to a whole interval later
+    uint32_t due = (WheelAdvance() | g_triggered.exchange(0, std::memory_order_acq_rel) |
+                    ~g_prevActive) & active;
+    g_prevActive = active;
+    for (int i = 0; i < RATE_COUNT; i++)
+        if ((active >> i) & 1 && !((due >> i) & 1)) g_skipped[i].fetch_add(1, std::memory_order_relaxed);
+    g_ticks.fetch_add(1, std::memory_order_relaxed);
+    return due;
+}
+
+void RateTrigger(int src) {
+    g_triggered.fetch_or(1u << src, std::memory_order_acq_rel);
+}
+
+double RatesSavedUs() {
+    uint32_t ticks = g_ticks.load(std::memory_order_relaxed);
+    if (!ticks) return 0;
+    double saved = 0;
+    for (int i = 0; i < RATE_COUNT; i++) {
+        uint32_t skipped = g_skipped[i].load(std::memory_order_relaxed);
+        double mean;
+        if (skipped && PerfMean(kRateStage[i], mean)) saved += mean * skipped / ticks;
+    }
+    return saved;
+}
+
+size_t FormatRates(char* buf, size_t cap) {
+    if (!cap) return 0;
+    size_t n = 0;
+    int w = snprintf(buf, cap, "saved %.1f us/tick", RatesSavedUs());
+    if (w > 0) n = (size_t)w < cap ? (size_t)w : cap - 1;
+    // Only the sources slower than every tick
+    for (int i = 0; i < RATE_COUNT && n < cap - 1; i++) {
+        uint32_t ms = g_cfg.ms[i];
+        if (ms != RATE_ON_CHANGE && ms <= g_baseMs) continue;
+        if (ms == RATE_ON_CHANGE)  w = snprintf(buf + n, cap - n, "  %s change", kRateNames[i]);
+        else if (ms % 60000 == 0)  w = snprintf(buf + n, cap - n, "  %s %um", kRateNames[i], ms / 60000);
+        else if (ms % 1000 == 0)   w = snprintf(buf + n, cap - n, "  %s %us", kRateNames[i], ms / 1000);
+        else                       w = snprintf(buf + n, cap - n, "  %s %ums", kRateNames[i], ms);
+        if (w > 0) n += (size_t)w < cap - n ? (size_t)w : cap - n - 1;
+    }
+    return n;
+}
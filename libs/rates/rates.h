@@ -0,0 +1,59 @@
+// SysMonitor - Multi-rate sampling
+// Portable: shared by the Windows, macOS and Linux builds.
+// Every sampler has its own interval instead of running on every tick.
+// A hierarchical timer wheel (4 levels of 64 slots, counted in base ticks)
+// hands out the due ones, so a tick costs O(due sources) no matter how
+// many there are or how long their intervals. Intervals are configurable:
+//   Windows      HKCU\Software\SysMonitor  "Intervals" (REG_SZ)
+//   Linux/macOS  "intervals = ..." in the config file
+//   e.g.         disk 30s battery 1m lanip change
+// "change" runs a sampler only when RateTrigger() says its input changed
+// (LAN IP: address-change notifications; battery: power-source change
+// notifications, which otherwise only shorten the wait for the next poll).
+// Intervals shorter than the base tick run every tick.
+#ifndef SYSMON_RATES_H
+#define SYSMON_RATES_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+enum RateSource {
+    RATE_CPU, RATE_MEM, RATE_GPU, RATE_DISK, RATE_NET, RATE_LANIP, RATE_BATTERY,
+    RATE_THERMAL, RATE_COUNT
+};
+
+static const uint32_t RATE_ON_CHANGE = 0;
+
+struct RateConfig {
+    uint32_t ms[RATE_COUNT];    // interval per source, RATE_ON_CHANGE = event driven
+};
+
+// cpu/mem/gpu/net/thermal 1s, disk 30s, battery 60s, lanip on change
+RateConfig DefaultRates();
+// Overrides the named sources in c; false (c untouched) on a syntax error
+bool ParseRates(const char* spec, RateConfig& c, std::string* error);
+
+// Sampling thread. Schedules every source relative to the base tick;
+// calling it again with a new base (power mode, shed level) re-times them.
+void SetRates(const RateConfig& c, uint32_t baseMs);
+void SetRateBase(uint32_t baseMs);
+// The address watcher is unavailable: poll the source at ms instead
+void SetRate(int src, uint32_t ms);
+uint32_t RateMs(int src);
+
+// Sampling thread, once per base tick: the sources in `active` that are
+// due (interval elapsed, triggered, or not active last tick), as a bit mask
+uint32_t RatesTick(uint32_t active);
+inline bool RateDue(uint32_t mask, int src) { return (mask >> src) & 1; }
+
+// Any thread: run src on the next tick
+void RateTrigger(int src);
+
+// Sampler time avoided per tick, from the stages' mean cost (PerfMean)
+// and how often each source was skipped, in microseconds
+double RatesSavedUs();
+// "saved 41.2 us/tick  disk 30s  battery 1m  lanip change"
+size_t FormatRates(char* buf, size_t cap);
+
+#endif // SYSMON_RATES_H
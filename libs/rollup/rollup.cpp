@@ -0,0 +1,166 @@
+#include "libs/rollup/rollup.h"
+#include "libs/metrics/metrics.h"
+
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+static const uint32_t TIER_MS[TIER_COUNT] = { 10000, 60000, 600000 };
+
+struct RollupBucket {
+    uint32_t epoch;             // nowMs / tier width; identifies the slot's owner
+    uint32_t count;
+    float    min, max;
+    double   sum;
+};
+
+struct Series {
+    RollupBucket b[TIER_COUNT][ROLLUP_BUCKETS];
+    uint16_t     sk[TIER_COUNT][ROLLUP_BUCKETS][SKETCH_BINS];
+};
+
+static Series       g_series[HIST_COUNT];
+static RollupBucket g_core[METRIC_MAX_CORES][ROLLUP_CORE_BUCKETS];  // TIER_1M
+
+// ---------------------------------------------------------------------------
+// Sketch bins: linear over 0..100 for percentages, log2-spaced up to
+// 16 GB/s (~1.45x per bin) for network rates
+// ---------------------------------------------------------------------------
+static const float LOG_SPAN = 34.f;
+
+static bool IsRate(int id) { return id == HIST_NET_DOWN || id == HIST_NET_UP; }
+
+static int Bin(int id, float v) {
+    float x = IsRate(id) ? (v < 1.f ? -1.f : 1.f + std::log2(v) * (SKETCH_BINS - 2) / LOG_SPAN)
+                         : v * SKETCH_BINS / 100.f;
+    int b = (int)x;
+    return b < 0 ? 0 : b >= SKETCH_BINS ? SKETCH_BINS - 1 : b;
+}
+
+static float BinValue(int id, int b) {
+    if (!IsRate(id)) return (b + 0.5f) * 100.f / SKETCH_BINS;
+    return b == 0 ? 0.f : std::exp2((b - 0.5f) * LOG_SPAN / (SKETCH_BINS - 2));
+}
+
+// ---------------------------------------------------------------------------
+// Push
+// ---------------------------------------------------------------------------
+uint64_t RollupClockMs() {
+    using namespace std::chrono;
+    return (uint64_t)duration_cast<milliseconds>(system_clock::now().time_since_epoch()).count();
+}
+
+// The bucket for `epoch` in a ring of `slots`, recycled if it still holds
+// an older one
+static RollupBucket& Open(RollupBucket* tier, int slots, uint32_t epoch, uint16_t* sk) {
+    RollupBucket& b = tier[epoch % slots];
+    if (b.epoch != epoch || b.count == 0) {
+        b.epoch = epoch;
+        b.count = 0;
+        b.min   = FLT_MAX;
+        b.max   = -FLT_MAX;
+        b.sum   = 0;
+        if (sk) memset(sk, 0, SKETCH_BINS * sizeof(uint16_t));
+    }
+    return b;
+}
+
+static void Add(RollupBucket& b, float v) {
+    if (v < b.min) b.min = v;
+    if (v > b.max) b.max = v;
+    b.sum += v;
+    b.count++;
+}
+
+void RollupPush(HistId id, float v, uint64_t nowMs) {
+    HistPush(g_hist[id], v);
+    Series& s = g_series[id];
+    int bin = Bin(id, v);
+    for (int t = 0; t < TIER_COUNT; t++) {
+        uint32_t e = (uint32_t)(nowMs / TIER_MS[t]);
+        uint16_t* sk = s.sk[t][e % ROLLUP_BUCKETS];
+        Add(Open(s.b[t], ROLLUP_BUCKETS, e, sk), v);
+        if (sk[bin] < 0xFFFF) sk[bin]++;
+    }
+}
+
+void RollupPushCore(int core, float v, uint64_t nowMs) {
+    if (core < 0 || core >= METRIC_MAX_CORES) return;
+    Add(Open(g_core[core], ROLLUP_CORE_BUCKETS, (uint32_t)(nowMs / TIER_MS[TIER_1M]), nullptr), v);
+}
+
+// ---------------------------------------------------------------------------
+// Queries
+// ---------------------------------------------------------------------------
+// Coarsest tier that resolves windowSec in <= 60 buckets
+static int PickTier(int windowSec) {
+    for (int t = 0; t < TIER_COUNT; t++)
+        if ((uint64_t)windowSec * 1000 <= (uint64_t)TIER_MS[t] * 60) return t;
+    return TIER_COUNT - 1;
+}
+
+// Buckets of a tier covering the last windowSec, newest included, at most
+// the ring's `slots`
+static int Span(int tier, int windowSec, int slots = ROLLUP_BUCKETS) {
+    int k = (int)(((uint64_t)windowSec * 1000 + TIER_MS[tier] - 1) / TIER_MS[tier]);
+    return k < 1 ? 1 : k > slots ? slots : k;
+}
+
+static RollupStats Window(const RollupBucket* tier, int slots, uint32_t width, int k, uint64_t nowMs) {
+    RollupStats st = { FLT_MAX, -FLT_MAX, 0, 0 };
+    double sum = 0;
+    uint32_t e = (uint32_t)(nowMs / width);
+    for (int i = 0; i < k; i++, e--) {
+        const RollupBucket& b = tier[e % slots];
+        if (b.epoch != e || !b.count) continue;
+        if (b.min < st.min) st.min = b.min;
+        if (b.max > st.max) st.max = b.max;
+        sum += b.sum;
+        st.count += b.count;
+    }
+    if (!st.count) return RollupStats{ 0, 0, 0, 0 };
+    st.avg = (float)(sum / st.count);
+    return st;
+}
+
+RollupStats RollupWindow(HistId id, int windowSec, uint64_t nowMs) {
+    int t = PickTier(windowSec);
+    return Window(g_series[id].b[t], ROLLUP_BUCKETS, TIER_MS[t], Span(t, windowSec), nowMs);
+}
+
+RollupStats RollupCoreWindow(int core, int windowSec, uint64_t nowMs) {
+    if (core < 0 || core >= METRIC_MAX_CORES) return RollupStats{ 0, 0, 0, 0 };
+    return Window(g_core[core], ROLLUP_CORE_BUCKETS, TIER_MS[TIER_1M],
+                  Span(TIER_1M, windowSec, ROLLUP_CORE_BUCKETS), nowMs);
+}
+
+float RollupQuantile(HistId id, int windowSec, float q, uint64_t nowMs) {
+    const Series& s = g_series[id];
+    int t = PickTier(windowSec), k = Span(t, windowSec);
+    uint32_t merged[SKETCH_BINS] = {};
+    uint32_t total = 0;
+    float lo = FLT_MAX, hi = -FLT_MAX;
+    uint32_t e = (uint32_t)(nowMs / TIER_MS[t]);
+    for (int i = 0; i < k; i++, e--) {
+        const RollupBucket& b = s.b[t][e % ROLLUP_BUCKETS];
+        if (b.epoch != e || !b.count) continue;
+        const uint16_t* sk = s.sk[t][e % ROLLUP_BUCKETS];
+        for (int j = 0; j < SKETCH_BINS; j++) merged[j] += sk[j];
+        total += b.count;
+        if (b.min < lo) lo = b.min;
+        if (b.max > hi) hi = b.max;
+    }
+    if (!total) return 0;
+    if (q < 0) q = 0;
+    if (q > 1) q = 1;
+    uint32_t rank = (uint32_t)(q * (total - 1)), cum = 0;
+    int bin = SKETCH_BINS - 1;
+    for (int j = 0; j < SKETCH_BINS; j++) {
+        cum += merged[j];
+        if (cum > rank) { bin = j; break; }
+    }
+    // Bin midpoints can overshoot what was actually seen
+    float v = BinValue(id, bin);
+    return v < lo ? lo : v > hi ? hi : v;
+}
@@ -0,0 +1,45 @@
+// SysMonitor - Multi-resolution rollups and windowed quantiles
+// Portable: shared by the Windows and macOS front ends.
+// Each history series (HistId) is kept at four resolutions: the raw 1 s
+// ring (libs/history) plus 10 s, 1 min and 10 min tiers of min/max/sum/
+// count buckets, each bucket with a 64-bin mergeable quantile sketch.
+// Sparklines draw the 1 s ring (HistMinMax); tooltips query the tiers.
+// A new sample updates the open bucket of every tier directly, so a push
+// is O(1). Window queries pick the coarsest tier that still resolves the
+// window in at most 60 buckets, so their cost does not grow with the
+// number of samples covered. Per-core CPU keeps the last 16 min of a 1 min
+// tier without sketches, for the tooltips' 15 min window.
+// Single writer; readers must run on the writer's thread (or work from a
+// copy handed over with the snapshot).
+#ifndef SYSMON_ROLLUP_H
+#define SYSMON_ROLLUP_H
+
+#include <cstdint>
+
+#include "libs/history/history.h"
+
+enum RollupTier { TIER_10S, TIER_1M, TIER_10M, TIER_COUNT };
+
+static const int ROLLUP_BUCKETS      = 360;    // 1 h / 6 h / 60 h
+static const int ROLLUP_CORE_BUCKETS = 16;     // per core, TIER_1M
+static const int SKETCH_BINS         = 64;
+
+struct RollupStats {
+    float    min, max, avg;
+    uint32_t count;             // samples covered; 0 = no data
+};
+
+uint64_t RollupClockMs();       // wall clock, ms
+
+// Appends to g_hist[id] (the 1 s tier) and to every rollup tier
+void RollupPush(HistId id, float v, uint64_t nowMs = RollupClockMs());
+void RollupPushCore(int core, float v, uint64_t nowMs = RollupClockMs());
+
+// min/max/avg over the last windowSec seconds (bucket-aligned)
+RollupStats RollupWindow(HistId id, int windowSec, uint64_t nowMs = RollupClockMs());
+RollupStats RollupCoreWindow(int core, int windowSec, uint64_t nowMs = RollupClockMs());
+
+// q in [0,1], e.g. 0.95; 0 if the window holds no samples
+float RollupQuantile(HistId id, int windowSec, float q, uint64_t nowMs = RollupClockMs());
+
+#endif // SYSMON_ROLLUP_H
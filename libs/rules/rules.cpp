@@ -0,0 +1,299 @@
+#include "libs/rules/rules.h"
+
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+static const int RULE_MAX_INSTR = 2048;
+
+enum RuleSrc { SRC_METRIC, SRC_RAM_PCT, SRC_SWAP_PCT, SRC_DISK_PCT };
+enum RuleOp  { OP_GT, OP_GE, OP_LT, OP_LE };
+
+// One compiled condition over one slot; [*] rules own one per core/volume
+struct RuleInstr {
+    // program
+    uint16_t rule;          // index into g_ruleNames
+    uint8_t  src;           // RuleSrc
+    uint8_t  op;            // RuleOp
+    MetricId id;            // SRC_METRIC
+    int16_t  index;         // slot, -1 for scalars
+    bool     rate;
+    double   threshold;
+    double   clear;
+    uint32_t forMs;
+    uint32_t windowMs;      // rate window
+    // state
+    bool     active;
+    uint64_t since;         // condition first held, 0 = not holding
+    uint64_t t0;            // rate window start, 0 = none yet
+    double   v0;
+    double   lastRate;
+    bool     haveRate;
+};
+
+static RuleInstr                g_prog[RULE_MAX_INSTR];
+static int                      g_progLen = 0;
+static std::vector<std::string> g_ruleNames;
+
+// ---------------------------------------------------------------------------
+// Compiler
+// ---------------------------------------------------------------------------
+struct RuleLexer {
+    const char* p;
+    void Skip() { while (*p == ' ' || *p == '\t') p++; }
+    bool Eat(const char* tok) {
+        Skip();
+        size_t n = strlen(tok);
+        if (strncmp(p, tok, n) != 0) return false;
+        // Keywords must not run into an identifier
+        if (isalpha((unsigned char)tok[n - 1]) && isalnum((unsigned char)p[n])) return false;
+        p += n;
+        return true;
+    }
+    bool Number(double* v) {
+        Skip();
+        char* end;
+        *v = strtod(p, &end);
+        if (end == p) return false;
+        p = end;
+        return true;
+    }
+    int Ident(char* buf, int cap) {
+        Skip();
+        int n = 0;
+        while ((isalnum((unsigned char)*p) || *p == '.' || *p == '_') && n < cap - 1) buf[n++] = *p++;
+        buf[n] = 0;
+        return n;
+    }
+    // 30 / 30s / 5m / 1h, in ms
+    bool Duration(uint32_t* ms) {
+        double v;
+        if (!Number(&v) || v < 0) return false;
+        double mul = 1000;
+        if (*p == 's')      { p++; }
+        else if (*p == 'm') { p++; mul = 60000; }
+        else if (*p == 'h') { p++; mul = 3600000; }
+        *ms = (uint32_t)(v * mul);
+        return true;
+    }
+};
+
+// Slot count the [*] form expands to, or 1 for scalars
+static int Slots(int src, MetricId id) {
+    if (src == SRC_DISK_PCT) return METRIC_MAX_VOLS;
+    if (src == SRC_METRIC)   return g_metricDesc[id].slots;
+    return 1;
+}
+
+static bool ParseMetric(const char* name, int* src, MetricId* id) {
+    *id = METRIC_COUNT;
+    if (!strcmp(name, "mem.ram.pct"))  { *src = SRC_RAM_PCT;  return true; }
+    if (!strcmp(name, "mem.swap.pct")) { *src = SRC_SWAP_PCT; return true; }
+    if (!strcmp(name, "disk.pct"))     { *src = SRC_DISK_PCT; return true; }
+    for (int i = 0; i < METRIC_COUNT; i++) {
+        if (!strcmp(name, g_metricDesc[i].name)) {
+            *src = SRC_METRIC;
+            *id  = (MetricId)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Compiles one rule into g_prog; on failure nothing is emitted
+static bool CompileRule(const std::string& text, std::string* err) {
+    RuleLexer lx = { text.c_str() };
+    RuleInstr t = {};
+
+    // Optional "name:" prefix; the name runs up to the first colon
+    std::string name = text;
+    const char* colon = strchr(lx.p, ':');
+    if (colon) {
+        name.assign(lx.p, colon);
+        lx.p = colon + 1;
+    }
+    while (!name.empty() && isspace((unsigned char)name.back())) name.pop_back();
+    size_t lead = name.find_first_not_of(" \t");
+    name = lead == std::string::npos ? std::string() : name.substr(lead);
+    if (name.empty()) { *err = "empty rule name"; return false; }
+
+    t.rate = lx.Eat("rate");
+    if (t.rate && !lx.Eat("(")) { *err = "expected ( after rate"; return false; }
+
+    char metric[32];
+    int src;
+    if (!lx.Ident(metric, sizeof(metric))) { *err = "expected a metric"; return false; }
+    if (!ParseMetric(metric, &src, &t.id)) { *err = std::string("unknown metric ") + metric; return false; }
+    t.src = (uint8_t)src;
+
+    int slots = Slots(src, t.id), first = 0, last = slots - 1;
+    if (lx.Eat("[")) {
+        double ix;
+        if (lx.Eat("*")) {}
+        else if (lx.Number(&ix) && ix >= 0 && ix < slots && ix == (int)ix) first = last = (int)ix;
+        else { *err = "bad index"; return false; }
+        if (!lx.Eat("]")) { *err = "expected ]"; return false; }
+    }
+
+    if (t.rate) {
+        t.windowMs = 60000;
+        if (lx.Eat(",") && (!lx.Duration(&t.windowMs) || t.windowMs < 1000)) {
+            *err = "bad rate window"; return false;
+        }
+        if (!lx.Eat(")")) { *err = "expected )"; return false; }
+    }
+
+    if      (lx.Eat(">=")) t.op = OP_GE;
+    else if (lx.Eat("<=")) t.op = OP_LE;
+    else if (lx.Eat(">"))  t.op = OP_GT;
+    else if (lx.Eat("<"))  t.op = OP_LT;
+    else { *err = "expected > >= < <="; return false; }
+
+    if (!lx.Number(&t.threshold)) { *err = "expected a threshold"; return false; }
+    if (lx.Eat("/s"))      {}
+    else if (lx.Eat("/m")) t.threshold /= 60;
+    else if (lx.Eat("/h")) t.threshold /= 3600;
+    bool above = t.op == OP_GT || t.op == OP_GE;
+
+    if (lx.Eat("for") && !lx.Duration(&t.forMs)) { *err = "bad duration"; return false; }
+
+    double band = fabs(t.threshold) * 0.05;
+    t.clear = above ? t.threshold - band : t.threshold + band;
+    if (lx.Eat("clear")) {
+        if (!lx.Number(&t.clear)) { *err = "expected a clear level"; return false; }
+        if (lx.Eat("/s"))      {}
+        else if (lx.Eat("/m")) t.clear /= 60;
+        else if (lx.Eat("/h")) t.clear /= 3600;
+        if (above ? t.clear > t.threshold : t.clear < t.threshold) {
+            *err = "clear level is past the threshold"; return false;
+        }
+    }
+    lx.Skip();
+    if (*lx.p) { *err = std::string("unexpected ") + lx.p; return false; }
+
+    if (g_progLen + (last - first + 1) > RULE_MAX_INSTR) { *err = "too many rules"; return false; }
+    t.rule = (uint16_t)g_ruleNames.size();
+    g_ruleNames.push_back(name);
+    for (int i = first; i <= last; i++) {
+        g_prog[g_progLen] = t;
+        g_prog[g_progLen].index = (int16_t)(slots > 1 ? i : -1);
+        g_progLen++;
+    }
+    return true;
+}
+
+int CompileRules(const std::vector<std::string>& rules, std::vector<std::string>* errors) {
+    g_progLen = 0;
+    g_ruleNames.clear();
+    g_ruleNames.reserve(rules.size());      // names are handed out by pointer
+    int n = 0;
+    for (const std::string& r : rules) {
+        std::string err;
+        if (CompileRule(r, &err)) n++;
+        else if (errors) errors->push_back("alert \"" + r + "\": " + err);
+    }
+    return n;
+}
+
+bool HaveRules() {
+    return g_progLen > 0;
+}
+
+// ---------------------------------------------------------------------------
+// Evaluation
+// ---------------------------------------------------------------------------
+static double Pct(uint64_t used, uint64_t total) {
+    return total > 0 ? (double)used * 100.0 / total : 0;
+}
+
+// Current value of an instruction's slot; false if the slot isn't live
+static bool Fetch(const RuleInstr& r, const MetricSet& m, double* v) {
+    int ix = r.index < 0 ? 0 : r.index;
+    switch (r.src) {
+    case SRC_RAM_PCT:  *v = Pct(m.U(METRIC_RAM_USED), m.U(METRIC_RAM_TOTAL));   return true;
+    case SRC_SWAP_PCT: *v = Pct(m.U(METRIC_SWAP_USED), m.U(METRIC_SWAP_TOTAL)); return true;
+    case SRC_DISK_PCT:
+        if (ix >= m.Vols()) return false;
+        *v = m.VolPct(ix);
+        return true;
+    }
+    if (ix >= m.Len(r.id)) return false;
+    *v = g_metricDesc[r.id].type == MT_U64 ? (double)m.U(r.id, ix) : m.F(r.id, ix);
+    return true;
+}
+
+static void Emit(const RuleInstr& r, const MetricSet& m, double v, AlertSink sink, void* ctx) {
+    AlertEvent e;
+    e.rule   = g_ruleNames[r.rule].c_str();
+    bool vol = r.src == SRC_DISK_PCT || (r.src == SRC_METRIC && (r.id == METRIC_DISK_USED || r.id == METRIC_DISK_TOTAL));
+    e.volume = vol ? m.volPath[r.index] : nullptr;
+    e.index  = r.index;
+    e.value  = v;
+    e.rate   = r.rate;
+    e.firing = r.active;
+    sink(ctx, e);
+}
+
+void EvalRules(const MetricSet& m, uint64_t nowMs, AlertSink sink, void* ctx) {
+    for (int k = 0; k < g_progLen; k++) {
+        RuleInstr& r = g_prog[k];
+        double v;
+        if (!Fetch(r, m, &v)) {
+            // Core or volume went away: drop its state without an event
+            r.active = r.haveRate = false;
+            r.since = r.t0 = 0;
+            continue;
+        }
+        if (r.rate) {
+            // One difference per window keeps the state O(1) per slot
+            if (r.t0 == 0 || nowMs < r.t0) {
+                r.t0 = nowMs;
+                r.v0 = v;
+                continue;
+            }
+            if (nowMs - r.t0 >= r.windowMs) {
+                r.lastRate = (v - r.v0) * 1000.0 / (double)(nowMs - r.t0);
+                r.haveRate = true;
+                r.t0 = nowMs;
+                r.v0 = v;
+            }
+            if (!r.haveRate) continue;
+            v = r.lastRate;
+        }
+
+        if (r.active) {
+            // Hysteresis: stay firing until the value is back past the clear level
+            bool above = r.op == OP_GT || r.op == OP_GE;
+            if (above ? v < r.clear : v > r.clear) {
+                r.active = false;
+                r.since  = 0;
+                Emit(r, m, v, sink, ctx);
+            }
+            continue;
+        }
+        bool hit = r.op == OP_GT ? v >  r.threshold
+                 : r.op == OP_GE ? v >= r.threshold
+                 : r.op == OP_LT ? v <  r.threshold
+                 :                 v <= r.threshold;
+        if (!hit) {
+            r.since = 0;
+            continue;
+        }
+        if (r.since == 0 || nowMs < r.since) r.since = nowMs;
+        if (nowMs - r.since >= r.forMs) {
+            r.active = true;
+            Emit(r, m, v, sink, ctx);
+        }
+    }
+}
+
+void FormatAlert(const AlertEvent& e, char* buf, size_t cap) {
+    char where[80] = "";
+    if (e.volume && e.volume[0]) snprintf(where, sizeof(where), " (%s)", e.volume);
+    else if (e.index >= 0)       snprintf(where, sizeof(where), " [%d]", e.index);
+    const char* unit = e.rate ? "/s" : "";
+    if (e.firing) snprintf(buf, cap, "%s%s: %.4g%s", e.rule, where, e.value, unit);
+    else          snprintf(buf, cap, "%s%s: resolved (%.4g%s)", e.rule, where, e.value, unit);
+}
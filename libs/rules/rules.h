@@ -0,0 +1,48 @@
+// SysMonitor - Alert rules
+// Portable: shared by the Windows, macOS and Linux builds.
+// One rule per line:
+//   [name:] target op number [for DUR] [clear number]
+//   target  metric[i] | metric[*] | rate(metric[i] [, DUR])
+//   op      >  >=  <  <=
+//   DUR     10s / 5m / 1h
+// Metrics are registry names (cpu.core, net.down, ...) plus the derived
+// mem.ram.pct, mem.swap.pct and disk.pct. [*] expands to every core or
+// volume. rate() is the change per second over DUR (default 60s); its
+// threshold may be written per minute or hour, e.g. "> 1/m".
+//   core pinned: cpu.core[*] > 95 for 30s
+//   ram:         mem.ram.pct > 90 for 60s clear 85
+//   disk:        rate(disk.pct[*], 5m) > 1/m
+// Rules compile to a flat instruction array evaluated once per tick in
+// O(instructions). An alert fires once the condition has held for DUR and
+// resolves only when the value crosses the clear level (default: 5% back
+// from the threshold), so values hovering at the threshold don't flap.
+#ifndef SYSMON_RULES_H
+#define SYSMON_RULES_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "libs/metrics/metrics.h"
+
+struct AlertEvent {
+    const char* rule;       // name, or the rule text
+    const char* volume;     // mount point for disk rules, else nullptr
+    int         index;      // core/volume, -1 for scalar metrics
+    double      value;      // metric value, or change per second
+    bool        rate;
+    bool        firing;     // false = resolved
+};
+
+typedef void (*AlertSink)(void* ctx, const AlertEvent& e);
+
+// Replaces the program. Rules that don't parse are skipped and described
+// in errors (one line each). Returns the number of rules compiled.
+int  CompileRules(const std::vector<std::string>& rules, std::vector<std::string>* errors);
+void EvalRules(const MetricSet& m, uint64_t nowMs, AlertSink sink, void* ctx);
+bool HaveRules();
+
+// "core pinned [3]: 99.1" / "ram: resolved (84.7)"
+void FormatAlert(const AlertEvent& e, char* buf, size_t cap);
+
+#endif // SYSMON_RULES_H
@@ -0,0 +1,280 @@
+#include "libs/sampler/sampler.h"
+#include "libs/cpu/cpu.h"
+#include "libs/mem/mem.h"
+#include "libs/gpu/gpu.h"
+#include "libs/disk/disk.h"
+#include "libs/net/net.h"
+#include "libs/power/power.h"
+#include "libs/battery/battery_win.h"
+#include "libs/thermal/thermal.h"
+#include "libs/perf/perf.h"
+#include "libs/config/config.h"
+#include "libs/exporter/exporter.h"
+#include "libs/tsdb/tsdb.h"
+#include "libs/rules/rules.h"
+#include "libs/shm/shm.h"
+#include "libs/sched/sched.h"
+#include "libs/rates/rates.h"
+
+#include <mutex>
+
+// Triple buffer: the sampler owns g_back, the UI thread owns g_front, and
+// g_middle holds the third slot plus a FRESH bit set by each publish.
+static const int         SNAP_FRESH = 4;
+static Snapshot          g_slots[3];
+static std::atomic<int>  g_middle(1);
+static int               g_back  = 0;
+static int               g_front = 2;
+static ULONGLONG         g_seq   = 0;
+
+static HANDLE            g_samplerThread = nullptr;
+static HANDLE            g_samplerWake   = nullptr;
+static HANDLE            g_tickTimer     = nullptr;
+static int               g_sampleJob     = -1;
+static int               g_fetchJob      = -1;
+static HANDLE            g_addrEvt       = nullptr;   // LAN IP "on change"
+
+// Win7+: a waitable timer the kernel may delay by up to the tolerance to
+// batch it with other wakeups; Vista falls back to an exact one
+typedef BOOL (WINAPI *SetWaitableTimerEx_t)(HANDLE, const LARGE_INTEGER*, LONG, PTIMERAPCROUTINE,
+                                           LPVOID, PVOID, ULONG);
+static SetWaitableTimerEx_t g_setTimerEx = nullptr;
+static HWND              g_notifyHwnd    = nullptr;
+
+// Alert lines from the rules engine, handed to the UI thread
+static const int         ALERT_QUEUE = 16;
+static std::mutex        g_alertMtx;
+static wchar_t           g_alertQ[ALERT_QUEUE][160];
+static int               g_alertHead = 0, g_alertLen = 0;
+
+static void Timed(int stage, void (*fn)()) {
+    PerfScope ps(stage);
+    fn();
+}
+
+static void Fill(Snapshot& s) {
+    s.seq = ++g_seq;
+    memcpy(&s.m, &g_metrics, sizeof(s.m));
+    swprintf_s(s.lanIP, L"%s", g_lanIP.c_str());
+    // Rollups are sampler-owned; the UI only sees these copies
+    memcpy(s.hist, g_hist, sizeof(s.hist));
+    uint64_t now = RollupClockMs();
+    for (int i = 0; i < s.m.Cores(); i++) s.coreWin[i] = RollupCoreWindow(i, TIP_WINDOW_SEC, now);
+    s.cpuP95 = RollupQuantile(HIST_CPU, TIP_WINDOW_SEC, 0.95f, now);
+    s.numPlugins = PluginValues(s.plugins, PLUGIN_MAX);
+    s.self = FootprintCur();
+    s.shed = FootprintShed();
+    strcpy_s(s.shedNote, FootprintNote());
+    s.sched = SchedCur();
+}
+
+static void Publish() {
+    Fill(g_slots[g_back]);
+    ExporterPublish(g_metrics);
+    ShmPublish(g_metrics, TsdbNowMs());
+    g_back = g_middle.exchange(g_back | SNAP_FRESH, std::memory_order_acq_rel) & 3;
+    if (g_notifyHwnd) PostMessageW(g_notifyHwnd, WM_SNAPSHOT, 0, 0);
+}
+
+// One UTF-8 line for the balloon; posted once the window exists
+static void QueueLine(const char* msg) {
+    {
+        std::lock_guard<std::mutex> lk(g_alertMtx);
+        // Full queue: the oldest line goes, the newest state matters more
+        if (g_alertLen == ALERT_QUEUE) { g_alertHead = (g_alertHead + 1) % ALERT_QUEUE; g_alertLen--; }
+        wchar_t* dst = g_alertQ[(g_alertHead + g_alertLen++) % ALERT_QUEUE];
+        if (!MultiByteToWideChar(CP_UTF8, 0, msg, -1, dst, 160)) dst[0] = 0;
+    }
+    if (g_notifyHwnd) PostMessageW(g_notifyHwnd, WM_ALERT, 0, 0);
+}
+
+static void QueueAlert(void*, const AlertEvent& e) {
+    char msg[160];
+    FormatAlert(e, msg, sizeof(msg));
+    QueueLine(msg);
+}
+
+// A bad alert, budget, plugin or interval setting: to the debugger and,
+// like macOS and the agent log, somewhere the user sees it
+static void ConfigError(const std::string& e) {
+    OutputDebugStringA(("SysMonitor: " + e + "\n").c_str());
+    char msg[160];
+    snprintf(msg, sizeof(msg), "%s", e.c_str());
+    QueueLine(msg);
+}
+
+static void EvalAlerts() {
+    EvalRules(g_metrics, GetTickCount64(), QueueAlert, nullptr);
+}
+
+static void Sample() {
+    uint32_t active = 0;
+    if (SectionOn(SEC_ID_CPU))  active |= 1u << RATE_CPU;
+    if (SectionOn(SEC_ID_MEM))  active |= 1u << RATE_MEM;
+    if (g_sections.gpu && !ShedProbes()) active |= 1u << RATE_GPU;
+    if (SectionOn(SEC_ID_DISK)) active |= 1u << RATE_DISK;
+    if (SectionOn(SEC_ID_NET))  active |= 1u << RATE_NET;
+    active |= 1u << RATE_BATTERY;   // exporter / shm only, no widget row
+    if (SectionOn(SEC_ID_THERMAL) || g_exporterPort) active |= 1u << RATE_THERMAL;
+    // Rendering-only work: nothing consumes it while the widget is off screen
+    if (g_powerMode == PM_ACTIVE && SectionOn(SEC_ID_NET) && !ShedProbes())
+        active |= 1u << RATE_LANIP;
+
+    uint32_t due = RatesTick(active);
+    if (RateDue(due, RATE_CPU))   Timed(PERF_CPU,   UpdateCpu);
+    if (RateDue(due, RATE_MEM))   Timed(PERF_MEM,   UpdateMem);
+    if (RateDue(due, RATE_GPU))   Timed(PERF_GPU,   UpdateGpu);
+    if (RateDue(due, RATE_DISK))  Timed(PERF_DISK,  UpdateDisk);
+    if (RateDue(due, RATE_NET))   Timed(PERF_NET,   UpdateNet);
+    if (SectionOn(SEC_ID_PLUGIN)) PluginTick();
+    if (RateDue(due, RATE_LANIP)) Timed(PERF_LANIP, UpdateLanIP);
+    if (RateDue(due, RATE_BATTERY)) Timed(PERF_BATTERY, UpdateBattery);
+    if (RateDue(due, RATE_THERMAL)) Timed(PERF_THERMAL, UpdateThermal);
+}
+
+// Absolute UTC due time, so the sampling tick stays on second boundaries
+static void ArmTimer(const SchedWake& w) {
+    LARGE_INTEGER due;
+    due.QuadPart = (LONGLONG)(w.atMs + 11644473600000ull) * 10000;     // 1970 -> 1601
+    if (g_setTimerEx) g_setTimerEx(g_tickTimer, &due, 0, nullptr, nullptr, nullptr, w.slackMs);
+    else SetWaitableTimer(g_tickTimer, &due, 0, nullptr, nullptr, FALSE);
+}
+
+// Sampling period for the power mode and shed level
+static DWORD SamplePeriod() {
+    DWORD ms = g_powerMode == PM_BACKGROUND ? BACKGROUND_MS : UPDATE_MS;
+    return ms * FootprintPeriodScale();
+}
+
+static DWORD WINAPI SamplerThread(LPVOID) {
+    HANDLE evts[4] = { g_shutdownEvt, g_samplerWake, g_tickTimer, g_addrEvt };
+    DWORD  numEvts = g_addrEvt ? 4 : 3;
+    for (;;) {
+        DWORD ms = SamplePeriod();
+        SchedSetPeriod(g_sampleJob, ms, ms / 20, SchedWallMs());    // 5% slack
+        SetRateBase(ms);
+        ArmTimer(SchedNext(SchedWallMs()));
+        DWORD r = WaitForMultipleObjects(numEvts, evts, FALSE, INFINITE);
+        if (r == WAIT_OBJECT_0) break;
+        FootprintWake();
+        if (r == WAIT_OBJECT_0 + 3) {
+            // An address changed: the LAN IP rides along on the next tick
+            RateTrigger(RATE_LANIP);
+            RearmAddrWatch();
+            continue;
+        }
+        if (r == WAIT_OBJECT_0 + 1) {
+            // Mode change: a CPU delta over a fraction of the period is
+            // noise, so only the LAN IP is refreshed before re-arming.
+            if (g_powerMode != PM_ACTIVE || !SectionOn(SEC_ID_NET)) continue;
+            Timed(PERF_LANIP, UpdateLanIP);
+        } else {
+            uint32_t due = SchedRun(SchedWallMs());
+            if (SchedDue(due, g_fetchJob)) SetEvent(g_fetchEvt);
+            if (!SchedDue(due, g_sampleJob)) continue;
+            Sample();
+            Timed(PERF_STORE, [] { TsdbAppend(g_metrics, TsdbNowMs()); });
+            if (HaveRules()) Timed(PERF_RULES, EvalAlerts);
+            FootprintTick(GetTickCount64());
+        }
+        Publish();
+    }
+    return 0;
+}
+
+void InitSampler() {
+    if (g_historyFile != "off") {
+        std::string path = g_historyFile.empty() ? TsdbDefaultPath() : g_historyFile;
+        TsdbOpen(path.c_str());
+    }
+    std::vector<std::string> errors;
+    CompileRules(g_alerts, &errors);
+    FootprintBudget budget;
+    std::string err;
+    if (ParseBudget(g_budget.c_str(), budget, &err)) SetFootprintBudget(budget);
+    else errors.push_back(err);
+    FootprintTick(GetTickCount64());
+    ShmOpen();
+    if (SectionOn(SEC_ID_PLUGIN) && ConfigurePlugins(g_pluginSpecs, &errors)) StartPlugins();
+    if (SectionOn(SEC_ID_CPU))  InitCpu();
+    if (SectionOn(SEC_ID_MEM))  UpdateMem();
+    if (g_sections.gpu)         { InitGpuD3dKmt(); UpdateGpu(); }
+    if (SectionOn(SEC_ID_DISK)) UpdateDisk();
+    if (SectionOn(SEC_ID_NET))  { InitNet(); UpdateLanIP(); }
+    if (SectionOn(SEC_ID_THERMAL) || g_exporterPort) InitThermal();
+    RateConfig rates = DefaultRates();
+    if (!ParseRates(g_intervals.c_str(), rates, &err)) errors.push_back(err);
+    SetRates(rates, SamplePeriod());
+    for (const std::string& e : errors) ConfigError(e);
+    Publish();
+    LatchSnapshot();
+}
+
+void StartSampler(HWND hw) {
+    g_notifyHwnd    = hw;
+    {
+        // Config errors queued by InitSampler, before there was a window
+        std::lock_guard<std::mutex> lk(g_alertMtx);
+        if (g_alertLen) PostMessageW(hw, WM_ALERT, 0, 0);
+    }
+    g_samplerWake   = CreateEventW(nullptr, FALSE, FALSE, nullptr);
+    g_tickTimer     = CreateWaitableTimerW(nullptr, FALSE, nullptr);
+    g_setTimerEx    = (SetWaitableTimerEx_t)GetProcAddress(GetModuleHandleW(L"kernel32.dll"),
+                                                           "SetWaitableTimerEx");
+    // Sampling lands on wall-clock boundaries; the fetch rides along on
+    // whichever sampling wakeup falls in its 30 s window
+    uint64_t now = SchedWallMs();
+    DWORD ms = SamplePeriod();
+    g_sampleJob = SchedAdd(ms, ms / 20, SCHED_ALIGNED, now);   // 5% slack
+    if (WantExternal()) g_fetchJob = SchedAdd(BG_FETCH_MS, BG_FETCH_MS / 10, 0, now);
+    // Without address notifications the LAN IP falls back to polling
+    if (RateMs(RATE_LANIP) == RATE_ON_CHANGE && SectionOn(SEC_ID_NET) && !(g_addrEvt = StartAddrWatch()))
+        SetRate(RATE_LANIP, 60000);
+    g_samplerThread = CreateThread(nullptr, 0, SamplerThread, nullptr, 0, nullptr);
+}
+
+// Expects g_shutdownEvt to be signalled already
+void StopSampler() {
+    if (g_samplerThread) {
+        WaitForSingleObject(g_samplerThread, 5000);
+        CloseHandle(g_samplerThread);
+        g_samplerThread = nullptr;
+    }
+    if (g_samplerWake) {
+        CloseHandle(g_samplerWake);
+        g_samplerWake = nullptr;
+    }
+    if (g_tickTimer) {
+        CloseHandle(g_tickTimer);
+        g_tickTimer = nullptr;
+    }
+    if (g_addrEvt) {
+        StopAddrWatch();
+        g_addrEvt = nullptr;
+    }
+    CleanupThermal();
+    CleanupCpu();
+}
+
+void WakeSampler() {
+    if (g_samplerWake) SetEvent(g_samplerWake);
+}
+
+bool LatchSnapshot() {
+    if (!(g_middle.load(std::memory_order_relaxed) & SNAP_FRESH)) return false;
+    g_front = g_middle.exchange(g_front, std::memory_order_acq_rel) & 3;
+    return true;
+}
+
+bool PopAlert(wchar_t* buf, int cap) {
+    std::lock_guard<std::mutex> lk(g_alertMtx);
+    if (!g_alertLen) return false;
+    wcsncpy_s(buf, cap, g_alertQ[g_alertHead], _TRUNCATE);
+    g_alertHead = (g_alertHead + 1) % ALERT_QUEUE;
+    g_alertLen--;
+    return true;
+}
+
+const Snapshot& CurSnapshot() {
+    return g_slots[g_front];
+}
@@ -0,0 +1,50 @@
+// SysMonitor - Sampler thread
+// All Update*() calls run here. Each pass copies the results into an
+// immutable Snapshot and publishes it through a wait-free triple buffer,
+// then posts WM_SNAPSHOT; the UI thread latches the newest one and renders
+// from it without taking any lock.
+#ifndef SYSMON_SAMPLER_H
+#define SYSMON_SAMPLER_H
+
+#include "libs/globals/globals.h"
+#include "libs/rollup/rollup.h"
+#include "libs/metrics/metrics.h"
+#include "libs/plugins/plugins.h"
+#include "libs/footprint/footprint.h"
+#include "libs/sched/sched.h"
+
+// Tooltip look-back window for per-core stats and the CPU p95
+static const int TIP_WINDOW_SEC = 15 * 60;
+
+struct Snapshot {
+    ULONGLONG   seq;
+    MetricSet   m;
+    wchar_t     lanIP[48];
+    History     hist[HIST_COUNT];                   // 1 s tier, for sparklines
+    RollupStats coreWin[METRIC_MAX_CORES];          // TIP_WINDOW_SEC per core
+    float       cpuP95;                             // over TIP_WINDOW_SEC
+    int         numPlugins;
+    PluginValue plugins[PLUGIN_MAX];                // cached results, never waits on a run
+    Footprint   self;                               // our own overhead, moving averages
+    int         shed;                               // ShedLevel
+    char        shedNote[128];                      // last budget action, UTF-8
+    SchedStats  sched;                              // timer wakeups, last window
+};
+
+// Init*() plus one synchronous pass, latched before the window exists
+void InitSampler();
+// Starts the thread; snapshots are announced to hw with WM_SNAPSHOT
+void StartSampler(HWND hw);
+void StopSampler();
+// Power mode changed: re-arm the period (and refresh the LAN IP if active)
+void WakeSampler();
+
+// UI thread only, on WM_ALERT: next queued alert line (UTF-16), false
+// once the queue is drained. Alerts are never dropped by snapshot latching.
+bool PopAlert(wchar_t* buf, int cap);
+
+// UI thread only. Latch returns true if a newer snapshot was taken.
+bool LatchSnapshot();
+const Snapshot& CurSnapshot();
+
+#endif
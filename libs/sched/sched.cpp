@@ -0,0 +1,130 @@
+#include "libs/sched/sched.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <ctime>
+#endif
+
+#include <cstdio>
+
+// Timers never fire early, but the wall clock read after the wakeup can
+// trail the timer's own by a tick
+static const uint32_t SCHED_EARLY_MS = 2;
+
+struct SchedJob {
+    uint32_t periodMs, slackMs;
+    int      flags;
+    uint64_t dueMs;
+};
+
+static SchedJob   g_jobs[SCHED_MAX_JOBS];
+static int        g_numJobs  = 0;
+static uint64_t   g_winStart = 0;
+static uint32_t   g_winWakes = 0, g_winJobs = 0;
+static SchedStats g_stats    = {};
+
+uint64_t SchedWallMs() {
+#ifdef _WIN32
+    FILETIME ft;
+    GetSystemTimeAsFileTime(&ft);
+    ULARGE_INTEGER t = { { ft.dwLowDateTime, ft.dwHighDateTime } };
+    return t.QuadPart / 10000 - 11644473600000ull;     // 1601 -> 1970
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (uint64_t)ts.tv_sec * 1000 + (uint64_t)ts.tv_nsec / 1000000;
+#endif
+}
+
+// First due time at or after nowMs + 1 period (aligned: next boundary)
+static uint64_t FirstDue(const SchedJob& j, uint64_t nowMs) {
+    if (j.flags & SCHED_ALIGNED) return (nowMs / j.periodMs + 1) * j.periodMs;
+    return nowMs + j.periodMs;
+}
+
+int SchedAdd(uint32_t periodMs, uint32_t slackMs, int flags, uint64_t nowMs) {
+    if (g_numJobs == SCHED_MAX_JOBS) return -1;
+    SchedJob& j = g_jobs[g_numJobs];
+    j.periodMs = periodMs ? periodMs : 1;
+    j.slackMs  = slackMs;
+    j.flags    = flags;
+    j.dueMs    = FirstDue(j, nowMs);
+    return g_numJobs++;
+}
+
+bool SchedSetPeriod(int id, uint32_t periodMs, uint32_t slackMs, uint64_t nowMs) {
+    if (id < 0 || id >= g_numJobs) return false;
+    SchedJob& j = g_jobs[id];
+    if (!periodMs) periodMs = 1;
+    if (j.periodMs == periodMs && j.slackMs == slackMs) return false;
+    j.periodMs = periodMs;
+    j.slackMs  = slackMs;
+    j.dueMs    = FirstDue(j, nowMs);
+    return true;
+}
+
+SchedWake SchedNext(uint64_t nowMs) {
+    SchedWake w = { nowMs + 60000, 0 };
+    if (!g_numJobs) return w;
+    // The wall clock went back: re-time instead of sleeping through the gap
+    for (int i = 0; i < g_numJobs; i++) {
+        SchedJob& j = g_jobs[i];
+        if (j.dueMs > nowMs + j.periodMs + j.slackMs) j.dueMs = FirstDue(j, nowMs);
+    }
+    // Latest acceptable moment is the tightest deadline; wake as early as
+    // possible while still catching every job whose window opens by then
+    uint64_t deadline = UINT64_MAX;
+    for (int i = 0; i < g_numJobs; i++) {
+        uint64_t d = g_jobs[i].dueMs + g_jobs[i].slackMs;
+        if (d < deadline) deadline = d;
+    }
+    uint64_t at = 0;
+    for (int i = 0; i < g_numJobs; i++)
+        if (g_jobs[i].dueMs <= deadline && g_jobs[i].dueMs > at) at = g_jobs[i].dueMs;
+    w.atMs    = at;
+    w.slackMs = (uint32_t)(deadline - at);
+    return w;
+}
+
+uint32_t SchedRun(uint64_t nowMs) {
+    uint32_t mask = 0;
+    int ran = 0;
+    for (int i = 0; i < g_numJobs; i++) {
+        SchedJob& j = g_jobs[i];
+        if (j.dueMs > nowMs + SCHED_EARLY_MS) continue;
+        mask |= 1u << i;
+        ran++;
+        // Next boundary after now: a late or stalled wakeup skips ahead
+        // rather than bursting to catch up
+        if (j.flags & SCHED_ALIGNED) j.dueMs = FirstDue(j, nowMs + SCHED_EARLY_MS);
+        else if ((j.dueMs += j.periodMs) <= nowMs) j.dueMs = nowMs + j.periodMs;
+    }
+
+    if (!g_winStart || nowMs < g_winStart) {
+        g_winStart = nowMs;
+        g_winWakes = g_winJobs = 0;
+    }
+    g_winWakes++;
+    g_winJobs += ran;
+    if (nowMs - g_winStart >= SCHED_STATS_MS) {
+        g_stats.wakeupsPerSec = g_winWakes * 1000.0 / (double)(nowMs - g_winStart);
+        g_stats.jobsPerWake   = (double)g_winJobs / g_winWakes;
+        g_stats.valid         = true;
+        g_winStart = nowMs;
+        g_winWakes = g_winJobs = 0;
+    }
+    return mask;
+}
+
+SchedStats SchedCur() { return g_stats; }
+
+size_t FormatSched(const SchedStats& s, char* buf, size_t cap) {
+    if (!cap) return 0;
+    if (!s.valid) {
+        buf[0] = 0;
+        return 0;
+    }
+    int n = snprintf(buf, cap, "%.1f wakeups/s  %.1f jobs each", s.wakeupsPerSec, s.jobsPerWake);
+    return n < 0 ? 0 : (size_t)n < cap ? (size_t)n : cap - 1;
+}
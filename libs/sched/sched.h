@@ -0,0 +1,55 @@
+// SysMonitor - Tick scheduler
+// Portable: shared by the Windows, macOS and Linux builds.
+// Periodic jobs (sampling, fetches) each have a period and a slack. Aligned
+// jobs fall due on wall-clock multiples of their period, so a 1 s tick
+// lands just after every second boundary and the clock never skips or
+// repeats a second. SchedNext() returns one wakeup that serves every job
+// whose window [due, due + slack] it can reach, so jobs share wakeups
+// instead of each running its own timer. The caller arms one timer:
+//   Windows  waitable timer with a tolerable delay (SetWaitableTimerEx)
+//   macOS    one-shot NSTimer with tolerance
+//   Linux    timerfd on CLOCK_REALTIME
+// One thread owns the scheduler; none of this is locked.
+#ifndef SYSMON_SCHED_H
+#define SYSMON_SCHED_H
+
+#include <cstddef>
+#include <cstdint>
+
+static const int      SCHED_MAX_JOBS = 8;
+static const uint32_t SCHED_STATS_MS = 10000;   // wakeup rate window
+
+enum SchedFlags { SCHED_ALIGNED = 1 };
+
+struct SchedWake {
+    uint64_t atMs;              // wall clock, ms since the epoch
+    uint32_t slackMs;           // the timer may fire this much later
+};
+
+struct SchedStats {
+    double wakeupsPerSec;
+    double jobsPerWake;
+    bool   valid;               // false until a full window has passed
+};
+
+// Wall clock, ms since the epoch
+uint64_t SchedWallMs();
+
+// Returns the job id (bit in SchedRun's mask), -1 when full. The first run
+// is one period from now (aligned: the next multiple of the period).
+int  SchedAdd(uint32_t periodMs, uint32_t slackMs, int flags, uint64_t nowMs);
+// Re-times a job from now; returns false (and changes nothing) if unchanged
+bool SchedSetPeriod(int id, uint32_t periodMs, uint32_t slackMs, uint64_t nowMs);
+
+// Next wakeup; at or before nowMs when something is overdue
+SchedWake SchedNext(uint64_t nowMs);
+// After a wakeup: the jobs due now as a bit mask, each advanced a period.
+// Counts the wakeup even when nothing was due.
+uint32_t  SchedRun(uint64_t nowMs);
+inline bool SchedDue(uint32_t mask, int id) { return id >= 0 && ((mask >> id) & 1); }
+
+SchedStats SchedCur();
+// "1.0 wakeups/s  1.2 jobs each"
+size_t FormatSched(const SchedStats& s, char* buf, size_t cap);
+
+#endif // SYSMON_SCHED_H
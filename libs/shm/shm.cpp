@@ -0,0 +1,136 @@
+#include "libs/shm/shm.h"
+#include "libs/shm/sysmon_shm.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+
+static_assert((int)SYSMON_UNIT_MHZ == (int)UNIT_MHZ, "unit ids are part of the layout");
+static_assert((int)SYSMON_TYPE_U64 == (int)MT_U64, "type ids are part of the layout");
+static_assert(sizeof(MetricValue) == 8, "value slots are 8 bytes");
+static_assert(offsetof(sysmon_shm_header, seq) == 48, "header layout is fixed");
+
+static sysmon_shm_header* g_shm      = nullptr;
+static uint32_t           g_shmBytes = 0;
+static void*              g_shmVals  = nullptr;
+
+#ifdef _WIN32
+static HANDLE g_shmMap = nullptr;
+#else
+static int    g_shmFd  = -1;
+#endif
+
+static uint32_t Align64(uint32_t x) { return (x + 63) & ~63u; }
+
+// Static part of the layout, written before any sample
+static void WriteLayout(sysmon_shm_header* h) {
+    uint32_t metrics = Align64(sizeof(sysmon_shm_header));
+    uint32_t values  = Align64(metrics + METRIC_COUNT * sizeof(sysmon_shm_metric));
+    uint32_t labels  = values + METRIC_SLOTS * 8;
+    uint32_t paths   = labels + METRIC_MAX_VOLS * 8;
+    memset(h, 0, g_shmBytes);
+    h->version        = SYSMON_SHM_VERSION;
+    h->size           = g_shmBytes;
+    h->metric_count   = METRIC_COUNT;
+    h->slot_count     = METRIC_SLOTS;
+    h->max_vols       = METRIC_MAX_VOLS;
+    h->metrics_offset = metrics;
+    h->values_offset  = values;
+    h->labels_offset  = labels;
+    h->paths_offset   = paths;
+#ifdef _WIN32
+    h->pid            = GetCurrentProcessId();
+#else
+    h->pid            = (uint32_t)getpid();
+#endif
+    sysmon_shm_metric* d = (sysmon_shm_metric*)((char*)h + metrics);
+    for (int i = 0; i < METRIC_COUNT; i++) {
+        strncpy(d[i].name, g_metricDesc[i].name, sizeof(d[i].name) - 1);
+        d[i].unit  = g_metricDesc[i].unit;
+        d[i].type  = g_metricDesc[i].type;
+        d[i].slots = g_metricDesc[i].slots;
+        d[i].base  = g_metricDesc[i].base;
+    }
+    g_shmVals = (char*)h + values;
+    // Magic last: a reader that sees it sees the whole layout
+    std::atomic_thread_fence(std::memory_order_release);
+    h->magic = SYSMON_SHM_MAGIC;
+}
+
+static uint32_t LayoutBytes() {
+    return Align64(sizeof(sysmon_shm_header)) + Align64(METRIC_COUNT * sizeof(sysmon_shm_metric))
+         + METRIC_SLOTS * 8 + METRIC_MAX_VOLS * (8 + 64);
+}
+
+bool ShmOpen() {
+    if (g_shm) return true;
+    g_shmBytes = LayoutBytes();
+    void* p = nullptr;
+#ifdef _WIN32
+    g_shmMap = CreateFileMappingW(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, 0, g_shmBytes,
+                                  L"Local\\SysMonitor.Snapshot");
+    if (!g_shmMap) return false;
+    p = MapViewOfFile(g_shmMap, FILE_MAP_ALL_ACCESS, 0, 0, g_shmBytes);
+    if (!p) { CloseHandle(g_shmMap); g_shmMap = nullptr; return false; }
+#else
+    g_shmFd = shm_open(SYSMON_SHM_NAME_POSIX, O_RDWR | O_CREAT, 0644);
+    if (g_shmFd < 0) return false;
+    // Two publishers would break the seqlock; the lock dies with its owner
+    if (flock(g_shmFd, LOCK_EX | LOCK_NB) != 0 && errno == EWOULDBLOCK) {
+        close(g_shmFd);
+        g_shmFd = -1;
+        return false;
+    }
+    if (ftruncate(g_shmFd, g_shmBytes) == 0)
+        p = mmap(nullptr, g_shmBytes, PROT_READ | PROT_WRITE, MAP_SHARED, g_shmFd, 0);
+    if (!p || p == MAP_FAILED) {
+        close(g_shmFd);
+        g_shmFd = -1;
+        return false;
+    }
+#endif
+    g_shm = (sysmon_shm_header*)p;
+    WriteLayout(g_shm);
+    return true;
+}
+
+void ShmClose() {
+    if (!g_shm) return;
+    g_shm->magic = 0;
+#ifdef _WIN32
+    UnmapViewOfFile(g_shm);
+    CloseHandle(g_shmMap);
+    g_shmMap = nullptr;
+#else
+    munmap(g_shm, g_shmBytes);
+    shm_unlink(SYSMON_SHM_NAME_POSIX);
+    close(g_shmFd);
+    g_shmFd = -1;
+#endif
+    g_shm = nullptr;
+    g_shmVals = nullptr;
+}
+
+void ShmPublish(const MetricSet& m, uint64_t tsMs) {
+    sysmon_shm_header* h = g_shm;
+    if (!h) return;
+    uint64_t s = h->seq;
+    h->seq = s + 1;
+    std::atomic_thread_fence(std::memory_order_release);
+    memcpy(g_shmVals, m.v, sizeof(m.v));
+    memcpy((char*)h + h->labels_offset, m.volLabel, sizeof(m.volLabel));
+    memcpy((char*)h + h->paths_offset, m.volPath, sizeof(m.volPath));
+    h->ts_ms = tsMs;
+    std::atomic_thread_fence(std::memory_order_release);
+    h->seq = s + 2;
+}
@@ -0,0 +1,22 @@
+// SysMonitor - Shared-memory snapshot publisher
+// Portable: shared by the Windows, macOS and Linux builds.
+// Publishes each sample into the named segment described by sysmon_shm.h
+// so other local tools can read the numbers without sampling again. The
+// segment is updated under a seqlock: the writer never waits on readers
+// and readers never make a syscall.
+#ifndef SYSMON_SHM_H
+#define SYSMON_SHM_H
+
+#include <cstdint>
+
+#include "libs/metrics/metrics.h"
+
+// Creates (or takes over) the segment. false if it cannot be created or,
+// on Linux/macOS, another process is already publishing.
+bool ShmOpen();
+void ShmClose();
+
+// Single writer: call from the sampling thread after each tick
+void ShmPublish(const MetricSet& m, uint64_t tsMs);
+
+#endif // SYSMON_SHM_H
@@ -0,0 +1,96 @@
+/* SysMonitor - Shared-memory snapshot reader example
+ * Prints total CPU, RAM and the fullest volume from a running SysMonitor
+ * (or `sysmon --headless`) once per second, straight from the segment.
+ *   cc -O2 -I. libs/shm/shm_reader.c -o shm_reader        (Linux: add -lrt
+ *                                                          on glibc < 2.34)
+ *   cl /O2 /I. libs\shm\shm_reader.c
+ */
+#include "libs/shm/sysmon_shm.h"
+
+#include <stdio.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#define SLEEP_1S() Sleep(1000)
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define SLEEP_1S() sleep(1)
+#endif
+
+static const sysmon_shm_header* Attach(void) {
+    void* p;
+#ifdef _WIN32
+    HANDLE map = OpenFileMappingA(FILE_MAP_READ, FALSE, SYSMON_SHM_NAME_WIN);
+    if (!map) return NULL;
+    p = MapViewOfFile(map, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(map);   /* the view keeps the section alive */
+#else
+    struct stat st;
+    int fd = shm_open(SYSMON_SHM_NAME_POSIX, O_RDONLY, 0);
+    if (fd < 0) return NULL;
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(sysmon_shm_header)) { close(fd); return NULL; }
+    p = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED) p = NULL;
+#endif
+    return (const sysmon_shm_header*)p;
+}
+
+int main(void) {
+    const sysmon_shm_header* h = Attach();
+    const sysmon_shm_metric *cpu, *ramUsed, *ramTotal, *vols, *used, *total;
+    if (!h || h->magic != SYSMON_SHM_MAGIC || h->version != SYSMON_SHM_VERSION) {
+        fprintf(stderr, "shm_reader: no SysMonitor snapshot published\n");
+        return 1;
+    }
+    /* Descriptors never change, so look them up once */
+    cpu      = sysmon_shm_find(h, "cpu.total");
+    ramUsed  = sysmon_shm_find(h, "mem.ram.used");
+    ramTotal = sysmon_shm_find(h, "mem.ram.total");
+    vols     = sysmon_shm_find(h, "disk.volumes");
+    used     = sysmon_shm_find(h, "disk.used");
+    total    = sysmon_shm_find(h, "disk.total");
+    if (!cpu || !ramUsed || !ramTotal || !vols || !used || !total) {
+        fprintf(stderr, "shm_reader: unexpected metric set\n");
+        return 1;
+    }
+
+    for (;;) {
+        double c, ru, rt, best = -1;
+        char path[64] = "";
+        uint64_t s, ts;
+        do {
+            uint32_t i, n;
+            s  = sysmon_shm_begin(h);
+            ts = h->ts_ms;
+            c  = sysmon_shm_f64(h, cpu->base);
+            ru = (double)sysmon_shm_u64(h, ramUsed->base);
+            rt = (double)sysmon_shm_u64(h, ramTotal->base);
+            n  = (uint32_t)sysmon_shm_u64(h, vols->base);
+            best = -1;
+            for (i = 0; i < n && i < h->max_vols; i++) {
+                double t = sysmon_shm_f64(h, total->base + i);
+                double pct = t > 0 ? sysmon_shm_f64(h, used->base + i) * 100.0 / t : 0;
+                if (pct > best) {
+                    best = pct;
+                    /* Strings can change under us too: copy inside the section */
+                    memcpy(path, sysmon_shm_vol_path(h, i), sizeof(path));
+                }
+            }
+        } while (sysmon_shm_retry(h, s));
+        path[sizeof(path) - 1] = 0;
+
+        if (h->magic != SYSMON_SHM_MAGIC) {
+            fprintf(stderr, "shm_reader: publisher exited\n");
+            return 0;
+        }
+        printf("%llu  cpu %5.1f%%  ram %5.1f%%", (unsigned long long)ts, c, rt > 0 ? ru * 100.0 / rt : 0);
+        if (best >= 0) printf("  %s %5.1f%%", path, best);
+        printf("\n");
+        fflush(stdout);
+        SLEEP_1S();
+    }
+}
@@ -0,0 +1,131 @@
+/* SysMonitor - Shared-memory snapshot layout (C, for external readers)
+ * The widget (and the Linux agent) publish every sample into a named
+ * shared-memory segment:
+ *   Windows      CreateFileMapping "Local\SysMonitor.Snapshot"
+ *   Linux/macOS  shm_open "/sysmonitor.snapshot"
+ * Layout, all offsets from the start of the segment:
+ *   sysmon_shm_header          at 0
+ *   sysmon_shm_metric[]        at metrics_offset, metric_count entries
+ *   value slots (8 bytes each) at values_offset, slot_count entries;
+ *                              double or uint64 per the metric's type
+ *   volume labels char[8]      at labels_offset, max_vols entries
+ *   volume paths  char[64]     at paths_offset,  max_vols entries
+ * Everything but seq and ts_ms is written once when the segment is created.
+ * A reader checks magic and version, looks metrics up by name once, then
+ * reads values in place inside a seqlock section: no copy, no syscall.
+ *
+ *   uint64_t s;
+ *   do {
+ *       s = sysmon_shm_begin(h);
+ *       cpu = sysmon_shm_f64(h, base);
+ *   } while (sysmon_shm_retry(h, s));
+ *
+ * See shm_reader.c for a complete reader.
+ */
+#ifndef SYSMON_SHM_LAYOUT_H
+#define SYSMON_SHM_LAYOUT_H
+
+#include <stdint.h>
+#include <string.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SYSMON_SHM_NAME_WIN     "Local\\SysMonitor.Snapshot"
+#define SYSMON_SHM_NAME_POSIX   "/sysmonitor.snapshot"
+#define SYSMON_SHM_MAGIC        0x314D4853u     /* "SHM1" */
+#define SYSMON_SHM_VERSION      1u
+
+enum {
+    SYSMON_UNIT_COUNT, SYSMON_UNIT_PERCENT, SYSMON_UNIT_MB, SYSMON_UNIT_GB,
+    SYSMON_UNIT_BYTES_PER_SEC, SYSMON_UNIT_WATTS, SYSMON_UNIT_SECONDS,
+    SYSMON_UNIT_CELSIUS, SYSMON_UNIT_RPM, SYSMON_UNIT_MHZ
+};
+enum { SYSMON_TYPE_F64, SYSMON_TYPE_U64 };
+
+typedef struct sysmon_shm_metric {
+    char     name[24];          /* "cpu.total", "cpu.core", ... */
+    uint32_t unit;              /* SYSMON_UNIT_* */
+    uint32_t type;              /* SYSMON_TYPE_* */
+    uint32_t slots;             /* capacity; live length is per sample */
+    uint32_t base;              /* first value slot */
+} sysmon_shm_metric;
+
+typedef struct sysmon_shm_header {
+    uint32_t magic;             /* SYSMON_SHM_MAGIC */
+    uint32_t version;           /* SYSMON_SHM_VERSION */
+    uint32_t size;              /* segment bytes */
+    uint32_t metric_count;
+    uint32_t slot_count;
+    uint32_t max_vols;
+    uint32_t metrics_offset;
+    uint32_t values_offset;
+    uint32_t labels_offset;
+    uint32_t paths_offset;
+    uint32_t pid;               /* publisher */
+    uint32_t reserved;
+    volatile uint64_t seq;      /* seqlock: odd while a sample is written */
+    volatile uint64_t ts_ms;    /* sample wall clock, ms since the Unix epoch */
+} sysmon_shm_header;
+
+/* Readers need the sequence load ordered before the data loads and the
+ * data loads before the re-check. */
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#if defined(_M_ARM64) || defined(_M_ARM)
+#define SYSMON_SHM_ACQUIRE() __dmb(_ARM64_BARRIER_ISHLD)
+#else
+#define SYSMON_SHM_ACQUIRE() _ReadWriteBarrier()
+#endif
+#else
+#define SYSMON_SHM_ACQUIRE() __atomic_thread_fence(__ATOMIC_ACQUIRE)
+#endif
+
+static inline uint64_t sysmon_shm_begin(const sysmon_shm_header* h) {
+    uint64_t s;
+    while ((s = h->seq) & 1) {}
+    SYSMON_SHM_ACQUIRE();
+    return s;
+}
+
+/* Non-zero if a sample was published meanwhile and the section must rerun */
+static inline int sysmon_shm_retry(const sysmon_shm_header* h, uint64_t s) {
+    SYSMON_SHM_ACQUIRE();
+    return h->seq != s;
+}
+
+static inline const sysmon_shm_metric* sysmon_shm_metrics(const sysmon_shm_header* h) {
+    return (const sysmon_shm_metric*)((const char*)h + h->metrics_offset);
+}
+
+/* Descriptor by name, or NULL */
+static inline const sysmon_shm_metric* sysmon_shm_find(const sysmon_shm_header* h, const char* name) {
+    const sysmon_shm_metric* m = sysmon_shm_metrics(h);
+    uint32_t i;
+    for (i = 0; i < h->metric_count; i++)
+        if (strncmp(m[i].name, name, sizeof(m[i].name)) == 0) return &m[i];
+    return NULL;
+}
+
+static inline double sysmon_shm_f64(const sysmon_shm_header* h, uint32_t slot) {
+    return ((const volatile double*)((const char*)h + h->values_offset))[slot];
+}
+
+static inline uint64_t sysmon_shm_u64(const sysmon_shm_header* h, uint32_t slot) {
+    return ((const volatile uint64_t*)((const char*)h + h->values_offset))[slot];
+}
+
+static inline const char* sysmon_shm_vol_path(const sysmon_shm_header* h, uint32_t vol) {
+    return (const char*)h + h->paths_offset + vol * 64;
+}
+
+static inline const char* sysmon_shm_vol_label(const sysmon_shm_header* h, uint32_t vol) {
+    return (const char*)h + h->labels_offset + vol * 8;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SYSMON_SHM_LAYOUT_H */
@@ -0,0 +1,263 @@
+#include "libs/sim/sim.h"
+#include "libs/linux/metrics_linux.h"
+#include "libs/trace/trace.h"
+#include "libs/battery/battery.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+static const int      USER_HZ   = 100;        // /proc/stat jiffies per second
+static const double   GB        = 1024.0 * 1024.0 * 1024.0;
+static const uint64_t BASE_KHZ  = 2400000;    // rated clock, turbo to 1.5x
+static const double   BAT_FULL_UWH = 57e6;    // a 57 Wh laptop pack
+
+struct SimCore {
+    double   base;              // steady load 0..1
+    int      burst;             // ms left at 100%
+    uint64_t t[8];              // user nice system idle iowait irq softirq steal
+    uint64_t aperf, mperf;      // cycles while not halted: actual, at base clock
+    uint64_t throttle;          // events
+};
+
+struct SimVol {
+    char     path[TRACE_STR_LEN];
+    uint64_t total, used;
+    double   growth;            // bytes per second, may be negative
+};
+
+struct SimIface {
+    char     name[TRACE_STR_LEN];
+    double   rate;              // mean bytes per second, rx
+    double   txRatio;
+    uint64_t rx, tx;
+};
+
+static SimConfig             g_cfg;
+static uint32_t              g_rng;
+static uint64_t              g_simMs;
+static std::vector<SimCore>  g_cores;
+static std::vector<SimVol>   g_vols;
+static std::vector<SimIface> g_ifaces;
+static uint64_t              g_agg[8];
+static double                g_batUwh, g_batUw;
+
+// xorshift32; uniform in [0, 1)
+static double Rand() {
+    g_rng ^= g_rng << 13;
+    g_rng ^= g_rng >> 17;
+    g_rng ^= g_rng << 5;
+    return (g_rng >> 8) * (1.0 / 16777216.0);
+}
+
+static bool SimRead(TraceSample& s) {
+    s.tickMs = g_simMs;
+    switch (s.kind) {
+    case TRACE_CPU: {
+        int n = (int)g_cores.size();
+        for (int f = 0; f < 8; f++) s.vals[f] = g_agg[f];
+        for (int i = 0; i < n; i++)
+            for (int f = 0; f < 8; f++) s.vals[(i + 1) * 8 + f] = g_cores[i].t[f];
+        s.numVals = (n + 1) * 8;
+        return true;
+    }
+    case TRACE_MEM: {
+        // 4 GB per core host, page cache swinging with the wave
+        uint64_t totalKB = (uint64_t)std::max(1, g_cfg.cores) * 4 * 1024 * 1024;
+        double   wave = 0.5 + 0.2 * sin((double)g_simMs / 600000.0 * 2 * M_PI);
+        s.vals[0] = totalKB;
+        s.vals[1] = (uint64_t)(totalKB * wave);
+        s.vals[2] = totalKB / 8;
+        s.vals[3] = totalKB / 8 - totalKB / 256;
+        s.numVals = 4;
+        return true;
+    }
+    case TRACE_DISK:
+        for (size_t i = 0; i < g_vols.size(); i++) {
+            snprintf(s.strs[i], TRACE_STR_LEN, "%s", g_vols[i].path);
+            s.vals[i * 2]     = g_vols[i].total;
+            s.vals[i * 2 + 1] = g_vols[i].total - g_vols[i].used;
+        }
+        s.numVals = (int)g_vols.size() * 2;
+        s.numStrs = (int)g_vols.size();
+        return true;
+    case TRACE_NET:
+        for (size_t i = 0; i < g_ifaces.size(); i++) {
+            snprintf(s.strs[i], TRACE_STR_LEN, "%s", g_ifaces[i].name);
+            s.vals[i * 2]     = g_ifaces[i].rx;
+            s.vals[i * 2 + 1] = g_ifaces[i].tx;
+        }
+        s.numVals = (int)g_ifaces.size() * 2;
+        s.numStrs = (int)g_ifaces.size();
+        return true;
+    case TRACE_CPUFREQ: {
+        // intel_pstate with the msr module loaded (layout as in metrics_linux.cpp)
+        int n = (int)g_cores.size();
+        s.vals[0] = BASE_KHZ;
+        for (int i = 0; i < n; i++) {
+            const SimCore& k = g_cores[i];
+            uint64_t* v = &s.vals[1 + i * 5];
+            v[0] = k.burst > 0 ? BASE_KHZ : BASE_KHZ * 3 / 2;
+            v[1] = BASE_KHZ * 3 / 2;
+            v[2] = k.throttle;
+            v[3] = k.aperf;
+            v[4] = k.mperf;
+        }
+        s.numVals = 1 + n * 5;
+        return true;
+    }
+    case TRACE_CPUTOPO: {
+        // Two SMT threads per physical core, one class
+        int n = (int)g_cores.size();
+        for (int i = 0; i < n; i++) {
+            s.vals[i * 2]     = (uint64_t)(i & ~1);
+            s.vals[i * 2 + 1] = 0;
+        }
+        s.numVals = n * 2;
+        return true;
+    }
+    case TRACE_BATTERY:
+        if (!g_cfg.battery) return true;    // servers: no battery
+        s.vals[0] = (uint64_t)(g_batUwh / BAT_FULL_UWH * 10000);
+        s.vals[1] = PSU_DISCHARGING;
+        s.vals[2] = (uint64_t)g_batUw;
+        s.vals[3] = (uint64_t)g_batUwh;
+        s.numVals = 4;
+        return true;
+    case TRACE_THERMAL: {
+        // coretemp: a package sensor per 64 cores, one per core, two fans,
+        // all tracking the cores' load (flags as in metrics_linux.cpp)
+        int n = 0, np = (int)(g_cores.size() + 63) / 64;
+        double all = 0;
+        for (const SimCore& k : g_cores) all += k.base;
+        all /= (double)g_cores.size();
+        for (int p = 0; p < np && n < TRACE_MAX_STRS; p++, n++) {
+            snprintf(s.strs[n], TRACE_STR_LEN, "coretemp Package id %d", p);
+            s.vals[n * 2]     = 2;
+            s.vals[n * 2 + 1] = (uint64_t)(38000 + 50000 * all);
+        }
+        for (size_t i = 0; i < g_cores.size() && n < TRACE_MAX_STRS; i++, n++) {
+            snprintf(s.strs[n], TRACE_STR_LEN, "coretemp Core %d", (int)i);
+            s.vals[n * 2]     = 2;
+            s.vals[n * 2 + 1] = (uint64_t)(36000 + 55000 * g_cores[i].base);
+        }
+        for (int f = 0; f < 2 && n < TRACE_MAX_STRS; f++, n++) {
+            snprintf(s.strs[n], TRACE_STR_LEN, "nct6775 fan%d", f + 1);
+            s.vals[n * 2]     = 1;
+            s.vals[n * 2 + 1] = (uint64_t)(700 + 1800 * all);
+        }
+        s.numVals = n * 2;
+        s.numStrs = n;
+        return true;
+    }
+    default:
+        return false;
+    }
+}
+
+SimConfig SimStart(const SimConfig& c) {
+    g_cfg = c;
+    g_cfg.cores  = std::max(1, std::min(c.cores, TRACE_MAX_VALS / 8 - 1));
+    g_cfg.vols   = std::max(0, std::min(c.vols, TRACE_MAX_STRS));
+    g_cfg.ifaces = std::max(1, std::min(c.ifaces, TRACE_MAX_STRS));
+    g_rng   = c.seed ? c.seed : 0x9E3779B9u;
+    g_simMs = 1000000;
+
+    g_cores.assign(g_cfg.cores, SimCore());
+    for (int i = 0; i < g_cfg.cores; i++) {
+        SimCore& k = g_cores[i];
+        // One core in 16 runs a busy service; the rest idle along
+        k.base  = (i % 16 == 0) ? 0.6 + 0.3 * Rand() : 0.02 + 0.25 * Rand();
+        k.burst = 0;
+        for (int f = 0; f < 8; f++) k.t[f] = (uint64_t)(Rand() * 1e6);
+        k.mperf    = (uint64_t)(Rand() * 1e12);
+        k.aperf    = k.mperf;
+        k.throttle = 0;
+    }
+
+    g_vols.assign(g_cfg.vols, SimVol());
+    for (int i = 0; i < g_cfg.vols; i++) {
+        SimVol& v = g_vols[i];
+        if (i == 0) snprintf(v.path, sizeof(v.path), "/");
+        else if (i % 3 == 0) snprintf(v.path, sizeof(v.path), "/var/lib/containers/storage/vol%03d", i);
+        else snprintf(v.path, sizeof(v.path), "/mnt/data%02d", i);
+        v.total  = (uint64_t)((64.0 + Rand() * 8128.0) * GB);
+        v.used   = (uint64_t)(v.total * (0.2 + 0.7 * Rand()));
+        // Most drift a few MB/min; one in ten fills at ~1 GB/min
+        v.growth = (i % 10 == 7) ? GB / 60.0 : (Rand() - 0.4) * 100000.0;
+    }
+
+    g_ifaces.assign(g_cfg.ifaces, SimIface());
+    for (int i = 0; i < g_cfg.ifaces; i++) {
+        SimIface& f = g_ifaces[i];
+        if (i == 0)      { snprintf(f.name, sizeof(f.name), "lo");   f.rate = 2e5; }
+        else if (i == 1) { snprintf(f.name, sizeof(f.name), "eth0"); f.rate = 4e7; }
+        else if (i % 20 == 2) { snprintf(f.name, sizeof(f.name), "br-%08x", g_rng); f.rate = 1e6 * Rand(); }
+        else { snprintf(f.name, sizeof(f.name), "veth%07x", g_rng & 0xFFFFFFF); f.rate = 5e4 * Rand() * Rand(); }
+        f.txRatio = 0.2 + 0.8 * Rand();
+        f.rx = (uint64_t)(Rand() * 1e12);
+        f.tx = (uint64_t)(Rand() * 1e12);
+    }
+
+    g_batUwh = BAT_FULL_UWH * (0.5 + 0.4 * Rand());
+    g_batUw  = 0;
+
+    SimStep(0);
+    SetRawSource(SimRead);
+    return g_cfg;
+}
+
+void SimStop() {
+    SetRawSource(nullptr);
+    g_cores.clear();
+    g_vols.clear();
+    g_ifaces.clear();
+}
+
+void SimStep(uint32_t ms) {
+    g_simMs += ms;
+    double dt = ms / 1000.0;
+    double wave = 0.15 * sin((double)g_simMs / 300000.0 * 2 * M_PI);
+
+    for (int f = 0; f < 8; f++) g_agg[f] = 0;
+    double all = 0;
+    for (SimCore& k : g_cores) {
+        if (k.burst <= 0 && Rand() < 0.02 * dt) k.burst = (int)(5000 + Rand() * 55000);
+        double load = k.burst > 0 ? 1.0 : std::min(1.0, std::max(0.0, k.base + wave + 0.1 * (Rand() - 0.5)));
+        if (k.burst > 0) k.burst -= (int)ms;
+        double jiffies = USER_HZ * dt;
+        double busy = jiffies * load, idle = jiffies - busy;
+        // Fractional jiffies round the way the kernel's counters would drift
+        k.t[0] += (uint64_t)(busy * 0.70 + Rand());
+        k.t[2] += (uint64_t)(busy * 0.25 + Rand());
+        k.t[6] += (uint64_t)(busy * 0.05 + Rand());
+        k.t[3] += (uint64_t)(idle * 0.97 + Rand());
+        k.t[4] += (uint64_t)(idle * 0.03 + Rand());
+        // Turbo while lightly loaded; a pinned burst runs at base and now
+        // and then trips the thermal limit
+        uint64_t m = (uint64_t)(BASE_KHZ * 1000.0 * dt * load);
+        k.mperf += m;
+        k.aperf += k.burst > 0 ? m : m * 3 / 2;
+        if (k.burst > 0 && Rand() < 0.1 * dt) k.throttle++;
+        for (int f = 0; f < 8; f++) g_agg[f] += k.t[f];
+        all += load;
+    }
+
+    // 4 W idle up to 30 W with every core busy
+    g_batUw  = (4.0 + 26.0 * all / (double)g_cores.size()) * 1e6;
+    g_batUwh = std::max(0.0, g_batUwh - g_batUw * dt / 3600.0);
+
+    for (SimVol& v : g_vols) {
+        double d = v.growth * dt;
+        if (d > 0) v.used = std::min(v.total, v.used + (uint64_t)d);
+        else       v.used -= std::min(v.used, (uint64_t)-d);
+    }
+
+    for (SimIface& f : g_ifaces) {
+        // Heavy-tailed: mostly near the mean, now and then a 20x burst
+        double r = f.rate * (Rand() < 0.01 ? 20.0 : 0.5 + Rand());
+        f.rx += (uint64_t)(r * dt);
+        f.tx += (uint64_t)(r * f.txRatio * dt);
+    }
+}
@@ -0,0 +1,29 @@
+// SysMonitor - Synthetic host (fake Linux backend)
+// Generates raw /proc-style inputs for any number of cores, volumes and
+// network interfaces and installs itself as the raw source of the Linux
+// backend (SetRawSource), so the real Update* code runs against hosts far
+// larger than the one at hand. Load is deterministic for a given seed:
+//   cores   per-core base load + a slow shared wave + random pinned bursts
+//   volumes mixed sizes (64 GB - 8 TB), slow fill, a few fast growers
+//   ifaces  lo, a busy uplink, bridges and many mostly idle veths
+//   battery none (a server), or a laptop pack draining with the load
+// Time only moves with SimStep, so rates come out exact.
+#ifndef SYSMON_SIM_H
+#define SYSMON_SIM_H
+
+#include <cstdint>
+
+struct SimConfig {
+    int      cores, vols, ifaces;
+    uint32_t seed;
+    bool     battery;
+};
+
+// Clamps the counts to what a raw sample can carry; returns the config used
+SimConfig SimStart(const SimConfig& c);
+void      SimStop();
+
+// Advances the simulated clock, accumulating counters
+void      SimStep(uint32_t ms);
+
+#endif // SYSMON_SIM_H
@@ -0,0 +1,65 @@
+#include "libs/thermal/thermal.h"
+#include "libs/metrics/metrics.h"
+
+#include <pdh.h>
+#include <pdhmsg.h>
+
+static PDH_HQUERY   g_query = nullptr;
+static PDH_HCOUNTER g_zone[METRIC_MAX_TEMPS];
+static char         g_label[METRIC_MAX_TEMPS][32];
+static bool         g_isCpu[METRIC_MAX_TEMPS];
+static int          g_numZones = 0;
+
+static const wchar_t* ZONE_PATH = L"\\Thermal Zone Information(*)\\Temperature";
+
+void InitThermal() {
+    if (g_query || PdhOpenQueryW(nullptr, 0, &g_query) != ERROR_SUCCESS) return;
+    // The wildcard is expanded here, once, into one counter per zone
+    DWORD cch = 0;
+    if (PdhExpandWildCardPathW(nullptr, ZONE_PATH, nullptr, &cch, 0) != PDH_MORE_DATA || !cch) return;
+    std::vector<wchar_t> paths(cch);
+    if (PdhExpandWildCardPathW(nullptr, ZONE_PATH, paths.data(), &cch, 0) != ERROR_SUCCESS) return;
+    for (const wchar_t* p = paths.data(); *p && g_numZones < METRIC_MAX_TEMPS; p += wcslen(p) + 1) {
+        if (PdhAddCounterW(g_query, p, 0, &g_zone[g_numZones]) != ERROR_SUCCESS) continue;
+        // "\Thermal Zone Information(\_TZ.CPUZ)\Temperature" -> "acpi CPUZ"
+        const wchar_t* a = wcschr(p + 1, L'(');
+        const wchar_t* b = a ? wcschr(a, L')') : nullptr;
+        char name[32] = "";
+        if (a && b) {
+            const wchar_t* dot = wcschr(a, L'.');
+            if (dot && dot < b) a = dot;
+            WideCharToMultiByte(CP_UTF8, 0, a + 1, (int)(b - a - 1), name, sizeof(name) - 1, nullptr, nullptr);
+        }
+        snprintf(g_label[g_numZones], sizeof(g_label[0]), "acpi %s", name);
+        g_isCpu[g_numZones] = strstr(name, "CPU") != nullptr;
+        g_numZones++;
+    }
+    PdhCollectQueryData(g_query);
+}
+
+void UpdateThermal() {
+    int n = 0;
+    double cpu = -1;
+    if (g_query && g_numZones && PdhCollectQueryData(g_query) == ERROR_SUCCESS) {
+        for (int i = 0; i < g_numZones; i++) {
+            PDH_FMT_COUNTERVALUE v;
+            if (PdhGetFormattedCounterValue(g_zone[i], PDH_FMT_DOUBLE, nullptr, &v) != ERROR_SUCCESS ||
+                v.CStatus != PDH_CSTATUS_VALID_DATA)
+                continue;
+            double c = v.doubleValue - 273.15;          // Kelvin
+            if (g_isCpu[i] && c > cpu) cpu = c;
+            g_metrics.SetF(METRIC_TEMP, c, n);
+            memcpy(g_metrics.tempLabel[n], g_label[i], sizeof(g_label[i]));
+            n++;
+        }
+    }
+    g_metrics.SetF(METRIC_THERM_CPU, cpu);
+    g_metrics.SetU(METRIC_TEMP_COUNT, (uint64_t)n);
+    g_metrics.SetU(METRIC_FAN_COUNT, 0);
+}
+
+void CleanupThermal() {
+    if (g_query) PdhCloseQuery(g_query);
+    g_query    = nullptr;
+    g_numZones = 0;
+}
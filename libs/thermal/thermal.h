@@ -0,0 +1,15 @@
+// SysMonitor - Temperatures (Windows)
+// ACPI thermal zones through the "Thermal Zone Information" performance
+// counters, which need neither a driver nor elevation. The zones are
+// looked up once in InitThermal, one counter each; a tick is a single
+// PdhCollectQueryData. Fans aren't exposed this way, so thermal.fans is 0.
+#ifndef SYSMON_THERMAL_H
+#define SYSMON_THERMAL_H
+
+#include "libs/globals/globals.h"
+
+void InitThermal();
+void UpdateThermal();
+void CleanupThermal();
+
+#endif
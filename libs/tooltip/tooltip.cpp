@@ -1,6 +1,8 @@
 #include "libs/tooltip/tooltip.h"
 #include "libs/util/util.h"
 #include "libs/layout/layout.h"
+#include "libs/sampler/sampler.h"
+#include "libs/topology/topology.h"
 
 void InitTip(HWND parent) {
     INITCOMMONCONTROLSEX ic = { sizeof(ic), ICC_WIN95_CLASSES };
@@ -20,32 +22,24 @@ void InitTip(HWND parent) {
     SendMessageW(g_tip, TTM_SETMAXTIPWIDTH, 0, 300);
 }
 
+// The strip is in topology order (libs/topology); returns the logical core
 int HitTestCore(int cx, int cy) {
-    float cpuX = (float)(BAR_PAD + SEC_TIME_W + 16);
-    float blockY = 44.f;
-    for (int i = 0; i < g_numCores; i++) {
-        float bx = cpuX + i * 10.f;
-        if (cx >= (int)bx && cx < (int)(bx + 8) &&
-            cy >= (int)blockY && cy < (int)(blockY + 18))
-            return i;
-    }
-    return -1;
+    int k;
+    if (LayoutHitTest(CurLayout(), (float)cx, (float)cy, &k) != HIT_CORE) return -1;
+    int order[128];
+    uint8_t flags[128];
+    int n = TopoOrder(CurSnapshot().m, order, flags);
+    return k < n ? order[k] : -1;
 }
 
 int HitTestVol(int cx, int cy) {
-    float diskX = (float)(BAR_PAD + SEC_TIME_W + 16 + CalcCpuSecW() + 16
-                          + SEC_MEM_W + 16);
-    float colW = (float)SEC_DISK_COL_W;
-    for (int v = 0; v < g_numVols; v++) {
-        int col = v / 2;
-        int row = v % 2;
-        float rx = diskX + col * colW;
-        float ry = (row == 0) ? 9.f : 42.f;
-        if (cx >= (int)rx && cx < (int)(rx + colW) &&
-            cy >= (int)ry && cy < (int)(ry + 24))
-            return v;
-    }
-    return -1;
+    int v;
+    return LayoutHitTest(CurLayout(), (float)cx, (float)cy, &v) == HIT_VOL ? v : -1;
+}
+
+int HitTestSensor(int cx, int cy) {
+    int i;
+    return LayoutHitTest(CurLayout(), (float)cx, (float)cy, &i) == HIT_SENSOR ? i : -1;
 }
 
 void ShowTip(HWND hw, const wchar_t* text) {
@@ -72,20 +66,55 @@ void HideTip(HWND hw) {
 
 void UpdateTip(HWND hw) {
     if (!g_tip) return;
-    wchar_t buf[256];
-    if (g_hovCore >= 0) {
-        swprintf_s(buf, L"Core %d: %.1f%%", g_hovCore, g_coreUse[g_hovCore]);
+    const Snapshot& s = CurSnapshot();
+    wchar_t buf[384];
+    if (g_hovCore >= 0 && g_hovCore < s.m.Cores()) {
+        int c = g_hovCore;
+        const RollupStats& w = s.coreWin[c];
+        bool hybrid = s.m.F(METRIC_CPU_ECORES) >= 0;
+        int sib = -1;
+        for (int j = 0; j < s.m.Cores() && sib < 0; j++)
+            if (j != c && s.m.U(METRIC_CPU_PHYS, j) == s.m.U(METRIC_CPU_PHYS, c)) sib = j;
+        int len = swprintf_s(buf, L"Core %d%s: %.1f%%", c,
+                             !hybrid ? L"" : TopoPerfCore(s.m, c) ? L" (P-core)" : L" (E-core)",
+                             s.m.F(METRIC_CPU_CORE, c));
+        if (sib >= 0 && len > 0)
+            len += swprintf_s(buf + len, _countof(buf) - len, L"\nSMT sibling: core %d at %.1f%%",
+                              sib, s.m.F(METRIC_CPU_CORE, sib));
+        if (hybrid && len > 0)
+            len += swprintf_s(buf + len, _countof(buf) - len, L"\nP-cores %.1f%%, E-cores %.1f%%",
+                              s.m.F(METRIC_CPU_PCORES), s.m.F(METRIC_CPU_ECORES));
+        double f = s.m.F(METRIC_CPU_FREQ, c), fmax = s.m.F(METRIC_CPU_FREQ_MAX, c);
+        if (f > 0 && len > 0)
+            len += fmax > 0
+                ? swprintf_s(buf + len, _countof(buf) - len, L"\nClock: %.2f GHz (%.0f%% of %.2f GHz)",
+                             f / 1000, f * 100 / fmax, fmax / 1000)
+                : swprintf_s(buf + len, _countof(buf) - len, L"\nClock: %.2f GHz", f / 1000);
+        if (s.m.F(METRIC_CPU_THROTTLE, c) >= 0 && len > 0)
+            len += swprintf_s(buf + len, _countof(buf) - len, L"\nThrottle events: %.0f", s.m.F(METRIC_CPU_THROTTLE, c));
+        if (w.count && len > 0)
+            swprintf_s(buf + len, _countof(buf) - len, L"\n15 min: avg %.1f%%, max %.1f%%\nCPU p95 (15 min): %.0f%%",
+                       w.avg, w.max, s.cpuP95);
         ShowTip(hw, buf);
-    } else if (g_hovVol >= 0 && g_hovVol < g_numVols) {
+    } else if (g_hovVol >= 0 && g_hovVol < s.m.Vols()) {
+        double usedGB  = s.m.F(METRIC_DISK_USED,  g_hovVol);
+        double totalGB = s.m.F(METRIC_DISK_TOTAL, g_hovVol);
         wchar_t uB[16], tB[16], fB[16];
-        double freeGB = g_vols[g_hovVol].totalGB - g_vols[g_hovVol].usedGB;
-        FmtDisk(g_vols[g_hovVol].usedGB, uB, 16);
-        FmtDisk(g_vols[g_hovVol].totalGB, tB, 16);
-        FmtDisk(freeGB, fB, 16);
-        double pct = g_vols[g_hovVol].totalGB > 0
-            ? g_vols[g_hovVol].usedGB * 100.0 / g_vols[g_hovVol].totalGB : 0;
-        swprintf_s(buf, L"Volume %c:\nUsed: %s / %s (%.1f%%)\nFree: %s",
-                   g_vols[g_hovVol].letter, uB, tB, pct, fB);
+        FmtDisk(usedGB, uB, 16);
+        FmtDisk(totalGB, tB, 16);
+        FmtDisk(totalGB - usedGB, fB, 16);
+        swprintf_s(buf, L"Volume %hs\nUsed: %s / %s (%.1f%%)\nFree: %s",
+                   s.m.volLabel[g_hovVol], uB, tB, s.m.VolPct(g_hovVol), fB);
+        ShowTip(hw, buf);
+    } else if (g_hovSensor >= 0 && g_hovSensor < ThermCells(s.m)) {
+        int t = g_hovSensor, n = s.m.Temps() + s.m.Fans() - ThermCells(s.m);
+        int len = t < s.m.Temps()
+            ? swprintf_s(buf, L"%hs: %.1f \u00B0C", s.m.tempLabel[t], s.m.F(METRIC_TEMP, t))
+            : swprintf_s(buf, L"%hs: %.0f rpm", s.m.fanLabel[t - s.m.Temps()],
+                         s.m.F(METRIC_FAN, t - s.m.Temps()));
+        if (s.m.F(METRIC_THERM_CPU) >= 0 && len > 0)
+            len += swprintf_s(buf + len, _countof(buf) - len, L"\nCPU (hottest): %.1f \u00B0C", s.m.F(METRIC_THERM_CPU));
+        if (n > 0 && len > 0) swprintf_s(buf + len, _countof(buf) - len, L"\n%d more in the exporter", n);
         ShowTip(hw, buf);
     }
 }
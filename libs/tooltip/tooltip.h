@@ -6,6 +6,7 @@
 void InitTip(HWND parent);
 int HitTestCore(int cx, int cy);
 int HitTestVol(int cx, int cy);
+int HitTestSensor(int cx, int cy);
 void ShowTip(HWND hw, const wchar_t* text);
 void HideTip(HWND hw);
 void UpdateTip(HWND hw);
@@ -0,0 +1,43 @@
+#include "libs/topology/topology.h"
+
+#include <algorithm>
+
+static uint64_t TopClass(const MetricSet& m) {
+    uint64_t top = 0;
+    for (int i = 0; i < m.Cores(); i++) top = std::max(top, m.U(METRIC_CPU_CLASS, i));
+    return top;
+}
+
+void TopoAggregate(MetricSet& m) {
+    uint64_t top = TopClass(m);
+    double p = 0, e = 0;
+    int np = 0, ne = 0;
+    for (int i = 0; i < m.Cores(); i++) {
+        if (m.U(METRIC_CPU_CLASS, i) == top) { p += m.F(METRIC_CPU_CORE, i); np++; }
+        else                                  { e += m.F(METRIC_CPU_CORE, i); ne++; }
+    }
+    m.SetF(METRIC_CPU_PCORES, np ? p / np : 0);
+    m.SetF(METRIC_CPU_ECORES, ne ? e / ne : -1);
+}
+
+int TopoOrder(const MetricSet& m, int* order, uint8_t* flags) {
+    int n = m.Cores();
+    for (int i = 0; i < n; i++) order[i] = i;
+    std::sort(order, order + n, [&m](int a, int b) {
+        uint64_t ca = m.U(METRIC_CPU_CLASS, a), cb = m.U(METRIC_CPU_CLASS, b);
+        if (ca != cb) return ca > cb;
+        uint64_t pa = m.U(METRIC_CPU_PHYS, a), pb = m.U(METRIC_CPU_PHYS, b);
+        return pa != pb ? pa < pb : a < b;
+    });
+    for (int k = 0; k < n; k++) {
+        int c = order[k];
+        flags[k] = 0;
+        if (k + 1 < n && m.U(METRIC_CPU_PHYS, order[k + 1]) == m.U(METRIC_CPU_PHYS, c)) flags[k] |= TOPO_SIBLING;
+        if (k > 0 && m.U(METRIC_CPU_CLASS, order[k - 1]) != m.U(METRIC_CPU_CLASS, c)) flags[k] |= TOPO_CLASS;
+    }
+    return n;
+}
+
+bool TopoPerfCore(const MetricSet& m, int i) {
+    return m.U(METRIC_CPU_CLASS, i) == TopClass(m);
+}
@@ -0,0 +1,35 @@
+// SysMonitor - CPU topology
+// Portable: shared by the Windows, macOS and Linux builds.
+// The CPU backends fill, once at start, per logical core:
+//   cpu.phys    first logical core on the same physical core (SMT siblings
+//               share it)
+//   cpu.class   efficiency class, 0 = most efficient; the highest class
+//               present is the performance cores
+// From those this derives, every sample:
+//   cpu.pcores  mean usage of the performance cores
+//   cpu.ecores  mean usage of all the other classes (-1: a single class)
+// and a display order for the core strip: performance cores first, then
+// by physical core, so SMT siblings sit next to each other.
+#ifndef SYSMON_TOPOLOGY_H
+#define SYSMON_TOPOLOGY_H
+
+#include <cstdint>
+
+#include "libs/metrics/metrics.h"
+
+enum TopoSlotFlags {
+    TOPO_SIBLING = 1,           // shares its physical core with the next slot
+    TOPO_CLASS   = 2,           // first slot of a lower efficiency class
+};
+
+// Sampling thread, after cpu.core is written
+void TopoAggregate(MetricSet& m);
+
+// Logical core shown in each slot, and TOPO_* flags per slot. Returns the
+// core count.
+int  TopoOrder(const MetricSet& m, int* order, uint8_t* flags);
+
+// Class of core i counts as the performance cores (true on a single class)
+bool TopoPerfCore(const MetricSet& m, int i);
+
+#endif // SYSMON_TOPOLOGY_H
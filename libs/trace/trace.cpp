@@ -0,0 +1,162 @@
+#include "libs/trace/trace.h"
+
+#include <cstdio>
+#include <cstring>
+
+static const uint32_t TRACE_MAGIC   = 0x31544D53;     // "SMT1"
+static const uint16_t TRACE_VERSION = 1;
+
+enum TraceMode { MODE_OFF, MODE_RECORD, MODE_REPLAY };
+
+static FILE*     g_file = nullptr;
+static TraceMode g_mode = MODE_OFF;
+static uint64_t  g_prevTick;
+// Delta bases, shared by writer and reader (only one mode at a time)
+static uint64_t  g_prevVals[TRACE_KIND_COUNT][TRACE_MAX_VALS];
+static char      g_prevStrs[TRACE_KIND_COUNT][TRACE_MAX_STRS][TRACE_STR_LEN];
+static uint8_t   g_buf[TRACE_MAX_VALS * 10 + TRACE_MAX_STRS * (TRACE_STR_LEN + 2) + 32];
+
+static void Reset() {
+    g_prevTick = 0;
+    memset(g_prevVals, 0, sizeof(g_prevVals));
+    memset(g_prevStrs, 0, sizeof(g_prevStrs));
+}
+
+static uint8_t* PutVar(uint8_t* p, uint64_t v) {
+    while (v >= 0x80) { *p++ = (uint8_t)(v | 0x80); v >>= 7; }
+    *p++ = (uint8_t)v;
+    return p;
+}
+
+static bool GetVar(FILE* f, uint64_t& v) {
+    v = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        int c = getc(f);
+        if (c == EOF) return false;
+        v |= (uint64_t)(c & 0x7F) << shift;
+        if (!(c & 0x80)) return true;
+    }
+    return false;
+}
+
+static uint64_t ZigZag(int64_t d)   { return ((uint64_t)d << 1) ^ (uint64_t)(d >> 63); }
+static int64_t  UnZigZag(uint64_t z) { return (int64_t)(z >> 1) ^ -(int64_t)(z & 1); }
+
+bool TraceStartRecord(const char* path) {
+    TraceClose();
+    g_file = fopen(path, "wb");
+    if (!g_file) return false;
+    setvbuf(g_file, nullptr, _IOFBF, 1 << 16);
+    uint32_t magic = TRACE_MAGIC;
+    uint16_t hdr[2] = { TRACE_VERSION, 0 };
+    fwrite(&magic, sizeof(magic), 1, g_file);
+    fwrite(hdr, sizeof(hdr), 1, g_file);
+    Reset();
+    g_mode = MODE_RECORD;
+    return true;
+}
+
+bool TraceStartReplay(const char* path) {
+    TraceClose();
+    g_file = fopen(path, "rb");
+    if (!g_file) return false;
+    setvbuf(g_file, nullptr, _IOFBF, 1 << 16);
+    uint32_t magic = 0;
+    uint16_t hdr[2] = {};
+    if (fread(&magic, sizeof(magic), 1, g_file) != 1 || fread(hdr, sizeof(hdr), 1, g_file) != 1 ||
+        magic != TRACE_MAGIC || hdr[0] != TRACE_VERSION) {
+        fclose(g_file);
+        g_file = nullptr;
+        return false;
+    }
+    Reset();
+    g_mode = MODE_REPLAY;
+    return true;
+}
+
+void TraceClose() {
+    if (g_file) fclose(g_file);
+    g_file = nullptr;
+    g_mode = MODE_OFF;
+}
+
+bool TraceRecording() { return g_mode == MODE_RECORD; }
+bool TraceReplaying() { return g_mode == MODE_REPLAY; }
+
+void TraceWrite(const TraceSample& s) {
+    if (g_mode != MODE_RECORD || s.kind == 0 || s.kind >= TRACE_KIND_COUNT) return;
+    int nv = s.numVals < TRACE_MAX_VALS ? s.numVals : TRACE_MAX_VALS;
+    int ns = s.numStrs < TRACE_MAX_STRS ? s.numStrs : TRACE_MAX_STRS;
+    uint64_t* prev = g_prevVals[s.kind];
+
+    uint8_t* p = g_buf;
+    *p++ = s.kind;
+    p = PutVar(p, ZigZag((int64_t)(s.tickMs - g_prevTick)));
+    g_prevTick = s.tickMs;
+    p = PutVar(p, (uint64_t)nv);
+    for (int i = 0; i < nv; i++) {
+        p = PutVar(p, ZigZag((int64_t)(s.vals[i] - prev[i])));
+        prev[i] = s.vals[i];
+    }
+    p = PutVar(p, (uint64_t)ns);
+    for (int i = 0; i < ns; i++) {
+        char* ps = g_prevStrs[s.kind][i];
+        size_t len = strnlen(s.strs[i], TRACE_STR_LEN - 1);
+        if (strncmp(ps, s.strs[i], TRACE_STR_LEN) == 0 && ps[len] == 0) {
+            *p++ = 0;
+            continue;
+        }
+        p = PutVar(p, len + 1);
+        memcpy(p, s.strs[i], len);
+        p += len;
+        memcpy(ps, s.strs[i], len);
+        ps[len] = 0;
+    }
+    fwrite(g_buf, 1, (size_t)(p - g_buf), g_file);
+}
+
+void TraceTick(uint64_t tickMs, uint64_t wallMs) {
+    if (g_mode != MODE_RECORD) return;
+    static TraceSample s;
+    s.kind = TRACE_TICK;
+    s.tickMs = tickMs;
+    s.numVals = 1;
+    s.vals[0] = wallMs;
+    s.numStrs = 0;
+    TraceWrite(s);
+    fflush(g_file);
+}
+
+bool TraceNext(TraceSample& s) {
+    if (g_mode != MODE_REPLAY) return false;
+    int kind = getc(g_file);
+    if (kind <= 0 || kind >= TRACE_KIND_COUNT) return false;
+    uint64_t v, n;
+    s.kind = (uint8_t)kind;
+    if (!GetVar(g_file, v)) return false;
+    g_prevTick += (uint64_t)UnZigZag(v);
+    s.tickMs = g_prevTick;
+
+    if (!GetVar(g_file, n) || n > (uint64_t)TRACE_MAX_VALS) return false;
+    s.numVals = (int)n;
+    uint64_t* prev = g_prevVals[kind];
+    for (int i = 0; i < s.numVals; i++) {
+        if (!GetVar(g_file, v)) return false;
+        prev[i] += (uint64_t)UnZigZag(v);
+        s.vals[i] = prev[i];
+    }
+
+    if (!GetVar(g_file, n) || n > (uint64_t)TRACE_MAX_STRS) return false;
+    s.numStrs = (int)n;
+    for (int i = 0; i < s.numStrs; i++) {
+        char* ps = g_prevStrs[kind][i];
+        if (!GetVar(g_file, v) || v > (uint64_t)TRACE_STR_LEN) return false;
+        if (v > 0) {
+            size_t len = (size_t)v - 1;
+            if (fread(ps, 1, len, g_file) != len) return false;
+            ps[len] = 0;
+        }
+        memcpy(s.strs[i], ps, TRACE_STR_LEN);
+    }
+    return true;
+}
@@ -0,0 +1,58 @@
+// SysMonitor - Raw counter trace (record / replay)
+// Portable. Records the raw backend inputs of every tick (per-core jiffies,
+// per-interface octets, volume sizes, meminfo, battery, sensors, clocks) so
+// a trace taken on a production host can be fed back through the same
+// computation later, as fast as the CPU allows and with identical results.
+// File: "SMT1" magic + version, then one record per backend read:
+//   kind u8, tick delta varint, numVals varint, values as zigzag varint
+//   deltas from the previous record of the same kind, numStrs varint,
+//   strings as varint (len + 1) + bytes, or 0 = same as previous.
+// Counters move little between ticks, so most values take one or two bytes.
+#ifndef SYSMON_TRACE_H
+#define SYSMON_TRACE_H
+
+#include <cstdint>
+
+enum TraceKind {
+    TRACE_TICK = 1,     // end of a tick: vals[0] = wall clock ms
+    TRACE_CPU,          // 8 jiffy fields (user..steal) per /proc/stat cpu line
+    TRACE_MEM,          // MemTotal MemAvailable SwapTotal SwapFree, kB
+    TRACE_DISK,         // total, avail bytes per volume; strs = mount points
+    TRACE_NET,          // rx, tx bytes per interface; strs = interface names
+    TRACE_BATTERY,      // capacity * 100, PsuState, uW, uWh (-1: absent); none if no battery
+    TRACE_THERMAL,      // flags, millidegrees C or rpm per sensor; strs = sensor labels
+    TRACE_CPUFREQ,      // base kHz, then cur kHz, max kHz, throttle events, APERF, MPERF per core
+    TRACE_CPUTOPO,      // first sibling's index, efficiency class per core; once, at start
+    TRACE_KIND_COUNT
+};
+
+static const int TRACE_MAX_VALS = 8192;     // 1023 cpu lines of 8 fields
+static const int TRACE_MAX_STRS = 512;
+static const int TRACE_STR_LEN  = 64;
+
+struct TraceSample {
+    uint8_t  kind;
+    uint64_t tickMs;            // monotonic clock when the input was read
+    int      numVals, numStrs;
+    uint64_t vals[TRACE_MAX_VALS];
+    char     strs[TRACE_MAX_STRS][TRACE_STR_LEN];
+};
+
+// Creates/truncates path and starts writing. false if it cannot be opened.
+bool TraceStartRecord(const char* path);
+// Opens path for TraceNext(). false if missing or not a trace.
+bool TraceStartReplay(const char* path);
+void TraceClose();
+
+bool TraceRecording();
+bool TraceReplaying();
+
+// No-op unless recording
+void TraceWrite(const TraceSample& s);
+// Writes the TRACE_TICK marker and flushes the tick to disk
+void TraceTick(uint64_t tickMs, uint64_t wallMs);
+
+// Next record in file order; false at the end or on a damaged record
+bool TraceNext(TraceSample& s);
+
+#endif // SYSMON_TRACE_H
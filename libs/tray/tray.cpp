@@ -1,4 +1,7 @@
 #include "libs/tray/tray.h"
+#include "libs/perf/perf.h"
+#include "libs/sampler/sampler.h"
+#include "libs/rates/rates.h"
 #include <cmath>
 
 static HICON MakeTrayIcon() {
@@ -50,6 +53,15 @@ void AddTray(HWND hw) {
     Shell_NotifyIcon(NIM_ADD, &g_nid);
 }
 
+void ShowTrayBalloon(const wchar_t* title, const wchar_t* text) {
+    NOTIFYICONDATA n = g_nid;
+    n.uFlags      = NIF_INFO;
+    n.dwInfoFlags = NIIF_WARNING;
+    wcsncpy_s(n.szInfoTitle, title, _TRUNCATE);
+    wcsncpy_s(n.szInfo, text, _TRUNCATE);
+    Shell_NotifyIcon(NIM_MODIFY, &n);
+}
+
 void RemoveTray() {
     Shell_NotifyIcon(NIM_DELETE, &g_nid);
     if (g_trayIcon) DestroyIcon(g_trayIcon);
@@ -70,6 +82,47 @@ void ShowTrayMenu(HWND hw) {
     }
     AppendMenuW(m, MF_STRING | (autoOn ? MF_CHECKED : 0), IDM_AUTOSTART, L"Start with Windows");
     AppendMenuW(m, MF_SEPARATOR, 0, nullptr);
+    wchar_t frames[96];
+    swprintf_s(frames, L"Frames: %llu drawn, %llu skipped", g_framesDrawn, g_framesSkipped);
+    AppendMenuW(m, MF_STRING | MF_DISABLED, 0, frames);
+
+    HMENU tm = CreatePopupMenu();
+    for (int s = 0; s < PERF_STAGE_COUNT; s++) {
+        double p50, p99;
+        if (!PerfPercentiles(s, p50, p99)) continue;
+        wchar_t line[64];
+        swprintf_s(line, L"%hs\t%.1f / %.1f \u00B5s", PerfStageName(s), p50, p99);
+        AppendMenuW(tm, MF_STRING | MF_DISABLED, 0, line);
+    }
+    // Our own overhead, and what the budget last made us give up
+    const Snapshot& snap = CurSnapshot();
+    char self[96];
+    if (FormatFootprint(snap.self, self, sizeof(self))) {
+        wchar_t line[160];
+        AppendMenuW(tm, MF_SEPARATOR, 0, nullptr);
+        swprintf_s(line, L"Self: %hs", self);
+        AppendMenuW(tm, MF_STRING | MF_DISABLED, 0, line);
+        if (snap.shedNote[0]) {
+            swprintf_s(line, L"Budget: %hs", snap.shedNote);
+            AppendMenuW(tm, MF_STRING | MF_DISABLED, 0, line);
+        }
+    }
+    char rates[160];
+    if (FormatRates(rates, sizeof(rates))) {
+        wchar_t line[192];
+        swprintf_s(line, L"Multi-rate: %hs", rates);
+        AppendMenuW(tm, MF_STRING | MF_DISABLED, 0, line);
+    }
+    char sched[64];
+    if (FormatSched(snap.sched, sched, sizeof(sched))) {
+        wchar_t line[96];
+        swprintf_s(line, L"Timer: %hs", sched);
+        AppendMenuW(tm, MF_STRING | MF_DISABLED, 0, line);
+    }
+    AppendMenuW(tm, MF_SEPARATOR, 0, nullptr);
+    AppendMenuW(tm, MF_STRING, IDM_DUMPTIMING, L"Dump to File");
+    AppendMenuW(m, MF_POPUP, (UINT_PTR)tm, L"Timing (p50 / p99)");
+    AppendMenuW(m, MF_SEPARATOR, 0, nullptr);
     AppendMenuW(m, MF_STRING, IDM_EXIT, L"Exit");
 
     SetForegroundWindow(hw);
@@ -77,6 +130,23 @@ void ShowTrayMenu(HWND hw) {
     DestroyMenu(m);
 }
 
+// Writes the per-stage timing table to %TEMP% and opens it
+void DumpTiming() {
+    wchar_t path[MAX_PATH];
+    DWORD n = GetTempPathW(MAX_PATH, path);
+    if (n == 0 || n > MAX_PATH - 32) return;
+    wcscat_s(path, L"SysMonitor-timing.txt");
+
+    std::string rep = PerfReport();
+    HANDLE f = CreateFileW(path, GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS,
+                           FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (f == INVALID_HANDLE_VALUE) return;
+    DWORD wr = 0;
+    WriteFile(f, rep.data(), (DWORD)rep.size(), &wr, nullptr);
+    CloseHandle(f);
+    ShellExecuteW(nullptr, L"open", path, nullptr, nullptr, SW_SHOWNORMAL);
+}
+
 void ToggleAutoStart() {
     HKEY key;
     if (RegOpenKeyExW(HKEY_CURRENT_USER, REG_RUN, 0, KEY_ALL_ACCESS, &key) != ERROR_SUCCESS)
@@ -6,6 +6,9 @@
 void AddTray(HWND hw);
 void RemoveTray();
 void ShowTrayMenu(HWND hw);
+// Balloon notification from the tray icon
+void ShowTrayBalloon(const wchar_t* title, const wchar_t* text);
 void ToggleAutoStart();
+void DumpTiming();
 
 #endif
@@ -0,0 +1,435 @@
+#include "libs/tsdb/tsdb.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+
+// File layout: one TSDB_BLOCK_BYTES header page, then numBlocks blocks of
+// TSDB_BLOCK_BYTES, each a BlockHeader followed by the compressed bitstream.
+// Blocks are written in ring order; seq orders them and 0 marks "empty".
+static const uint32_t TSDB_MAGIC   = 0x53544D53;   // "SMTS"
+static const uint16_t TSDB_VERSION = 1;
+
+struct FileHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t slots;         // METRIC_SLOTS, to reject mismatched registries
+    uint32_t blockBytes;
+    uint32_t numBlocks;
+};
+
+struct BlockHeader {
+    uint64_t seq;
+    uint64_t t0, t1;        // first/last timestamp, ms
+    uint32_t count;         // samples
+    uint32_t bits;          // bitstream length
+    uint16_t cores, vols;   // live slot layout of every sample in the block
+    uint8_t  temps, fans;
+    uint8_t  pad[26];
+};
+static_assert(sizeof(BlockHeader) == 64, "BlockHeader must stay 64 bytes");
+
+static const uint32_t BODY_BITS = (TSDB_BLOCK_BYTES - sizeof(BlockHeader)) * 8;
+
+// ---------------------------------------------------------------------------
+// Bit streams (MSB first)
+// ---------------------------------------------------------------------------
+struct BitWriter {
+    uint8_t* p;
+    uint32_t pos;
+    bool     ok;
+
+    void W(uint64_t v, int n) {
+        if (pos + n > BODY_BITS) { ok = false; return; }
+        for (int i = n - 1; i >= 0; i--, pos++) {
+            uint8_t mask = (uint8_t)(0x80 >> (pos & 7));
+            if ((v >> i) & 1) p[pos >> 3] |= mask;
+            else              p[pos >> 3] &= (uint8_t)~mask;
+        }
+    }
+};
+
+struct BitReader {
+    const uint8_t* p;
+    uint32_t pos, end;
+
+    uint64_t R(int n) {
+        uint64_t v = 0;
+        for (int i = 0; i < n && pos < end; i++, pos++)
+            v = (v << 1) | ((p[pos >> 3] >> (7 - (pos & 7))) & 1);
+        return v;
+    }
+    // Length of a run of 1 bits, up to max (the unary prefix codes below)
+    int Ones(int max) {
+        int n = 0;
+        while (n < max && R(1)) n++;
+        return n;
+    }
+};
+
+static int Clz32(uint32_t x) { int n = 0; while (!(x & 0x80000000u)) { x <<= 1; n++; } return n; }
+static int Ctz32(uint32_t x) { int n = 0; while (!(x & 1u)) { x >>= 1; n++; } return n; }
+
+// ---------------------------------------------------------------------------
+// Sample codec
+// ---------------------------------------------------------------------------
+// Per-slot Gorilla state; lead/trail 0xFF = no previous window
+struct SlotState {
+    uint32_t prev;
+    uint8_t  lead, trail;
+};
+
+struct Codec {
+    int       n;                        // live slots
+    uint16_t  map[METRIC_SLOTS];        // live slot -> MetricSet slot
+    bool      isU[METRIC_SLOTS];
+    uint64_t  prevT;
+    int64_t   prevDelta;
+    SlotState s[METRIC_SLOTS];
+};
+
+static int BlockLen(const BlockHeader* b, int id) {
+    return MetricLen((MetricId)id, b->cores, b->vols, b->temps, b->fans);
+}
+
+static void BuildMap(Codec& c, const BlockHeader* b) {
+    c.n = 0;
+    for (int id = 0; id < METRIC_COUNT; id++) {
+        int len = BlockLen(b, id);
+        for (int i = 0; i < len; i++) {
+            c.isU[c.n]   = g_metricDesc[id].type == MT_U64;
+            c.map[c.n++] = (uint16_t)(MetricBase(id) + i);
+        }
+    }
+}
+
+static uint32_t SlotBits(const MetricSet& m, const Codec& c, int k) {
+    const MetricValue& v = m.v[c.map[k]];
+    float f = c.isU[k] ? (float)v.u : (float)v.f;
+    uint32_t b;
+    memcpy(&b, &f, 4);
+    return b;
+}
+
+static float BitsFloat(uint32_t b) {
+    float f;
+    memcpy(&f, &b, 4);
+    return f;
+}
+
+// First sample of a block: raw values, timestamp lives in the header
+static void EncodeFirst(BitWriter& w, Codec& c, const MetricSet& m, uint64_t t) {
+    for (int k = 0; k < c.n; k++) {
+        c.s[k].prev = SlotBits(m, c, k);
+        c.s[k].lead = c.s[k].trail = 0xFF;
+        w.W(c.s[k].prev, 32);
+    }
+    c.prevT = t;
+    c.prevDelta = 0;
+}
+
+static void EncodeNext(BitWriter& w, Codec& c, const MetricSet& m, uint64_t t) {
+    int64_t delta = (int64_t)(t - c.prevT);
+    int64_t dod   = delta - c.prevDelta;
+    if (dod == 0)                          w.W(0, 1);
+    else if (dod >= -63 && dod <= 64)      { w.W(0x2, 2);  w.W(dod + 63, 7); }
+    else if (dod >= -255 && dod <= 256)    { w.W(0x6, 3);  w.W(dod + 255, 9); }
+    else if (dod >= -2047 && dod <= 2048)  { w.W(0xE, 4);  w.W(dod + 2047, 12); }
+    else                                   { w.W(0xF, 4);  w.W((uint32_t)(int32_t)dod, 32); }
+    c.prevT = t;
+    c.prevDelta = delta;
+
+    for (int k = 0; k < c.n; k++) {
+        SlotState& s = c.s[k];
+        uint32_t cur = SlotBits(m, c, k);
+        uint32_t x = cur ^ s.prev;
+        s.prev = cur;
+        if (!x) { w.W(0, 1); continue; }
+        int lead = Clz32(x), trail = Ctz32(x);
+        if (lead > 31) lead = 31;
+        if (s.lead != 0xFF && lead >= s.lead && trail >= s.trail) {
+            w.W(0x2, 2);
+            w.W(x >> s.trail, 32 - s.lead - s.trail);
+        } else {
+            int len = 32 - lead - trail;
+            w.W(0x3, 2);
+            w.W(lead, 5);
+            w.W(len - 1, 5);
+            w.W(x >> trail, len);
+            s.lead = (uint8_t)lead;
+            s.trail = (uint8_t)trail;
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Mapping
+// ---------------------------------------------------------------------------
+static std::mutex g_tsdbMtx;
+static uint8_t*   g_base      = nullptr;
+static uint32_t   g_bytes     = 0;
+static uint32_t   g_numBlocks = 0;
+static uint32_t   g_cur       = 0;      // block being appended to
+static uint64_t   g_seq       = 0;      // highest block seq
+static bool       g_encValid  = false;  // g_enc matches block g_cur
+static Codec      g_enc;
+
+#ifdef _WIN32
+static HANDLE g_file = INVALID_HANDLE_VALUE, g_map = nullptr;
+#else
+static int    g_fd = -1;
+#endif
+
+static FileHeader*  Header()           { return (FileHeader*)g_base; }
+static BlockHeader* Block(uint32_t i)  { return (BlockHeader*)(g_base + (size_t)(i + 1) * TSDB_BLOCK_BYTES); }
+static uint8_t*     Body(uint32_t i)   { return (uint8_t*)(Block(i) + 1); }
+
+static void Unmap() {
+#ifdef _WIN32
+    if (g_base) { FlushViewOfFile(g_base, 0); UnmapViewOfFile(g_base); }
+    if (g_map) CloseHandle(g_map);
+    if (g_file != INVALID_HANDLE_VALUE) CloseHandle(g_file);
+    g_map = nullptr;
+    g_file = INVALID_HANDLE_VALUE;
+#else
+    if (g_base) { msync(g_base, g_bytes, MS_ASYNC); munmap(g_base, g_bytes); }
+    if (g_fd >= 0) close(g_fd);
+    g_fd = -1;
+#endif
+    g_base = nullptr;
+}
+
+// Maps path at exactly `bytes`; a file of any other size is zeroed first.
+static bool Map(const char* path, uint32_t bytes) {
+#ifdef _WIN32
+    wchar_t wpath[MAX_PATH];
+    if (!MultiByteToWideChar(CP_UTF8, 0, path, -1, wpath, MAX_PATH)) return false;
+    g_file = CreateFileW(wpath, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+                         OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (g_file == INVALID_HANDLE_VALUE) return false;
+    LARGE_INTEGER sz;
+    if (GetFileSizeEx(g_file, &sz) && sz.QuadPart != (LONGLONG)bytes) {
+        LARGE_INTEGER zero = {};
+        SetFilePointerEx(g_file, zero, nullptr, FILE_BEGIN);
+        SetEndOfFile(g_file);
+    }
+    g_map = CreateFileMappingW(g_file, nullptr, PAGE_READWRITE, 0, bytes, nullptr);
+    if (!g_map) { Unmap(); return false; }
+    g_base = (uint8_t*)MapViewOfFile(g_map, FILE_MAP_ALL_ACCESS, 0, 0, bytes);
+#else
+    g_fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (g_fd < 0) return false;
+    struct stat st;
+    if (fstat(g_fd, &st) != 0 ||
+        (st.st_size != (off_t)bytes && (ftruncate(g_fd, 0) != 0 || ftruncate(g_fd, bytes) != 0))) {
+        Unmap();
+        return false;
+    }
+    void* p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, g_fd, 0);
+    g_base = p == MAP_FAILED ? nullptr : (uint8_t*)p;
+#endif
+    g_bytes = bytes;
+    if (!g_base) { Unmap(); return false; }
+    return true;
+}
+
+std::string TsdbDefaultPath() {
+#ifdef _WIN32
+    const wchar_t* base = _wgetenv(L"LOCALAPPDATA");
+    if (!base) return std::string();
+    wchar_t dir[MAX_PATH];
+    _snwprintf_s(dir, _TRUNCATE, L"%s\\SysMonitor", base);
+    CreateDirectoryW(dir, nullptr);
+    char utf8[MAX_PATH * 3];
+    if (!WideCharToMultiByte(CP_UTF8, 0, dir, -1, utf8, sizeof(utf8), nullptr, nullptr))
+        return std::string();
+    return std::string(utf8) + "\\history.tsdb";
+#else
+    std::string dir;
+    if (const char* x = getenv("XDG_STATE_HOME")) dir = x;
+    else if (const char* h = getenv("HOME")) {
+        dir = std::string(h) + "/.local";
+        mkdir(dir.c_str(), 0755);
+        dir += "/state";
+    } else return std::string();
+    mkdir(dir.c_str(), 0755);
+    dir += "/sysmonitor";
+    mkdir(dir.c_str(), 0755);
+    return dir + "/history.tsdb";
+#endif
+}
+
+bool TsdbOpen(const char* path, uint32_t bytes) {
+    std::lock_guard<std::mutex> lk(g_tsdbMtx);
+    if (g_base || !path || !*path) return false;
+    bytes -= bytes % TSDB_BLOCK_BYTES;
+    if (bytes < 3 * TSDB_BLOCK_BYTES || !Map(path, bytes)) return false;
+
+    g_numBlocks = bytes / TSDB_BLOCK_BYTES - 1;
+    FileHeader* h = Header();
+    if (h->magic != TSDB_MAGIC || h->version != TSDB_VERSION || h->slots != METRIC_SLOTS ||
+        h->blockBytes != TSDB_BLOCK_BYTES || h->numBlocks != g_numBlocks) {
+        for (uint32_t i = 0; i < g_numBlocks; i++) memset(Block(i), 0, sizeof(BlockHeader));
+        h->magic      = TSDB_MAGIC;
+        h->version    = TSDB_VERSION;
+        h->slots      = (uint16_t)METRIC_SLOTS;
+        h->blockBytes = TSDB_BLOCK_BYTES;
+        h->numBlocks  = g_numBlocks;
+    }
+
+    // Resume after the newest block; a partly filled one is left as is
+    g_cur = g_numBlocks - 1;
+    g_seq = 0;
+    for (uint32_t i = 0; i < g_numBlocks; i++)
+        if (Block(i)->seq > g_seq) { g_seq = Block(i)->seq; g_cur = i; }
+    g_encValid = false;
+    return true;
+}
+
+void TsdbClose() {
+    std::lock_guard<std::mutex> lk(g_tsdbMtx);
+    Unmap();
+}
+
+bool TsdbIsOpen() {
+    std::lock_guard<std::mutex> lk(g_tsdbMtx);
+    return g_base != nullptr;
+}
+
+// ---------------------------------------------------------------------------
+// Append
+// ---------------------------------------------------------------------------
+uint64_t TsdbNowMs() {
+    using namespace std::chrono;
+    return (uint64_t)duration_cast<milliseconds>(system_clock::now().time_since_epoch()).count();
+}
+
+static void StartBlock(const MetricSet& m, uint64_t t) {
+    g_cur = (g_cur + 1) % g_numBlocks;
+    BlockHeader* b = Block(g_cur);
+    b->seq = 0;                         // invalid while rewritten
+    b->t0 = b->t1 = t;
+    b->cores = (uint16_t)m.Cores();
+    b->vols  = (uint16_t)m.Vols();
+    b->temps = (uint8_t)m.Temps();
+    b->fans  = (uint8_t)m.Fans();
+    BuildMap(g_enc, b);
+    BitWriter w{Body(g_cur), 0, true};
+    EncodeFirst(w, g_enc, m, t);
+    b->bits  = w.pos;
+    b->count = 1;
+    b->seq   = ++g_seq;
+    g_encValid = true;
+}
+
+void TsdbAppend(const MetricSet& m, uint64_t tsMs) {
+    std::lock_guard<std::mutex> lk(g_tsdbMtx);
+    if (!g_base) return;
+    BlockHeader* b = Block(g_cur);
+    bool same = g_encValid && b->cores == m.Cores() && b->vols == m.Vols() &&
+                b->temps == m.Temps() && b->fans == m.Fans() &&
+                tsMs > g_enc.prevT && tsMs - g_enc.prevT < 0x7FFFFFFF;
+    if (same) {
+        // Encode into a scratch codec so a full block leaves state untouched
+        static Codec next;
+        next = g_enc;
+        BitWriter w{Body(g_cur), b->bits, true};
+        EncodeNext(w, next, m, tsMs);
+        if (w.ok) {
+            g_enc = next;
+            b->bits = w.pos;
+            b->t1   = tsMs;
+            b->count++;
+            return;
+        }
+    }
+    StartBlock(m, tsMs);
+}
+
+// ---------------------------------------------------------------------------
+// Read
+// ---------------------------------------------------------------------------
+// Decodes block i, reporting live slot k samples in [from, to)
+static size_t ScanBlock(uint32_t i, int k, uint64_t from, uint64_t to, TsdbVisit fn, void* ctx) {
+    const BlockHeader* b = Block(i);
+    static Codec c;
+    BuildMap(c, b);
+    BitReader r{Body(i), 0, b->bits};
+    size_t n = 0;
+
+    uint64_t t = b->t0;
+    int64_t  delta = 0;
+    for (int j = 0; j < c.n; j++) {
+        c.s[j].prev = (uint32_t)r.R(32);
+        c.s[j].lead = c.s[j].trail = 0;
+    }
+    for (uint32_t si = 0; ; ) {
+        if (t >= from && t < to) { fn(ctx, t, BitsFloat(c.s[k].prev)); n++; }
+        if (++si >= b->count || t >= to) break;
+
+        int64_t dod;
+        switch (r.Ones(4)) {
+        case 0:  dod = 0; break;
+        case 1:  dod = (int64_t)r.R(7) - 63; break;
+        case 2:  dod = (int64_t)r.R(9) - 255; break;
+        case 3:  dod = (int64_t)r.R(12) - 2047; break;
+        default: dod = (int32_t)(uint32_t)r.R(32); break;
+        }
+        delta += dod;
+        t += delta;
+
+        for (int j = 0; j < c.n; j++) {
+            SlotState& s = c.s[j];
+            if (!r.R(1)) continue;
+            if (r.R(1)) {
+                s.lead  = (uint8_t)r.R(5);
+                int len = (int)r.R(5) + 1;
+                s.trail = (uint8_t)(32 - s.lead - len);
+            }
+            s.prev ^= (uint32_t)r.R(32 - s.lead - s.trail) << s.trail;
+        }
+    }
+    return n;
+}
+
+size_t TsdbScan(MetricId id, int i, uint64_t from, uint64_t to, TsdbVisit fn, void* ctx) {
+    std::lock_guard<std::mutex> lk(g_tsdbMtx);
+    if (!g_base || i < 0 || i >= METRIC_LEN[id]) return 0;
+    size_t n = 0;
+    // Ring order from the block after g_cur is oldest first
+    for (uint32_t j = 1; j <= g_numBlocks; j++) {
+        uint32_t bi = (g_cur + j) % g_numBlocks;
+        const BlockHeader* b = Block(bi);
+        if (!b->seq || !b->count || b->t1 < from || b->t0 >= to) continue;
+        if (i >= BlockLen(b, id)) continue;
+        // Live index of the slot: count live slots of earlier metrics
+        int k = i;
+        for (int e = 0; e < id; e++) k += BlockLen(b, e);
+        n += ScanBlock(bi, k, from, to, fn, ctx);
+    }
+    return n;
+}
+
+bool TsdbRange(uint64_t* first, uint64_t* last) {
+    std::lock_guard<std::mutex> lk(g_tsdbMtx);
+    if (!g_base) return false;
+    bool any = false;
+    for (uint32_t j = 1; j <= g_numBlocks; j++) {
+        const BlockHeader* b = Block((g_cur + j) % g_numBlocks);
+        if (!b->seq || !b->count) continue;
+        if (!any) *first = b->t0;
+        *last = b->t1;
+        any = true;
+    }
+    return any;
+}
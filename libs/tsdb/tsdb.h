@@ -0,0 +1,48 @@
+// SysMonitor - On-disk metric history (memory-mapped ring file)
+// Portable: shared by the Windows, macOS and Linux builds.
+// Every live metric slot of every tick is appended to a fixed-size ring of
+// blocks. Inside a block, samples are Gorilla-compressed: timestamps as
+// delta-of-delta, values as float32 XORed against the previous sample of the
+// same slot. A block only holds slots that were live when it started (its
+// core and volume counts), so a typical 8-core box costs ~45 bytes/sample
+// and the default 8 MB file covers about a day at 1 s.
+// Blocks carry their time range, so a range read decodes only the blocks
+// that overlap it. The file is reopened and appended to after a restart.
+#ifndef SYSMON_TSDB_H
+#define SYSMON_TSDB_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "libs/metrics/metrics.h"
+
+static const uint32_t TSDB_BLOCK_BYTES   = 16384;
+static const uint32_t TSDB_DEFAULT_BYTES = 8u << 20;
+
+// Platform default: %LOCALAPPDATA%\SysMonitor\history.tsdb, or
+// $XDG_STATE_HOME/sysmonitor/history.tsdb (~/.local/state/...). The
+// directory is created if needed; empty if no base directory is known.
+std::string TsdbDefaultPath();
+
+// Opens (or creates) the ring file at a UTF-8 path. An existing file with a
+// different layout or size is recreated. false if it cannot be mapped.
+bool TsdbOpen(const char* path, uint32_t bytes = TSDB_DEFAULT_BYTES);
+void TsdbClose();
+bool TsdbIsOpen();
+
+// Wall clock, ms since the Unix epoch
+uint64_t TsdbNowMs();
+
+// Appends one sample; tsMs is wall-clock ms and should increase
+void TsdbAppend(const MetricSet& m, uint64_t tsMs);
+
+// Streams samples of slot i of metric id with from <= ts < to, oldest
+// first, to fn. Returns the number of samples visited.
+typedef void (*TsdbVisit)(void* ctx, uint64_t tsMs, double v);
+size_t TsdbScan(MetricId id, int i, uint64_t from, uint64_t to, TsdbVisit fn, void* ctx);
+
+// Oldest and newest stored timestamps; false if the store is empty
+bool TsdbRange(uint64_t* first, uint64_t* last);
+
+#endif // SYSMON_TSDB_H
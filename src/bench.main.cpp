@@ -0,0 +1,214 @@
+// SysMonitor - Microbenchmarks (Linux)
+// Times every sampler, encoder, store and layout path that builds on Linux,
+// plus the JSON and Fmt* helpers through a stand-in for the Win32 header.
+// Samplers run twice: update_*_live through the real backend (/proc, /sys,
+// statvfs, the cached fds), so I/O and syscall regressions show, then
+// update_* on a fixed synthetic host (libs/sim) for the parsing and rate
+// math, which compares across machines; each of those includes one SimStep
+// (timed alone as sim_step). The rest run on the synthetic host's last sample.
+// Usage: sysmon_bench [--json] [--filter SUBSTR] [--min-ms N]
+
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "libs/bench/bench.h"
+#include "libs/sim/sim.h"
+#include "libs/linux/metrics_linux.h"
+#include "libs/agent/agent.h"
+#include "libs/metrics/metrics.h"
+#include "libs/exporter/exporter.h"
+#include "libs/tsdb/tsdb.h"
+#include "libs/rules/rules.h"
+#include "libs/shm/shm.h"
+#include "libs/history/history.h"
+#include "libs/rollup/rollup.h"
+#include "libs/layout/win_spec.h"
+#include "libs/json/json.h"
+#include "libs/util/util.h"
+
+static char g_buf[AGENT_RECORD_MAX * 4];
+
+// Shape of the ip-api / open-meteo replies parsed by libs/external
+static const wchar_t* BENCH_JSON =
+    L"{\"status\":\"success\",\"country\":\"Germany\",\"countryCode\":\"DE\","
+    L"\"region\":\"BE\",\"regionName\":\"Land Berlin\",\"city\":\"Berlin\","
+    L"\"zip\":\"10115\",\"lat\":52.5244,\"lon\":13.4105,\"timezone\":\"Europe/Berlin\","
+    L"\"isp\":\"Example\",\"query\":\"203.0.113.7\",\"current\":{\"time\":\"2026-10-18T12:00\","
+    L"\"interval\":900,\"temperature_2m\":14.3,\"weather_code\":3}}";
+
+// A laptop-sized host with a battery; the seed fixes every generated value
+static const SimConfig BENCH_HOST = { 8, 4, 8, 1, true };
+
+static void NoAlert(void*, const AlertEvent&) {}
+
+// This machine's own files; battery and thermal time only what it has
+static void BenchLiveSamplers() {
+    InitCpu();
+    InitNet();
+    Bench("update_cpu_live",     [] { UpdateCpu(); });
+    Bench("update_mem_live",     [] { UpdateMem(); });
+    Bench("update_disk_live",    [] { UpdateDisk(); });
+    Bench("update_net_live",     [] { UpdateNet(); });
+    Bench("update_battery_live", [] { UpdateBattery(); });
+    Bench("update_thermal_live", [] { UpdateThermal(); });
+}
+
+// The clock has to move for the rate paths to run, so every case steps it
+static void BenchSamplers() {
+    InitCpu();
+    InitNet();
+    Bench("sim_step",       [] { SimStep(1000); });
+    Bench("update_cpu",     [] { SimStep(1000); UpdateCpu(); });
+    Bench("update_mem",     [] { SimStep(1000); UpdateMem(); });
+    Bench("update_disk",    [] { SimStep(1000); UpdateDisk(); });
+    Bench("update_net",     [] { SimStep(1000); UpdateNet(); });
+    Bench("update_battery", [] { SimStep(1000); UpdateBattery(); });
+    Bench("update_thermal", [] { SimStep(1000); UpdateThermal(); });
+}
+
+static void BenchOutputs() {
+    static uint64_t seq = 0;
+    Bench("encode_json", [] {
+        size_t n = EncodeRecord(AGENT_JSON, g_metrics, ++seq, 1760000000000ull, g_buf, sizeof(g_buf));
+        BenchKeep(&n);
+    });
+    Bench("encode_bin", [] {
+        size_t n = EncodeRecord(AGENT_BIN, g_metrics, ++seq, 1760000000000ull, g_buf, sizeof(g_buf));
+        BenchKeep(&n);
+    });
+    Bench("openmetrics", [] {
+        size_t n = RenderOpenMetrics(g_metrics, g_buf, sizeof(g_buf));
+        BenchKeep(&n);
+    });
+
+    if (BenchWanted("shm_publish")) {
+        if (ShmOpen()) {
+            static uint64_t ts = 0;
+            Bench("shm_publish", [] { ShmPublish(g_metrics, ++ts); });
+            ShmClose();
+        } else {
+            fprintf(stderr, "sysmon_bench: shm_publish skipped (segment busy)\n");
+        }
+    }
+
+    if (BenchWanted("tsdb_append")) {
+        char path[] = "/tmp/sysmon_bench.XXXXXX";
+        int fd = mkstemp(path);
+        if (fd >= 0) close(fd);
+        if (fd >= 0 && TsdbOpen(path)) {
+            static uint64_t ts = 1760000000000ull;
+            Bench("tsdb_append", [] { TsdbAppend(g_metrics, ts += 1000); });
+            TsdbClose();
+        } else {
+            fprintf(stderr, "sysmon_bench: tsdb_append skipped (cannot create %s)\n", path);
+        }
+        if (fd >= 0) unlink(path);
+    }
+}
+
+static void BenchRules() {
+    std::vector<std::string> rules = {
+        "cpu: cpu.total > 90 for 30s",
+        "core pinned: cpu.core[*] > 95 for 30s",
+        "ram: mem.ram.pct > 90 for 60s clear 85",
+        "disk: disk.pct[*] > 95",
+        "disk fill: rate(disk.pct[*], 5m) > 1/m",
+        "net: rate(net.down, 10s) > 100000000",
+    };
+    std::vector<std::string> errors;
+    CompileRules(rules, &errors);
+    for (const std::string& e : errors) fprintf(stderr, "sysmon_bench: %s\n", e.c_str());
+    static uint64_t now = 0;
+    Bench("rules_eval", [] { EvalRules(g_metrics, now += 1000, NoAlert, nullptr); });
+}
+
+static void BenchHistory() {
+    // Fill an hour of samples so windows and strips see full buckets
+    static uint64_t now = 1760000000000ull;
+    for (int i = 0; i < 3600; i++) RollupPush(HIST_CPU, (float)(i % 100), now += 1000);
+
+    Bench("rollup_push",       [] { RollupPush(HIST_CPU, 42.f, now += 1000); });
+    Bench("rollup_window_1h",  [] { RollupStats s = RollupWindow(HIST_CPU, 3600, now); BenchKeep(&s); });
+    Bench("rollup_quantile",   [] { float q = RollupQuantile(HIST_CPU, 3600, 0.95f, now); BenchKeep(&q); });
+    Bench("hist_minmax",       [] {
+        float mn[120], mx[120];
+        int n = HistMinMax(g_hist[HIST_CPU], 120, mn, mx);
+        BenchKeep(mn); BenchKeep(mx); BenchKeep(&n);
+    });
+}
+
+static void BenchLayout() {
+    static const int order[] = { SEC_ID_TIME, SEC_ID_CPU, SEC_ID_MEM, SEC_ID_DISK,
+                                 SEC_ID_NET, SEC_ID_WX, SEC_ID_PLUGIN };
+    static const int numSecs = (int)(sizeof(order) / sizeof(order[0]));
+    Bench("layout_cached", [] {
+        const Layout& l = GetLayout(WIN_SPEC, order, numSecs, 16, 4, 3, 0, 1.f);
+        BenchKeep(&l);
+    });
+    // Alternating core counts defeats the cache: a full rebuild every call
+    static int flip = 0;
+    Bench("layout_rebuild", [] {
+        const Layout& l = GetLayout(WIN_SPEC, order, numSecs, (flip ^= 1) ? 16 : 17, 4, 3, 0, 1.f);
+        BenchKeep(&l);
+    });
+    static const Layout* l = &GetLayout(WIN_SPEC, order, numSecs, 16, 4, 3, 0, 1.f);
+    static float x = 0;
+    Bench("layout_hit", [] {
+        int idx;
+        x += 7.f;
+        if (x >= l->width) x = 0;
+        HitKind k = LayoutHitTest(*l, x, 40.f, &idx);
+        BenchKeep(&k); BenchKeep(&idx);
+    });
+}
+
+static void BenchFormat() {
+    static const std::wstring json = BENCH_JSON;
+    Bench("json_jstr", [] { std::wstring s = JStr(json, L"countryCode"); BenchKeep(s.c_str()); });
+    Bench("json_jnum", [] { double v = JNum(json, L"temperature_2m"); BenchKeep(&v); });
+    Bench("json_jint", [] { int v = JInt(json, L"interval"); BenchKeep(&v); });
+
+    static wchar_t buf[32];
+    static int i = 0;
+    // Walk the unit ranges so every branch is taken
+    Bench("fmt_speed", [] {
+        static const double v[] = { 512, 48e3, 12.5e6, 3.2e9 };
+        FmtSpeed(v[i++ & 3], buf, 32); BenchKeep(buf);
+    });
+    Bench("fmt_mem", [] {
+        static const ULONGLONG v[] = { 512, 16384 };
+        FmtMem(v[i++ & 1], buf, 32); BenchKeep(buf);
+    });
+    Bench("fmt_disk", [] {
+        static const double v[] = { 476.9, 3725.3 };
+        FmtDisk(v[i++ & 1], buf, 32); BenchKeep(buf);
+    });
+    Bench("to_wide", [] {
+        static const std::string s = "Zürich, Schweiz";
+        std::wstring w = ToWide(s); BenchKeep(w.c_str());
+    });
+}
+
+int main(int argc, char** argv) {
+    if (!BenchInit(argc, argv)) return 2;
+
+    BenchLiveSamplers();
+    SimStart(BENCH_HOST);
+    BenchSamplers();
+    // The rest run on the host's last sample
+    SimStep(1000);
+    UpdateCpu(); UpdateMem(); UpdateDisk(); UpdateNet(); UpdateBattery(); UpdateThermal();
+    BenchOutputs();
+    BenchRules();
+    BenchHistory();
+    BenchLayout();
+    BenchFormat();
+
+    SimStop();
+    BenchDone();
+    return 0;
+}
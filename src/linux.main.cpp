@@ -0,0 +1,309 @@
+// SysMonitor - Headless Linux agent
+// Samples the same metrics as the widgets from /proc and /sys and writes one
+// record per interval (JSON lines or fixed-size binary) to stdout or a file.
+// Usage: sysmon --headless [--interval MS] [--format json|bin|none]
+//               [--output PATH] [--count N] [--listen PORT] [--store PATH]
+//               [--record PATH | --replay PATH]
+
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+
+#include "libs/linux/metrics_linux.h"
+#include "libs/agent/agent.h"
+#include "libs/config/config.h"
+#include "libs/metrics/metrics.h"
+#include "libs/perf/perf.h"
+#include "libs/exporter/exporter.h"
+#include "libs/tsdb/tsdb.h"
+#include "libs/rules/rules.h"
+#include "libs/shm/shm.h"
+#include "libs/trace/trace.h"
+#include "libs/footprint/footprint.h"
+#include "libs/sched/sched.h"
+#include "libs/rates/rates.h"
+
+static const int  MIN_INTERVAL_MS = 10;
+static const long MAX_INTERVAL_MS = 24L * 3600 * 1000;
+
+static volatile sig_atomic_t g_stop = 0;
+static void OnSignal(int) { g_stop = 1; }
+
+static char g_record[AGENT_RECORD_MAX];
+
+static void Usage() {
+    fprintf(stderr,
+        "usage: sysmon --headless [--interval MS] [--format json|bin|none]\n"
+        "                         [--output PATH] [--count N] [--listen PORT]\n"
+        "                         [--store PATH] [--record PATH | --replay PATH]\n"
+        "  --interval MS   sampling period (default 1000, min %d, max %ld)\n"
+        "  --format FMT    json (one object per line), bin (fixed-size records)\n"
+        "                  or none (exporter only)\n"
+        "  --output PATH   append to PATH instead of stdout\n"
+        "  --count N       stop after N samples (default: run until signalled)\n"
+        "  --listen PORT   serve OpenMetrics on 127.0.0.1:PORT/metrics, 0 to disable\n"
+        "                  (default: exporter_port from the config file)\n"
+        "  --store PATH    also append every sample to a compressed history\n"
+        "                  ring file (default: history_file from the config file)\n"
+        "  --record PATH   also write the raw /proc and /sys inputs to a trace\n"
+        "  --replay PATH   compute from a recorded trace instead of the live\n"
+        "                  system, as fast as possible, then exit\n",
+        MIN_INTERVAL_MS, MAX_INTERVAL_MS);
+}
+
+// Whole decimal argument in [lo, hi]; trailing text ("1s") is rejected
+static bool ParseNum(const char* v, long long lo, long long hi, long long& out) {
+    char* end;
+    errno = 0;
+    long long n = strtoll(v, &end, 10);
+    if (end == v || *end != '\0' || errno == ERANGE || n < lo || n > hi) return false;
+    out = n;
+    return true;
+}
+
+// Full write, retrying on EINTR / short writes
+static bool WriteAll(int fd, const char* p, size_t n) {
+    while (n > 0) {
+        ssize_t w = write(fd, p, n);
+        if (w < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        p += w;
+        n -= (size_t)w;
+    }
+    return true;
+}
+
+static uint64_t WallMs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (uint64_t)ts.tv_sec * 1000ULL + ts.tv_nsec / 1000000ULL;
+}
+
+// Alerts go to stderr as timestamped log lines, next to the record stream
+static void LogAlert(void*, const AlertEvent& e) {
+    char msg[256], stamp[32];
+    FormatAlert(e, msg, sizeof(msg));
+    time_t t = time(nullptr);
+    struct tm tm;
+    localtime_r(&t, &tm);
+    strftime(stamp, sizeof(stamp), "%Y-%m-%dT%H:%M:%S", &tm);
+    fprintf(stderr, "%s sysmon: %s %s\n", stamp, e.firing ? "ALERT" : "resolved", msg);
+}
+
+// Everything downstream of the samplers; false once the output fails
+static bool Emit(AgentFormat fmt, bool records, int fd, uint64_t seq, uint64_t tickMs, uint64_t wallMs) {
+    ExporterPublish(g_metrics);
+    ShmPublish(g_metrics, wallMs);
+    { PerfScope p(PERF_STORE); TsdbAppend(g_metrics, wallMs); }
+    if (HaveRules()) { PerfScope p(PERF_RULES); EvalRules(g_metrics, tickMs, LogAlert, nullptr); }
+    if (!records) return true;
+    size_t n = EncodeRecord(fmt, g_metrics, seq, wallMs, g_record, sizeof(g_record));
+    if (n == 0 || !WriteAll(fd, g_record, n)) {
+        if (n == 0) fprintf(stderr, "sysmon: record exceeds %zu bytes\n", sizeof(g_record));
+        else if (errno != EPIPE) fprintf(stderr, "sysmon: write: %s\n", strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+// Replays a trace tick by tick: backend records go through the normal
+// computation, each tick marker emits a sample stamped with recorded times.
+static int Replay(AgentFormat fmt, bool records, int fd, long long count) {
+    static TraceSample s;
+    uint64_t seq = 0;
+    while (!g_stop && (count < 0 || (long long)seq < count) && TraceNext(s)) {
+        if (s.kind != TRACE_TICK) {
+            ReplaySample(s);
+            continue;
+        }
+        uint64_t wall = s.numVals > 0 ? s.vals[0] : 0;
+        if (!Emit(fmt, records, fd, seq++, s.tickMs, wall)) return 1;
+    }
+    return 0;
+}
+
+// Each sampler at its own interval (libs/rates); the record always
+// carries the latest value of every metric
+static void SampleOnce() {
+    uint32_t active = (1u << RATE_BATTERY) | (1u << RATE_THERMAL);
+    if (SectionOn(SEC_ID_CPU))  active |= 1u << RATE_CPU;
+    if (SectionOn(SEC_ID_MEM))  active |= 1u << RATE_MEM;
+    if (SectionOn(SEC_ID_DISK)) active |= 1u << RATE_DISK;
+    if (SectionOn(SEC_ID_NET))  active |= 1u << RATE_NET;
+    uint32_t due = RatesTick(active);
+    if (RateDue(due, RATE_CPU))     { PerfScope p(PERF_CPU);     UpdateCpu(); }
+    if (RateDue(due, RATE_MEM))     { PerfScope p(PERF_MEM);     UpdateMem(); }
+    if (RateDue(due, RATE_DISK))    { PerfScope p(PERF_DISK);    UpdateDisk(); }
+    if (RateDue(due, RATE_NET))     { PerfScope p(PERF_NET);     UpdateNet(); }
+    if (RateDue(due, RATE_BATTERY)) { PerfScope p(PERF_BATTERY); UpdateBattery(); }
+    if (RateDue(due, RATE_THERMAL)) { PerfScope p(PERF_THERMAL); UpdateThermal(); }
+}
+
+int main(int argc, char* argv[]) {
+    bool        headless = false;
+    long        intervalMs = 1000;
+    long long   count = -1;
+    AgentFormat fmt = AGENT_JSON;
+    bool        records = true;
+    const char* outPath = nullptr;
+    const char* storePath = nullptr;
+    const char* recordPath = nullptr;
+    const char* replayPath = nullptr;
+    int         listenPort = -1;
+
+    for (int i = 1; i < argc; i++) {
+        const char* a = argv[i];
+        const char* v = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (strcmp(a, "--headless") == 0) headless = true;
+        else if (strcmp(a, "--interval") == 0 && v) {
+            long long n;
+            if (!ParseNum(v, MIN_INTERVAL_MS, MAX_INTERVAL_MS, n)) { Usage(); return 2; }
+            intervalMs = (long)n;
+            i++;
+        }
+        else if (strcmp(a, "--count") == 0 && v) {
+            if (!ParseNum(v, 1, LLONG_MAX, count)) { Usage(); return 2; }
+            i++;
+        }
+        else if (strcmp(a, "--output") == 0 && v)   { outPath = v; i++; }
+        else if (strcmp(a, "--listen") == 0 && v) {
+            long long n;
+            if (!ParseNum(v, 0, 65535, n)) { Usage(); return 2; }
+            listenPort = (int)n;
+            i++;
+        }
+        else if (strcmp(a, "--store") == 0 && v)    { storePath = v; i++; }
+        else if (strcmp(a, "--record") == 0 && v)   { recordPath = v; i++; }
+        else if (strcmp(a, "--replay") == 0 && v)   { replayPath = v; i++; }
+        else if (strcmp(a, "--format") == 0 && v) {
+            if (strcmp(v, "json") == 0)     fmt = AGENT_JSON;
+            else if (strcmp(v, "bin") == 0) fmt = AGENT_BIN;
+            else if (strcmp(v, "none") == 0) records = false;
+            else { Usage(); return 2; }
+            i++;
+        }
+        else { Usage(); return strcmp(a, "--help") == 0 ? 0 : 2; }
+    }
+    if (!headless) {
+        fprintf(stderr, "sysmon: the Linux build has no UI; pass --headless\n");
+        Usage();
+        return 2;
+    }
+    if (recordPath && replayPath) {
+        Usage();
+        return 2;
+    }
+    if (replayPath && !TraceStartReplay(replayPath)) {
+        fprintf(stderr, "sysmon: %s: not a trace\n", replayPath);
+        return 1;
+    }
+    if (recordPath && !TraceStartRecord(recordPath)) {
+        fprintf(stderr, "sysmon: %s: %s\n", recordPath, strerror(errno));
+        return 1;
+    }
+
+    int fd = STDOUT_FILENO;
+    if (outPath) {
+        fd = open(outPath, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+        if (fd < 0) {
+            fprintf(stderr, "sysmon: %s: %s\n", outPath, strerror(errno));
+            return 1;
+        }
+    }
+
+    struct sigaction sa = {};
+    sa.sa_handler = OnSignal;
+    sigaction(SIGINT, &sa, nullptr);
+    sigaction(SIGTERM, &sa, nullptr);
+    signal(SIGPIPE, SIG_IGN);
+
+    LoadConfig();
+    if (listenPort >= 0) g_exporterPort = listenPort;
+    if (storePath) g_historyFile = storePath;
+    std::vector<std::string> ruleErrors;
+    CompileRules(g_alerts, &ruleErrors);
+    for (const std::string& e : ruleErrors) fprintf(stderr, "sysmon: %s\n", e.c_str());
+    FootprintBudget budget;
+    std::string budgetError;
+    if (ParseBudget(g_budget.c_str(), budget, &budgetError)) SetFootprintBudget(budget);
+    else fprintf(stderr, "sysmon: %s\n", budgetError.c_str());
+    FootprintTick(TickMs());
+    RateConfig rates = DefaultRates();
+    std::string ratesError;
+    if (!ParseRates(g_intervals.c_str(), rates, &ratesError)) fprintf(stderr, "sysmon: %s\n", ratesError.c_str());
+    SetRates(rates, (uint32_t)intervalMs);
+    if (!replayPath && SectionOn(SEC_ID_CPU)) InitCpu();
+    if (!replayPath && SectionOn(SEC_ID_NET)) InitNet();
+    if (g_exporterPort && !StartExporter(g_exporterPort)) {
+        fprintf(stderr, "sysmon: cannot listen on 127.0.0.1:%d\n", g_exporterPort);
+        return 1;
+    }
+    // A replay must not replace the live host's snapshot
+    if (!replayPath && !ShmOpen()) fprintf(stderr, "sysmon: shared-memory snapshot unavailable (another publisher?)\n");
+    // Unlike the widgets, the agent only keeps history when asked to
+    if (!g_historyFile.empty() && g_historyFile != "off" && !TsdbOpen(g_historyFile.c_str())) {
+        fprintf(stderr, "sysmon: cannot map %s\n", g_historyFile.c_str());
+        return 1;
+    }
+
+    // Samples land on wall-clock multiples of the interval, so records from
+    // several hosts line up. The timer is absolute: sampling cost doesn't
+    // drift the period, and a setting of the clock cancels the wait
+    // (ECANCELED) so the scheduler re-times instead of sleeping the gap.
+    int tfd = -1;
+    if (!replayPath && (tfd = timerfd_create(CLOCK_REALTIME, TFD_CLOEXEC)) < 0) {
+        fprintf(stderr, "sysmon: timerfd: %s\n", strerror(errno));
+        return 1;
+    }
+    // Plug / unplug shows up on the next tick instead of the next battery poll
+    int nlfd = replayPath ? -1 : OpenPowerEvents();
+    int job = SchedAdd((uint32_t)intervalMs, (uint32_t)intervalMs / 20, SCHED_ALIGNED, WallMs());
+    int rc = replayPath ? Replay(fmt, records, fd, count) : 0;
+    for (uint64_t seq = 0; !replayPath && !g_stop && (count < 0 || (long long)seq < count);) {
+        uint32_t period = (uint32_t)(intervalMs * FootprintPeriodScale());
+        SchedSetPeriod(job, period, period / 20, WallMs());
+        SetRateBase(period);
+        SchedWake w = SchedNext(WallMs());
+        struct itimerspec its = {};
+        its.it_value.tv_sec  = (time_t)(w.atMs / 1000);
+        its.it_value.tv_nsec = (long)(w.atMs % 1000) * 1000000L;
+        timerfd_settime(tfd, TFD_TIMER_ABSTIME | TFD_TIMER_CANCEL_ON_SET, &its, nullptr);
+        struct pollfd pfd[2] = { { tfd, POLLIN, 0 }, { nlfd, POLLIN, 0 } };
+        if (poll(pfd, nlfd >= 0 ? 2 : 1, -1) < 0) continue;  // EINTR
+        if ((pfd[1].revents & POLLIN) && PowerEventsPending(nlfd)) RateTrigger(RATE_BATTERY);
+        if (!(pfd[0].revents & POLLIN)) continue;
+        uint64_t expiries;
+        if (read(tfd, &expiries, sizeof(expiries)) != (ssize_t)sizeof(expiries)) continue;  // EINTR, ECANCELED
+        // A stall (suspend, SIGSTOP) skips to the next boundary, no burst
+        if (!SchedDue(SchedRun(WallMs()), job)) continue;
+
+        SampleOnce();
+        uint64_t tick = TickMs(), wall = WallMs();
+        TraceTick(tick, wall);
+        if (!Emit(fmt, records, fd, seq++, tick, wall)) {
+            rc = 1;
+            break;
+        }
+        if (FootprintTick(TickMs())) fprintf(stderr, "sysmon: %s\n", FootprintNote());
+    }
+
+    StopExporter();
+    TsdbClose();
+    ShmClose();
+    TraceClose();
+    if (tfd >= 0) close(tfd);
+    if (nlfd >= 0) close(nlfd);
+    if (fd != STDOUT_FILENO) close(fd);
+    return rc;
+}
@@ -11,6 +11,7 @@
 #include <mutex>
 #include <thread>
 #include <atomic>
+#include <algorithm>
 #include <cmath>
 #include <cstdio>
 #include <cstring>
@@ -18,18 +19,32 @@
 #include "libs/mac/mac_globals.h"
 #include "libs/mac/metrics_mac.h"
 #include "libs/mac/external_mac.h"
+#include "libs/rollup/rollup.h"
+#include "libs/perf/perf.h"
+#include "libs/layout/engine.h"
+#include "libs/config/config.h"
+#include "libs/metrics/metrics.h"
+#include "libs/exporter/exporter.h"
+#include "libs/tsdb/tsdb.h"
+#include "libs/rules/rules.h"
+#include "libs/shm/shm.h"
+#include "libs/plugins/plugins.h"
+#include "libs/footprint/footprint.h"
+#include "libs/sched/sched.h"
+#include "libs/rates/rates.h"
 
 // ===================================================================
 // Constants (matching Windows layout)
 // ===================================================================
 static const int    WIDGET_H        = 76;
 static const int    BAR_PAD         = 12;
-static const int    SEC_SEP         = 18;
+static const int    SEC_SEP         = 16;
 static const int    SEC_TIME_W      = 115;
 static const int    SEC_MEM_W       = 265;
 static const int    SEC_IPNET_W     = 215;
 static const int    SEC_WX_W        = 105;
 static const CGFloat UPDATE_SEC     = 1.0;
+static const CGFloat BACKGROUND_SEC = 10.0;   // display asleep / session locked
 
 // Widget panel (simulated macOS medium widget)
 static const int    WPANEL_W        = 390;
@@ -64,6 +79,36 @@ static std::atomic<bool> g_wpanelBehind{false};
 // Status item mode (icon vs text stats in macOS top bar)
 static bool g_statusTextMode = false;
 
+// Power state: sampling drops to BACKGROUND_SEC while nobody can see it
+static bool g_displayAsleep = false;
+static bool g_sessionLocked = false;
+static int  g_tickJob       = -1;     // scheduler job of the refresh tick
+
+// Change detection: frames are only redrawn when the display hash moves
+static uint64_t           g_lastFrameHash = 0;
+static unsigned long long g_framesDrawn   = 0;
+static unsigned long long g_framesSkipped = 0;
+static const NSInteger    kFramesItemTag  = 100;
+
+static void Timed(int stage, void (*fn)()) {
+    PerfScope ps(stage);
+    fn();
+}
+
+// Rules engine sink: one user notification per alert/resolve (main thread)
+static void NotifyAlert(void*, const AlertEvent& e) {
+    char msg[256];
+    FormatAlert(e, msg, sizeof(msg));
+    NSUserNotification *n = [[NSUserNotification alloc] init];
+    n.title = e.firing ? @"SysMonitor alert" : @"SysMonitor alert resolved";
+    n.informativeText = [NSString stringWithUTF8String:msg];
+    [[NSUserNotificationCenter defaultUserNotificationCenter] deliverNotification:n];
+}
+
+static void EvalAlerts() {
+    EvalRules(g_metrics, PerfNow() / 1000000, NotifyAlert, nullptr);
+}
+
 // ===================================================================
 // Utility: format helpers
 // ===================================================================
@@ -145,23 +190,146 @@ static void UpdateWindowBehind(NSWindow *myWindow, std::atomic<bool> *target = &
 // ===================================================================
 // Widget dimension calculation
 // ===================================================================
-static int CalcCpuSecW() {
-    int blocksW = g_numCores * 10;
-    return (blocksW > 110 ? blocksW : 110) + 12;
-}
-
 static const int SEC_DISK_COL_W = 95;
-static int CalcDiskSecW() {
-    int n = (int)g_vols.size();
-    int cols = (n + 1) / 2;
-    if (cols < 1) cols = 1;
-    return cols * SEC_DISK_COL_W;
+
+static const LayoutSpec MAC_SPEC = {
+    WIDGET_H, BAR_PAD, SEC_SEP,
+    SEC_TIME_W, 110, 12, SEC_MEM_W, SEC_DISK_COL_W, SEC_IPNET_W, SEC_WX_W,
+    10.f, 42.f, 8.f, 20.f,
+    { 9.f, 42.f }, 24.f,
+    150, 2, { 9.f, 42.f, 0.f }, 24.f,
+    90,
+};
+
+// Plugin results as of the last tick; a running plugin never blocks a draw
+static PluginValue g_plugVals[PLUGIN_MAX];
+static int         g_numPlugVals = 0;
+
+// Views are laid out in points; AppKit handles the backing scale.
+static const Layout &CurLayout() {
+    return GetLayout(MAC_SPEC, g_sections.order, g_sections.count,
+                     g_metrics.Cores(), g_metrics.Vols(), g_numPlugVals, 0, 1.f);
 }
 
 static int CalcWidth() {
-    return BAR_PAD + SEC_TIME_W + SEC_SEP + CalcCpuSecW() + SEC_SEP
-         + SEC_MEM_W + SEC_SEP + CalcDiskSecW() + SEC_SEP
-         + SEC_IPNET_W + SEC_SEP + SEC_WX_W + BAR_PAD;
+    return CurLayout().width;
+}
+
+// ===================================================================
+// Metric shorthands over the shared registry
+// ===================================================================
+static double RamPct() {
+    uint64_t t = g_metrics.U(METRIC_RAM_TOTAL);
+    return t > 0 ? (double)g_metrics.U(METRIC_RAM_USED) * 100.0 / t : 0;
+}
+
+static double SwapPct() {
+    uint64_t t = g_metrics.U(METRIC_SWAP_TOTAL);
+    return t > 0 ? (double)g_metrics.U(METRIC_SWAP_USED) * 100.0 / t : 0;
+}
+
+// Root (or Data) volume, else the first one; -1 if there are none
+static int PrimaryVol() {
+    for (int v = 0; v < g_metrics.Vols(); v++) {
+        const char *p = g_metrics.volPath[v];
+        if (!strcmp(p, "/") || !strcmp(p, "/System/Volumes/Data"))
+            return v;
+    }
+    return g_metrics.Vols() > 0 ? 0 : -1;
+}
+
+// ===================================================================
+// History sparklines (the 1 s tier): per-column min/max heights in whole
+// pixels, right-aligned while the history fills up. scale <= 0 autoscales
+// to the largest value in view (at least 1 KB/s).
+// ===================================================================
+static const int     SPARK_COLS  = 96;
+static const CGFloat NET_SPARK_W = 90;
+
+static int SparkHeights(HistId id, CGFloat w, CGFloat ht, float scale,
+                        int *cols, int *lo, int *hi) {
+    float mn[SPARK_COLS], mx[SPARK_COLS];
+    *cols = std::min((int)(w / 2), SPARK_COLS);
+    int n = HistMinMax(g_hist[id], *cols, mn, mx);
+    if (scale <= 0) {
+        scale = 1024.f;
+        for (int i = 0; i < n; i++) scale = std::max(scale, mx[i]);
+    }
+    for (int i = 0; i < n; i++) {
+        lo[i] = (int)lrint(std::min(std::max(mn[i] / scale, 0.f), 1.f) * ht);
+        hi[i] = (int)lrint(std::min(std::max(mx[i] / scale, 0.f), 1.f) * ht);
+    }
+    return n;
+}
+
+// ===================================================================
+// Display hash: everything the views show, quantized to what is visible
+// (formatted text, whole percents, the current second).
+// ===================================================================
+struct FrameHash {
+    uint64_t h = 1469598103934665603ULL;   // FNV-1a
+    void Add(const void *p, size_t n) {
+        const unsigned char *b = (const unsigned char *)p;
+        for (size_t i = 0; i < n; i++) { h ^= b[i]; h *= 1099511628211ULL; }
+    }
+    void Add(long v) { Add(&v, sizeof(v)); }
+    void Add(const std::string &s) { Add(s.data(), s.size()); Add((long)s.size()); }
+};
+
+static uint64_t DisplayHash() {
+    FrameHash fh;
+    fh.Add((long)time(nullptr));
+    fh.Add(lrint(g_metrics.F(METRIC_CPU_TOTAL)));
+    for (int i = 0; i < g_metrics.Cores(); i++) fh.Add(lrint(g_metrics.F(METRIC_CPU_CORE, i)));
+
+    double ramPct = RamPct();
+    double swpPct = SwapPct();
+    fh.Add(lrint(ramPct));
+    fh.Add(lrint(swpPct));
+    fh.Add(FmtMem(g_metrics.U(METRIC_RAM_USED)));  fh.Add(FmtMem(g_metrics.U(METRIC_RAM_TOTAL)));
+    fh.Add(FmtMem(g_metrics.U(METRIC_SWAP_USED))); fh.Add(FmtMem(g_metrics.U(METRIC_SWAP_TOTAL)));
+
+    for (int v = 0; v < g_metrics.Vols(); v++) {
+        fh.Add(g_metrics.volPath[v], strlen(g_metrics.volPath[v]));
+        fh.Add(lrint(g_metrics.VolPct(v)));
+        fh.Add(lrint(g_metrics.F(METRIC_DISK_USED, v) * 10));
+        fh.Add(lrint(g_metrics.F(METRIC_DISK_TOTAL, v) * 10));
+    }
+
+    int cols, n, lo[SPARK_COLS], hi[SPARK_COLS];
+    struct { HistId id; CGFloat w; float scale; } sparks[] = {
+        { HIST_CPU,      CurLayout().sec[SEC_ID_CPU].w, 100.f },
+        { HIST_RAM,      SEC_MEM_W - 144.0,      100.f },
+        { HIST_NET_UP,   NET_SPARK_W,            0 },
+        { HIST_NET_DOWN, NET_SPARK_W,            0 },
+    };
+    for (const auto &sp : sparks) {
+        n = SparkHeights(sp.id, sp.w, 24, sp.scale, &cols, lo, hi);
+        fh.Add(lo, n * sizeof(int));
+        fh.Add(hi, n * sizeof(int));
+    }
+
+    fh.Add(FmtSpeed(g_metrics.F(METRIC_NET_UP)));
+    fh.Add(FmtSpeed(g_metrics.F(METRIC_NET_DOWN)));
+    fh.Add(g_lanIP);
+    fh.Add(lrint(g_metrics.F(METRIC_BATTERY)));
+    fh.Add((long)g_windowBehind.load());
+    fh.Add((long)g_wpanelBehind.load());
+    for (int i = 0; i < g_numPlugVals; i++) {
+        fh.Add(g_plugVals[i].text, strlen(g_plugVals[i].text));
+        fh.Add(lrint(g_plugVals[i].pct));
+        fh.Add((long)g_plugVals[i].stale);
+    }
+
+    std::lock_guard<std::mutex> lk(g_extMtx);
+    fh.Add(g_ext.ip);
+    fh.Add(g_ext.city);
+    fh.Add(g_ext.country);
+    fh.Add(g_ext.wdesc);
+    fh.Add((long)g_ext.wcode);
+    fh.Add(lrint(g_ext.temp));
+    fh.Add((long)g_ext.loaded);
+    return fh.h;
 }
 
 // ===================================================================
@@ -199,6 +367,26 @@ static void DrawBar(CGContextRef ctx, CGFloat x, CGFloat y, CGFloat w, CGFloat h
     if (fw > h) FillRoundRect(ctx, x, y, fw, h, h/2, color);
 }
 
+static void DrawSpark(CGContextRef ctx, HistId id, CGFloat x, CGFloat y,
+                      CGFloat w, CGFloat ht, float scale, NSColor *color) {
+    int cols, lo[SPARK_COLS], hi[SPARK_COLS];
+    int n = SparkHeights(id, w, ht, scale, &cols, lo, hi);
+    if (n == 0) return;
+    CGRect area[SPARK_COLS], band[SPARK_COLS];
+    CGFloat cw = w / cols, bottom = y + ht;
+    for (int i = 0; i < n; i++) {
+        CGFloat cx = x + w - (n - i) * cw;
+        area[i] = CGRectMake(cx, bottom - hi[i], cw, hi[i]);
+        band[i] = CGRectMake(cx, bottom - hi[i], cw, std::max(hi[i] - lo[i], 1));
+    }
+    CGFloat comps[4];
+    [[color colorUsingColorSpace:[NSColorSpace sRGBColorSpace]] getComponents:comps];
+    CGContextSetRGBFillColor(ctx, comps[0], comps[1], comps[2], 0.11);
+    CGContextFillRects(ctx, area, n);
+    CGContextSetRGBFillColor(ctx, comps[0], comps[1], comps[2], 0.27);
+    CGContextFillRects(ctx, band, n);
+}
+
 static void DrawText(NSString *text, CGFloat x, CGFloat y, CGFloat w, CGFloat h,
                      NSFont *font, NSColor *color, NSTextAlignment align) {
     NSMutableParagraphStyle *ps = [[NSMutableParagraphStyle alloc] init];
@@ -247,29 +435,13 @@ static void DrawCircleGauge(CGContextRef ctx, CGFloat cx, CGFloat cy, CGFloat ra
 // Hit-testing for tooltips
 // ===================================================================
 static int HitTestCore(CGFloat mx, CGFloat my) {
-    CGFloat cpuX = BAR_PAD + SEC_TIME_W + 16;
-    CGFloat blockY = 42;
-    for (int i = 0; i < g_numCores; i++) {
-        CGFloat bx = cpuX + i * 10.0;
-        if (mx >= bx && mx < bx + 10 && my >= blockY && my < blockY + 20)
-            return i;
-    }
-    return -1;
+    int i;
+    return LayoutHitTest(CurLayout(), mx, my, &i) == HIT_CORE ? i : -1;
 }
 
 static int HitTestVol(CGFloat mx, CGFloat my) {
-    CGFloat diskX = BAR_PAD + SEC_TIME_W + 16 + CalcCpuSecW() + 16 + SEC_MEM_W + 16;
-    CGFloat colW = SEC_DISK_COL_W;
-    int n = (int)g_vols.size();
-    for (int v = 0; v < n; v++) {
-        int col = v / 2;
-        int row = v % 2;
-        CGFloat rx = diskX + col * colW;
-        CGFloat ry = (row == 0) ? 9 : 42;
-        if (mx >= rx && mx < rx + colW && my >= ry && my < ry + 24)
-            return v;
-    }
-    return -1;
+    int v;
+    return LayoutHitTest(CurLayout(), mx, my, &v) == HIT_VOL ? v : -1;
 }
 
 // Hit-test per-core bars in the dock widget panel
@@ -278,7 +450,7 @@ static int HitTestCorePanel(CGFloat mx, CGFloat my, CGFloat viewW, CGFloat viewH
     CGFloat pad = WPANEL_PAD;
     CGFloat leftW = 135;
     int maxVisual = (int)((leftW - 4) / 8);
-    int maxCores = g_numCores;
+    int maxCores = g_metrics.Cores();
     if (maxCores > maxVisual) maxCores = maxVisual;
     CGFloat coreY = viewH - pad - 22;
     CGFloat coreX = pad;
@@ -292,6 +464,17 @@ static int HitTestCorePanel(CGFloat mx, CGFloat my, CGFloat viewW, CGFloat viewH
     return -1;
 }
 
+// Core usage plus its 15 min rollup and the CPU p95 over the same window
+static void CoreTip(int core, char *buf, size_t n) {
+    RollupStats w = RollupCoreWindow(core, 15 * 60);
+    if (w.count)
+        snprintf(buf, n, "Core %d: %.1f%% usage\n15 min: avg %.1f%%, max %.1f%%\nCPU p95 (15 min): %.0f%%",
+                 core, g_metrics.F(METRIC_CPU_CORE, core), w.avg, w.max,
+                 RollupQuantile(HIST_CPU, 15 * 60, 0.95f));
+    else
+        snprintf(buf, n, "Core %d: %.1f%% usage", core, g_metrics.F(METRIC_CPU_CORE, core));
+}
+
 // ===================================================================
 // Custom tooltip window (NSView.toolTip unreliable on borderless windows)
 // ===================================================================
@@ -360,20 +543,19 @@ static void HideTip() {
     g_hovCore = core;
     g_hovVol  = vol;
 
-    if (core >= 0 && core < (int)g_coreUse.size()) {
-        char buf[64];
-        snprintf(buf, 64, "Core %d: %.1f%% usage", core, g_coreUse[core]);
+    if (core >= 0 && core < g_metrics.Cores()) {
+        char buf[192];
+        CoreTip(core, buf, sizeof(buf));
         ShowTip([NSString stringWithUTF8String:buf], [NSEvent mouseLocation]);
-    } else if (vol >= 0 && vol < (int)g_vols.size()) {
-        double pct = g_vols[vol].totalGB > 0 ?
-            g_vols[vol].usedGB * 100.0 / g_vols[vol].totalGB : 0;
-        double freeGB = g_vols[vol].totalGB - g_vols[vol].usedGB;
+    } else if (vol >= 0 && vol < g_metrics.Vols()) {
+        double usedGB  = g_metrics.F(METRIC_DISK_USED,  vol);
+        double totalGB = g_metrics.F(METRIC_DISK_TOTAL, vol);
         char buf[256];
         snprintf(buf, 256, "Volume: %s\nUsed: %s / %s (%.1f%%)\nFree: %s",
-                 g_vols[vol].mount.c_str(),
-                 FmtDisk(g_vols[vol].usedGB).c_str(),
-                 FmtDisk(g_vols[vol].totalGB).c_str(), pct,
-                 FmtDisk(freeGB).c_str());
+                 g_metrics.volPath[vol],
+                 FmtDisk(usedGB).c_str(),
+                 FmtDisk(totalGB).c_str(), g_metrics.VolPct(vol),
+                 FmtDisk(totalGB - usedGB).c_str());
         ShowTip([NSString stringWithUTF8String:buf], [NSEvent mouseLocation]);
     } else {
         HideTip();
@@ -390,9 +572,11 @@ static void HideTip() {
     CGContextRef ctx = [[NSGraphicsContext currentContext] CGContext];
     int W = (int)self.bounds.size.width;
     int H = (int)self.bounds.size.height;
+    uint64_t t = PerfNow();
 
     // Clear
     CGContextClearRect(ctx, self.bounds);
+    t = PerfLap(PERF_CLEAR, t);
 
     // Background rounded rect — 90% transparent when a window is behind
     bool behind = g_windowBehind.load();
@@ -406,6 +590,7 @@ static void HideTip() {
     CGContextAddPath(ctx, bp);
     CGContextStrokePath(ctx);
     CGPathRelease(bp);
+    t = PerfLap(PERF_CHROME, t);
 
     // Fonts
     NSFont *fTime  = [NSFont monospacedDigitSystemFontOfSize:kFTime weight:NSFontWeightBold];
@@ -421,11 +606,19 @@ static void HideTip() {
     NSColor *orange = RGBA(255, 100, 70);
 
     CGFloat R1 = 9, R2 = 42, RH = 24;
-    CGFloat x = BAR_PAD;
+    const Layout &l = CurLayout();
+
+    // Separators
+    CGContextSetRGBStrokeColor(ctx, 1, 1, 1, 0.16);
+    for (int i = 0; i < l.numSeps; i++) {
+        CGContextMoveToPoint(ctx, l.sepX[i], 8);
+        CGContextAddLineToPoint(ctx, l.sepX[i], H-8);
+    }
+    CGContextStrokePath(ctx);
 
     // ---- Section 1: Date & Time ----
-    {
-        CGFloat sw = SEC_TIME_W;
+    if (l.on[SEC_ID_TIME]) {
+        CGFloat x = l.sec[SEC_ID_TIME].x, sw = l.sec[SEC_ID_TIME].w;
         NSDateFormatter *df = [[NSDateFormatter alloc] init];
         df.dateFormat = @"EEE, MMM d, yyyy";
         NSString *dateStr = [df stringFromDate:[NSDate date]];
@@ -434,100 +627,77 @@ static void HideTip() {
         df.dateFormat = @"HH:mm:ss";
         NSString *timeStr = [df stringFromDate:[NSDate date]];
         DrawText(timeStr, x, R2 - 2, sw, RH + 4, fTime, white, NSTextAlignmentCenter);
-        x += sw;
     }
 
-    // Separator
-    CGContextSetRGBStrokeColor(ctx, 1, 1, 1, 0.16);
-    x += 8; CGContextMoveToPoint(ctx, x, 8); CGContextAddLineToPoint(ctx, x, H-8);
-    CGContextStrokePath(ctx); x += 8;
-
     // ---- Section 2: CPU ----
-    {
-        CGFloat sw = CalcCpuSecW();
-        char cpuBuf[32]; snprintf(cpuBuf, 32, "CPU  %.0f%%", g_totalCpu);
+    if (l.on[SEC_ID_CPU]) {
+        CGFloat x = l.sec[SEC_ID_CPU].x, sw = l.sec[SEC_ID_CPU].w;
+        DrawSpark(ctx, HIST_CPU, x, R1, sw, RH, 100.f, accent);
+        double cpu = g_metrics.F(METRIC_CPU_TOTAL);
+        char cpuBuf[32]; snprintf(cpuBuf, 32, "CPU  %.0f%%", cpu);
         DrawText([NSString stringWithUTF8String:cpuBuf], x, R1, 70, RH, fTitle, accent, NSTextAlignmentLeft);
-        DrawBar(ctx, x + 70, R1 + 6, sw - 82, 7, g_totalCpu, UsageCol(g_totalCpu));
+        DrawBar(ctx, x + 70, R1 + 6, sw - 82, 7, cpu, UsageCol(cpu));
 
-        CGFloat barH = 20;
-        CGFloat barY = R2;
         NSFont *fIdx = [NSFont monospacedDigitSystemFontOfSize:7 weight:NSFontWeightRegular];
-        for (int i = 0; i < g_numCores; i++) {
-            CGFloat bx = x + i * 10.0;
+        for (int i = 0; i < g_metrics.Cores(); i++) {
+            CGFloat bx = l.cores[i].x, barY = l.cores[i].y, barH = l.cores[i].h;
             FillRoundRect(ctx, bx, barY, 8, barH, 2, RGBA(255, 255, 255, 25));
-            CGFloat fillH = barH * g_coreUse[i] / 100.0;
+            CGFloat fillH = barH * g_metrics.F(METRIC_CPU_CORE, i) / 100.0;
             if (fillH >= 2)
-                FillRoundRect(ctx, bx, barY + barH - fillH, 8, fillH, 2, UsageCol(g_coreUse[i]));
-            if (g_numCores <= 16 || i % 2 == 0) {
+                FillRoundRect(ctx, bx, barY + barH - fillH, 8, fillH, 2, UsageCol(g_metrics.F(METRIC_CPU_CORE, i)));
+            if (g_metrics.Cores() <= 16 || i % 2 == 0) {
                 char idx[4]; snprintf(idx, 4, "%d", i);
                 DrawText([NSString stringWithUTF8String:idx], bx - 1, barY + barH + 1, 10, 9,
                          fIdx, RGBA(180, 180, 200), NSTextAlignmentCenter);
             }
         }
-        x += sw;
     }
 
-    // Separator
-    x += 8; CGContextMoveToPoint(ctx, x, 8); CGContextAddLineToPoint(ctx, x, H-8);
-    CGContextStrokePath(ctx); x += 8;
-
     // ---- Section 3: Memory ----
-    {
-        CGFloat sw = SEC_MEM_W;
-        std::string ramU = FmtMem(g_ramUsedMB), ramT = FmtMem(g_ramTotalMB);
+    if (l.on[SEC_ID_MEM]) {
+        CGFloat x = l.sec[SEC_ID_MEM].x, sw = l.sec[SEC_ID_MEM].w;
+        DrawSpark(ctx, HIST_RAM, x + 144, R1 + 1, sw - 144, RH, 100.f, RGBA(100, 180, 255));
+        std::string ramU = FmtMem(g_metrics.U(METRIC_RAM_USED)), ramT = FmtMem(g_metrics.U(METRIC_RAM_TOTAL));
         char ramV[64]; snprintf(ramV, 64, "%s / %s", ramU.c_str(), ramT.c_str());
         DrawText(@"RAM", x, R1, 38, RH, fTitle, accent, NSTextAlignmentLeft);
-        double ramPct = g_ramTotalMB > 0 ? (double)g_ramUsedMB * 100.0 / g_ramTotalMB : 0;
+        double ramPct = RamPct();
         DrawBar(ctx, x + 40, R1 + 7, 100, 6, ramPct, RGBA(100, 180, 255));
         DrawText([NSString stringWithUTF8String:ramV], x + 144, R1 + 1, sw - 144, RH, fSmall, dim, NSTextAlignmentLeft);
 
-        std::string swpU = FmtMem(g_swapUsedMB), swpT = FmtMem(g_swapTotalMB);
+        std::string swpU = FmtMem(g_metrics.U(METRIC_SWAP_USED)), swpT = FmtMem(g_metrics.U(METRIC_SWAP_TOTAL));
         char swpV[64]; snprintf(swpV, 64, "%s / %s", swpU.c_str(), swpT.c_str());
         DrawText(@"Swap", x, R2, 40, RH, fTitle, accent, NSTextAlignmentLeft);
-        double swpPct = g_swapTotalMB > 0 ? (double)g_swapUsedMB * 100.0 / g_swapTotalMB : 0;
+        double swpPct = SwapPct();
         DrawBar(ctx, x + 42, R2 + 7, 98, 6, swpPct, RGBA(180, 130, 255));
         DrawText([NSString stringWithUTF8String:swpV], x + 144, R2 + 1, sw - 144, RH, fSmall, dim, NSTextAlignmentLeft);
-        x += sw;
     }
 
-    // Separator
-    x += 8; CGContextMoveToPoint(ctx, x, 8); CGContextAddLineToPoint(ctx, x, H-8);
-    CGContextStrokePath(ctx); x += 8;
-
     // ---- Section: Disk Volumes ----
-    {
-        CGFloat colW = SEC_DISK_COL_W;
-        int n = (int)g_vols.size();
+    if (l.on[SEC_ID_DISK]) {
+        int n = std::min((int)l.vols.size(), g_metrics.Vols());
         for (int v = 0; v < n; v++) {
-            int col = v / 2;
-            int row = v % 2;
-            CGFloat cx = x + col * colW;
-            CGFloat cy = (row == 0) ? R1 : R2;
+            CGFloat cx = l.vols[v].x, cy = l.vols[v].y;
 
-            std::string lbl = (g_vols[v].letter == '/') ? "/:" : std::string(1, g_vols[v].letter) + ":";
-            DrawText([NSString stringWithUTF8String:lbl.c_str()], cx, cy, 22, RH, fTitle, accent, NSTextAlignmentLeft);
+            DrawText([NSString stringWithUTF8String:g_metrics.volLabel[v]], cx, cy, 22, RH, fTitle, accent, NSTextAlignmentLeft);
 
-            double pct = g_vols[v].totalGB > 0 ? g_vols[v].usedGB * 100.0 / g_vols[v].totalGB : 0;
+            double pct = g_metrics.VolPct(v);
             NSColor *bc = pct < 80 ? RGBA(100, 180, 255) : RGBA(255, 80, 60);
             DrawBar(ctx, cx + 24, cy + 7, 35, 6, pct, bc);
 
             char pL[8]; snprintf(pL, 8, "%.0f%%", pct);
             DrawText([NSString stringWithUTF8String:pL], cx + 62, cy + 1, 32, RH, fSmall, bc, NSTextAlignmentLeft);
         }
-        x += CalcDiskSecW();
     }
 
-    // Separator
-    x += 8; CGContextMoveToPoint(ctx, x, 8); CGContextAddLineToPoint(ctx, x, H-8);
-    CGContextStrokePath(ctx); x += 8;
-
     // ---- Section: IP + Network ----
-    {
-        CGFloat sw = SEC_IPNET_W;
-        std::string upS = "\xe2\x86\x91 " + FmtSpeed(g_netUp);   // ↑
-        std::string dnS = "\xe2\x86\x93 " + FmtSpeed(g_netDown); // ↓
-
-        {
+    if (l.on[SEC_ID_NET]) {
+        CGFloat x = l.sec[SEC_ID_NET].x, sw = l.sec[SEC_ID_NET].w;
+        std::string upS = "\xe2\x86\x91 " + FmtSpeed(g_metrics.F(METRIC_NET_UP));   // ↑
+        std::string dnS = "\xe2\x86\x93 " + FmtSpeed(g_metrics.F(METRIC_NET_DOWN)); // ↓
+        DrawSpark(ctx, HIST_NET_UP,   x + sw - NET_SPARK_W, R1, NET_SPARK_W, RH, 0, green);
+        DrawSpark(ctx, HIST_NET_DOWN, x + sw - NET_SPARK_W, R2, NET_SPARK_W, RH, 0, orange);
+
+        if (g_sections.ip) {
             std::lock_guard<std::mutex> lk(g_extMtx);
             DrawText(@"IP", x, R1, 18, RH, fTitle, accent, NSTextAlignmentLeft);
             DrawText([NSString stringWithUTF8String:g_ext.ip.c_str()], x + 18, R1 + 1, sw - 100, RH, fSmall, dim, NSTextAlignmentLeft);
@@ -537,17 +707,12 @@ static void HideTip() {
         DrawText(@"LAN", x, R2, 36, RH, fTitle, accent, NSTextAlignmentLeft);
         DrawText([NSString stringWithUTF8String:g_lanIP.c_str()], x + 36, R2 + 1, sw - 118, RH, fSmall, dim, NSTextAlignmentLeft);
         DrawText([NSString stringWithUTF8String:dnS.c_str()], x, R2, sw, RH, fVal, orange, NSTextAlignmentRight);
-        x += sw;
     }
 
-    // Separator
-    x += 8; CGContextMoveToPoint(ctx, x, 8); CGContextAddLineToPoint(ctx, x, H-8);
-    CGContextStrokePath(ctx); x += 8;
-
     // ---- Section: Location & Weather ----
-    {
+    if (l.on[SEC_ID_WX]) {
         std::lock_guard<std::mutex> lk(g_extMtx);
-        CGFloat wxW = SEC_WX_W;
+        CGFloat x = l.sec[SEC_ID_WX].x, wxW = l.sec[SEC_ID_WX].w;
         std::string loc;
         if (g_ext.loaded) {
             loc = g_ext.city;
@@ -564,6 +729,25 @@ static void HideTip() {
             DrawText([NSString stringWithUTF8String:wL], x, R2, wxW, RH, fVal, white, NSTextAlignmentLeft);
         }
     }
+
+    // ---- Section: Plugins ----
+    if (l.on[SEC_ID_PLUGIN]) {
+        int n = std::min((int)l.plugins.size(), g_numPlugVals);
+        for (int i = 0; i < n; i++) {
+            const PluginValue &pv = g_plugVals[i];
+            CGFloat cx = l.plugins[i].x, cy = l.plugins[i].y, vx = cx + 52;
+            DrawText([NSString stringWithUTF8String:pv.label], cx, cy, 52, RH, fTitle, accent, NSTextAlignmentLeft);
+            if (pv.pct >= 0) {
+                DrawBar(ctx, vx, cy + 7, 40, 6, pv.pct, RGBA(100, 180, 255));
+                vx += 44;
+            }
+            const char *txt = pv.text[0] ? pv.text : pv.stale ? "n/a" : "...";
+            NSString *s = [NSString stringWithUTF8String:txt] ?: @"?";
+            DrawText(s, vx, cy + 1, cx + l.plugins[i].w - vx - 4, RH, fSmall,
+                     pv.stale ? RGBA(170, 170, 185, 150) : dim, NSTextAlignmentLeft);
+        }
+    }
+    PerfLap(PERF_CONTENT, t);
 }
 
 @end
@@ -621,14 +805,15 @@ static void HideTip() {
         CGFloat cpuR = 30;
         CGFloat cpuCX = pad + cpuR + 4;
         CGFloat cpuCY = pad + cpuR + 12;
-        char cpuLbl[8]; snprintf(cpuLbl, 8, "%.0f%%", g_totalCpu);
-        DrawCircleGauge(ctx, cpuCX, cpuCY, cpuR, 5.0, g_totalCpu,
-                        UsageCol(g_totalCpu),
+        double cpu = g_metrics.F(METRIC_CPU_TOTAL);
+        char cpuLbl[8]; snprintf(cpuLbl, 8, "%.0f%%", cpu);
+        DrawCircleGauge(ctx, cpuCX, cpuCY, cpuR, 5.0, cpu,
+                        UsageCol(cpu),
                         [NSString stringWithUTF8String:cpuLbl], fGauge, white);
         DrawText(@"CPU", pad, cpuCY + cpuR + 2, cpuR * 2 + 8, 12, fLabel, dim, NSTextAlignmentCenter);
 
         // RAM circle gauge (small)
-        double ramPct = g_ramTotalMB > 0 ? (double)g_ramUsedMB * 100.0 / g_ramTotalMB : 0;
+        double ramPct = RamPct();
         CGFloat smR = 17;
         CGFloat ramCX = pad + cpuR * 2 + 20 + smR;
         CGFloat ramCY = pad + smR + 2;
@@ -639,7 +824,7 @@ static void HideTip() {
         DrawText(@"RAM", ramCX - smR - 2, ramCY + smR + 2, smR * 2 + 4, 12, fLabel, dim, NSTextAlignmentCenter);
 
         // Swap circle gauge (small)
-        double swpPct = g_swapTotalMB > 0 ? (double)g_swapUsedMB * 100.0 / g_swapTotalMB : 0;
+        double swpPct = SwapPct();
         CGFloat swpCY = ramCY + smR * 2 + 22;
         char swpLbl[8]; snprintf(swpLbl, 8, "%.0f%%", swpPct);
         DrawCircleGauge(ctx, ramCX, swpCY, smR, 3.5, swpPct,
@@ -648,15 +833,15 @@ static void HideTip() {
         DrawText(@"Swap", ramCX - smR - 2, swpCY + smR + 2, smR * 2 + 4, 12, fLabel, dim, NSTextAlignmentCenter);
 
         // Per-core bars and disk bar on the same row
-        int maxCores = std::min(g_numCores, (int)((leftW - 4) / 8));
+        int maxCores = std::min(g_metrics.Cores(), (int)((leftW - 4) / 8));
         CGFloat coreY = H - pad - 22;
         CGFloat coreX = pad;
         for (int i = 0; i < maxCores; i++) {
             CGFloat bx = coreX + i * 8.0;
             FillRoundRect(ctx, bx, coreY, 6, 18, 2, RGBA(255, 255, 255, 20));
-            CGFloat fillH = 18.0 * g_coreUse[i] / 100.0;
+            CGFloat fillH = 18.0 * g_metrics.F(METRIC_CPU_CORE, i) / 100.0;
             if (fillH >= 2)
-                FillRoundRect(ctx, bx, coreY + 18 - fillH, 6, fillH, 2, UsageCol(g_coreUse[i]));
+                FillRoundRect(ctx, bx, coreY + 18 - fillH, 6, fillH, 2, UsageCol(g_metrics.F(METRIC_CPU_CORE, i)));
         }
     }
 
@@ -669,18 +854,9 @@ static void HideTip() {
     CGContextStrokePath(ctx);
 
     // Disk usage bar (same row as CPU core bars) — primary volume only (e.g. Data), not sum of all
-    double diskUsed = 0, diskTotal = 0;
-    for (const auto& v : g_vols) {
-        if (v.letter == '/' || v.mount == "/" || v.mount == "/System/Volumes/Data") {
-            diskUsed = v.usedGB;
-            diskTotal = v.totalGB;
-            break;
-        }
-    }
-    if (diskTotal == 0 && !g_vols.empty()) {
-        diskUsed = g_vols[0].usedGB;
-        diskTotal = g_vols[0].totalGB;
-    }
+    int pv = PrimaryVol();
+    double diskUsed  = pv >= 0 ? g_metrics.F(METRIC_DISK_USED,  pv) : 0;
+    double diskTotal = pv >= 0 ? g_metrics.F(METRIC_DISK_TOTAL, pv) : 0;
     double diskPct = (diskTotal > 0) ? (diskUsed * 100.0 / diskTotal) : 0;
     double diskFreeGB = diskTotal - diskUsed;
     CGFloat coreY = H - pad - 22;
@@ -724,8 +900,8 @@ static void HideTip() {
         DrawText([NSString stringWithUTF8String:g_lanIP.c_str()],
                  midX, netY + 18, midW, 16, fSmall, dim, NSTextAlignmentLeft);
 
-        std::string upS = "\xe2\x86\x91 " + FmtSpeed(g_netUp);
-        std::string dnS = "\xe2\x86\x93 " + FmtSpeed(g_netDown);
+        std::string upS = "\xe2\x86\x91 " + FmtSpeed(g_metrics.F(METRIC_NET_UP));
+        std::string dnS = "\xe2\x86\x93 " + FmtSpeed(g_metrics.F(METRIC_NET_DOWN));
         NSString *upNS = [NSString stringWithUTF8String:(upS + " - ").c_str()];
         NSDictionary *tattrs = @{NSFontAttributeName: fVal};
         CGFloat upW = [upNS sizeWithAttributes:tattrs].width;
@@ -812,13 +988,14 @@ static void ToggleAutoStart() {
 // ===================================================================
 // App Delegate
 // ===================================================================
-@interface AppDelegate : NSObject <NSApplicationDelegate>
+@interface AppDelegate : NSObject <NSApplicationDelegate, NSMenuDelegate>
 @property (nonatomic, strong) NSWindow *window;
 @property (nonatomic, strong) MonitorView *monitorView;
 @property (nonatomic, strong) NSStatusItem *statusItem;
 @property (nonatomic, strong) NSTimer *refreshTimer;
 @property (nonatomic, strong) NSWindow *widgetPanel;
 @property (nonatomic, strong) WidgetPanelView *widgetPanelView;
+@property (nonatomic, strong) NSMenu *timingMenu;
 @end
 
 @implementation AppDelegate
@@ -842,6 +1019,7 @@ static void ToggleAutoStart() {
 - (void)screenDidChange:(NSNotification *)note {
     [self repositionWidget];
     [self repositionWidgetPanel];
+    [self windowsBehindMayHaveChanged:nil];
 }
 
 - (void)applicationDidFinishLaunching:(NSNotification *)notification {
@@ -888,13 +1066,45 @@ static void ToggleAutoStart() {
     autoItem.state = IsAutoStartEnabled() ? NSControlStateValueOn : NSControlStateValueOff;
     [menu addItem:autoItem];
     [menu addItem:[NSMenuItem separatorItem]];
+    NSMenuItem *framesItem = [[NSMenuItem alloc] initWithTitle:@"Frames" action:nil keyEquivalent:@""];
+    framesItem.tag = kFramesItemTag;
+    [menu addItem:framesItem];
+    NSMenuItem *timingItem = [[NSMenuItem alloc] initWithTitle:@"Timing (p50 / p99)" action:nil keyEquivalent:@""];
+    self.timingMenu = [[NSMenu alloc] init];
+    self.timingMenu.delegate = self;
+    timingItem.submenu = self.timingMenu;
+    [menu addItem:timingItem];
+    [menu addItem:[NSMenuItem separatorItem]];
     [menu addItemWithTitle:@"Quit" action:@selector(quit:) keyEquivalent:@"q"];
+    menu.delegate = self;
     self.statusItem.menu = menu;
 
     // Start refresh timer
-    self.refreshTimer = [NSTimer scheduledTimerWithTimeInterval:UPDATE_SEC
-        target:self selector:@selector(tick:) userInfo:nil repeats:YES];
-    [[NSRunLoop currentRunLoop] addTimer:self.refreshTimer forMode:NSRunLoopCommonModes];
+    [self scheduleRefresh:UPDATE_SEC];
+
+    // Power state + window-behind probe triggers (no per-tick window list walk)
+    NSNotificationCenter *wsnc = [[NSWorkspace sharedWorkspace] notificationCenter];
+    [wsnc addObserver:self selector:@selector(screensDidSleep:)
+        name:NSWorkspaceScreensDidSleepNotification object:nil];
+    [wsnc addObserver:self selector:@selector(screensDidWake:)
+        name:NSWorkspaceScreensDidWakeNotification object:nil];
+    [wsnc addObserver:self selector:@selector(sessionDidLock:)
+        name:NSWorkspaceSessionDidResignActiveNotification object:nil];
+    [wsnc addObserver:self selector:@selector(sessionDidUnlock:)
+        name:NSWorkspaceSessionDidBecomeActiveNotification object:nil];
+    [wsnc addObserver:self selector:@selector(windowsBehindMayHaveChanged:)
+        name:NSWorkspaceActiveSpaceDidChangeNotification object:nil];
+    [wsnc addObserver:self selector:@selector(windowsBehindMayHaveChanged:)
+        name:NSWorkspaceDidActivateApplicationNotification object:nil];
+    NSDistributedNotificationCenter *dnc = [NSDistributedNotificationCenter defaultCenter];
+    [dnc addObserver:self selector:@selector(sessionDidLock:)
+        name:@"com.apple.screenIsLocked" object:nil];
+    [dnc addObserver:self selector:@selector(sessionDidUnlock:)
+        name:@"com.apple.screenIsUnlocked" object:nil];
+    [[NSNotificationCenter defaultCenter] addObserver:self
+        selector:@selector(windowsBehindMayHaveChanged:)
+        name:NSWindowDidMoveNotification object:self.window];
+    [self windowsBehindMayHaveChanged:nil];
 
     // Global mouse-move monitor for hover tooltips (window is click-through)
     __weak AppDelegate *weakSelf = self;
@@ -921,20 +1131,19 @@ static void ToggleAutoStart() {
             g_hovCore = core;
             g_hovVol  = vol;
 
-            if (core >= 0 && core < (int)g_coreUse.size()) {
-                char buf[64];
-                snprintf(buf, 64, "Core %d: %.1f%% usage", core, g_coreUse[core]);
+            if (core >= 0 && core < g_metrics.Cores()) {
+                char buf[192];
+                CoreTip(core, buf, sizeof(buf));
                 ShowTip([NSString stringWithUTF8String:buf], sp);
-            } else if (vol >= 0 && vol < (int)g_vols.size()) {
-                double pct = g_vols[vol].totalGB > 0 ?
-                    g_vols[vol].usedGB * 100.0 / g_vols[vol].totalGB : 0;
-                double freeGB = g_vols[vol].totalGB - g_vols[vol].usedGB;
+            } else if (vol >= 0 && vol < g_metrics.Vols()) {
+                double usedGB  = g_metrics.F(METRIC_DISK_USED,  vol);
+                double totalGB = g_metrics.F(METRIC_DISK_TOTAL, vol);
                 char buf[256];
                 snprintf(buf, 256, "Volume: %s\nUsed: %s / %s (%.1f%%)\nFree: %s",
-                         g_vols[vol].mount.c_str(),
-                         FmtDisk(g_vols[vol].usedGB).c_str(),
-                         FmtDisk(g_vols[vol].totalGB).c_str(), pct,
-                         FmtDisk(freeGB).c_str());
+                         g_metrics.volPath[vol],
+                         FmtDisk(usedGB).c_str(),
+                         FmtDisk(totalGB).c_str(), g_metrics.VolPct(vol),
+                         FmtDisk(totalGB - usedGB).c_str());
                 ShowTip([NSString stringWithUTF8String:buf], sp);
             } else {
                 HideTip();
@@ -959,9 +1168,9 @@ static void ToggleAutoStart() {
             g_hovCore = core;
             g_hovVol  = -1;
 
-            if (core >= 0 && core < (int)g_coreUse.size()) {
-                char buf[64];
-                snprintf(buf, 64, "Core %d: %.1f%% usage", core, g_coreUse[core]);
+            if (core >= 0 && core < g_metrics.Cores()) {
+                char buf[192];
+                CoreTip(core, buf, sizeof(buf));
                 ShowTip([NSString stringWithUTF8String:buf], sp);
             } else {
                 HideTip();
@@ -981,44 +1190,123 @@ static void ToggleAutoStart() {
     }];
 }
 
-- (void)tick:(NSTimer *)timer {
-    UpdateCpu();
-    UpdateMem();
-    UpdateDisk();
-    UpdateNet();
-    UpdateLanIP();
-    UpdateBattery();
-    UpdateWindowBehind(self.window);
-    [self.monitorView setNeedsDisplay:YES];
+// ---- Power state ----
+// The tick lands on wall-clock multiples of its period with 5% slack
+- (void)scheduleRefresh:(NSTimeInterval)sec {
+    uint32_t ms = (uint32_t)(sec * 1000);
+    uint64_t now = SchedWallMs();
+    SetRateBase(ms);
+    if (g_tickJob < 0) g_tickJob = SchedAdd(ms, ms / 20, SCHED_ALIGNED, now);
+    else if (!SchedSetPeriod(g_tickJob, ms, ms / 20, now)) return;
+    [self armTick];
+}
+
+// One-shot timer per wakeup; the tolerance lets the system batch it with
+// other processes' timers
+- (void)armTick {
+    SchedWake w = SchedNext(SchedWallMs());
+    [self.refreshTimer invalidate];
+    self.refreshTimer = [[NSTimer alloc] initWithFireDate:[NSDate dateWithTimeIntervalSince1970:w.atMs / 1000.0]
+        interval:0 target:self selector:@selector(tick:) userInfo:nil repeats:NO];
+    self.refreshTimer.tolerance = w.slackMs / 1000.0;
+    [[NSRunLoop currentRunLoop] addTimer:self.refreshTimer forMode:NSRunLoopCommonModes];
+}
+
+- (void)applyPowerState {
+    NSTimeInterval sec = (g_displayAsleep || g_sessionLocked) ? BACKGROUND_SEC : UPDATE_SEC;
+    [self scheduleRefresh:sec * FootprintPeriodScale()];
+}
+
+- (void)screensDidSleep:(NSNotification *)note  { g_displayAsleep = true;  [self applyPowerState]; }
+- (void)screensDidWake:(NSNotification *)note   { g_displayAsleep = false; [self applyPowerState]; }
+- (void)sessionDidLock:(NSNotification *)note   { g_sessionLocked = true;  [self applyPowerState]; }
+- (void)sessionDidUnlock:(NSNotification *)note { g_sessionLocked = false; [self applyPowerState]; }
+
+- (BOOL)anyViewVisible {
+    return self.window.isVisible || self.widgetPanel.isVisible || g_statusTextMode;
+}
+
+// The CGWindowList walk only runs when our windows move, the space changes
+// or another app comes forward, not once per tick.
+- (void)windowsBehindMayHaveChanged:(NSNotification *)note {
+    if (ShedProbes()) return;
+    PerfScope ps(PERF_WINBEHIND);
+    if (self.window.isVisible) {
+        UpdateWindowBehind(self.window);
+        [self.monitorView setNeedsDisplay:YES];
+    }
     if (self.widgetPanel.isVisible) {
         UpdateWindowBehind(self.widgetPanel, &g_wpanelBehind);
         [self.widgetPanelView setNeedsDisplay:YES];
     }
+}
+
+- (void)tick:(NSTimer *)timer {
+    uint32_t due = SchedRun(SchedWallMs());
+    [self armTick];
+    if (!SchedDue(due, g_tickJob)) return;
+    // Rendering-only work is skipped while nothing is on screen
+    bool visible = !g_displayAsleep && !g_sessionLocked && [self anyViewVisible];
+    uint32_t active = 0;
+    if (SectionOn(SEC_ID_CPU))  active |= 1u << RATE_CPU;
+    if (SectionOn(SEC_ID_MEM))  active |= 1u << RATE_MEM;
+    if (SectionOn(SEC_ID_DISK)) active |= 1u << RATE_DISK;
+    if (SectionOn(SEC_ID_NET))  active |= 1u << RATE_NET;
+    if (visible && SectionOn(SEC_ID_NET) && !ShedProbes()) active |= 1u << RATE_LANIP;
+    // Always: the exporter, shm and history publish power.* while hidden too
+    active |= 1u << RATE_BATTERY;
+    uint32_t run = RatesTick(active);
+    if (RateDue(run, RATE_CPU))  Timed(PERF_CPU,  UpdateCpu);
+    if (RateDue(run, RATE_MEM))  Timed(PERF_MEM,  UpdateMem);
+    if (RateDue(run, RATE_DISK)) Timed(PERF_DISK, UpdateDisk);
+    if (RateDue(run, RATE_NET))  Timed(PERF_NET,  UpdateNet);
+    if (RateDue(run, RATE_BATTERY)) Timed(PERF_BATTERY, UpdateBattery);
+    if (SectionOn(SEC_ID_PLUGIN)) {
+        PluginTick();
+        g_numPlugVals = PluginValues(g_plugVals, PLUGIN_MAX);
+    }
+    ExporterPublish(g_metrics);
+    ShmPublish(g_metrics, TsdbNowMs());
+    Timed(PERF_STORE, [] { TsdbAppend(g_metrics, TsdbNowMs()); });
+    if (HaveRules()) Timed(PERF_RULES, EvalAlerts);
+    if (FootprintTick(PerfNow() / 1000000)) {
+        NSLog(@"SysMonitor: %s", FootprintNote());
+        [self applyPowerState];
+    }
+
+    if (!visible) return;
+    if (RateDue(run, RATE_LANIP))   Timed(PERF_LANIP,   UpdateLanIP);
+
+    // Nothing visible changed: skip drawRect and the status title entirely
+    uint64_t t = PerfNow();
+    uint64_t frame = DisplayHash();
+    PerfLap(PERF_MODEL, t);
+    if (frame == g_lastFrameHash) {
+        g_framesSkipped++;
+        return;
+    }
+    g_lastFrameHash = frame;
+    g_framesDrawn++;
+
+    [self.monitorView setNeedsDisplay:YES];
+    if (self.widgetPanel.isVisible)
+        [self.widgetPanelView setNeedsDisplay:YES];
     // Update status item text in top bar if enabled
     if (g_statusTextMode && self.statusItem) {
-        double ramPct = g_ramTotalMB > 0 ? (double)g_ramUsedMB * 100.0 / g_ramTotalMB : 0;
+        double ramPct = RamPct();
         // Primary disk (same logic as dock widget)
-        double diskUsed = 0, diskTotal = 0;
-        for (const auto& v : g_vols) {
-            if (v.letter == '/' || v.mount == "/" || v.mount == "/System/Volumes/Data") {
-                diskUsed = v.usedGB;
-                diskTotal = v.totalGB;
-                break;
-            }
-        }
-        if (diskTotal == 0 && !g_vols.empty()) {
-            diskUsed = g_vols[0].usedGB;
-            diskTotal = g_vols[0].totalGB;
-        }
+        int pv = PrimaryVol();
+        double diskUsed  = pv >= 0 ? g_metrics.F(METRIC_DISK_USED,  pv) : 0;
+        double diskTotal = pv >= 0 ? g_metrics.F(METRIC_DISK_TOTAL, pv) : 0;
         double diskPct = (diskTotal > 0) ? (diskUsed * 100.0 / diskTotal) : 0;
 
-        std::string upS = FmtSpeed(g_netUp);
-        std::string dnS = FmtSpeed(g_netDown);
-        int bat = g_batteryPct;
+        std::string upS = FmtSpeed(g_metrics.F(METRIC_NET_UP));
+        std::string dnS = FmtSpeed(g_metrics.F(METRIC_NET_DOWN));
+        int bat = (int)g_metrics.F(METRIC_BATTERY);
         char buf[160];
         snprintf(buf, sizeof(buf),
                  "CPU %.0f%%  GPU 0%%  RAM %.0f%%  SSD %.0f%%  BAT %s%d%%  \xE2\x86\x91 %s  \xE2\x86\x93 %s",
-                 g_totalCpu,
+                 g_metrics.F(METRIC_CPU_TOTAL),
                  ramPct,
                  diskPct,
                  (bat >= 0 ? "" : "- "),
@@ -1031,6 +1319,52 @@ static void ToggleAutoStart() {
     }
 }
 
+- (void)menuNeedsUpdate:(NSMenu *)menu {
+    if (menu == self.timingMenu) {
+        [menu removeAllItems];
+        for (int s = 0; s < PERF_STAGE_COUNT; s++) {
+            double p50, p99;
+            if (!PerfPercentiles(s, p50, p99)) continue;
+            NSString *line = [NSString stringWithFormat:@"%-10s %.1f / %.1f \u00B5s",
+                              PerfStageName(s), p50, p99];
+            [menu addItemWithTitle:line action:nil keyEquivalent:@""];
+        }
+        // Our own overhead, and what the budget last made us give up
+        char fp[96];
+        if (FormatFootprint(FootprintCur(), fp, sizeof(fp))) {
+            [menu addItem:[NSMenuItem separatorItem]];
+            [menu addItemWithTitle:[NSString stringWithFormat:@"Self: %s", fp]
+                            action:nil keyEquivalent:@""];
+            if (FootprintNote()[0])
+                [menu addItemWithTitle:[NSString stringWithFormat:@"Budget: %s", FootprintNote()]
+                                action:nil keyEquivalent:@""];
+        }
+        char rates[160];
+        if (FormatRates(rates, sizeof(rates)))
+            [menu addItemWithTitle:[NSString stringWithFormat:@"Multi-rate: %s", rates]
+                            action:nil keyEquivalent:@""];
+        char sched[64];
+        if (FormatSched(SchedCur(), sched, sizeof(sched)))
+            [menu addItemWithTitle:[NSString stringWithFormat:@"Timer: %s", sched]
+                            action:nil keyEquivalent:@""];
+        [menu addItem:[NSMenuItem separatorItem]];
+        [menu addItemWithTitle:@"Dump to File" action:@selector(dumpTiming:) keyEquivalent:@""];
+        return;
+    }
+    NSMenuItem *item = [menu itemWithTag:kFramesItemTag];
+    item.title = [NSString stringWithFormat:@"Frames: %llu drawn, %llu skipped",
+                  g_framesDrawn, g_framesSkipped];
+}
+
+// Writes the per-stage timing table to the temp directory and opens it
+- (void)dumpTiming:(id)sender {
+    NSString *path = [NSTemporaryDirectory() stringByAppendingPathComponent:@"SysMonitor-timing.txt"];
+    std::string rep = PerfReport();
+    NSData *data = [NSData dataWithBytes:rep.data() length:rep.size()];
+    if ([data writeToFile:path atomically:YES])
+        [[NSWorkspace sharedWorkspace] openURL:[NSURL fileURLWithPath:path]];
+}
+
 - (void)disableStatusTextModeIfNeeded {
     if (!g_statusTextMode) return;
     g_statusTextMode = false;
@@ -1052,6 +1386,7 @@ static void ToggleAutoStart() {
     } else if (!g_widgetDocked) {
         [self disableStatusTextModeIfNeeded];
         [self.window orderFrontRegardless];
+        [self windowsBehindMayHaveChanged:nil];
         item.title = @"Hide Widget";
     }
 }
@@ -1078,27 +1413,18 @@ static void ToggleAutoStart() {
         if (!g_statusTextMode) {
             self.statusItem.button.title = @"📊";
         } else {
-            double ramPct = g_ramTotalMB > 0 ? (double)g_ramUsedMB * 100.0 / g_ramTotalMB : 0;
-            double diskUsed = 0, diskTotal = 0;
-            for (const auto& v : g_vols) {
-                if (v.letter == '/' || v.mount == "/" || v.mount == "/System/Volumes/Data") {
-                    diskUsed = v.usedGB;
-                    diskTotal = v.totalGB;
-                    break;
-                }
-            }
-            if (diskTotal == 0 && !g_vols.empty()) {
-                diskUsed = g_vols[0].usedGB;
-                diskTotal = g_vols[0].totalGB;
-            }
+            double ramPct = RamPct();
+            int pv = PrimaryVol();
+            double diskUsed  = pv >= 0 ? g_metrics.F(METRIC_DISK_USED,  pv) : 0;
+            double diskTotal = pv >= 0 ? g_metrics.F(METRIC_DISK_TOTAL, pv) : 0;
             double diskPct = (diskTotal > 0) ? (diskUsed * 100.0 / diskTotal) : 0;
-            std::string upS = FmtSpeed(g_netUp);
-            std::string dnS = FmtSpeed(g_netDown);
-            int bat = g_batteryPct;
+            std::string upS = FmtSpeed(g_metrics.F(METRIC_NET_UP));
+            std::string dnS = FmtSpeed(g_metrics.F(METRIC_NET_DOWN));
+            int bat = (int)g_metrics.F(METRIC_BATTERY);
             char buf[160];
             snprintf(buf, sizeof(buf),
                      "CPU %.0f%%  GPU 0%%  RAM %.0f%%  SSD %.0f%%  BAT %s%d%%  \xE2\x86\x91 %s  \xE2\x86\x93 %s",
-                     g_totalCpu,
+                     g_metrics.F(METRIC_CPU_TOTAL),
                      ramPct,
                      diskPct,
                      (bat >= 0 ? "" : "- "),
@@ -1146,12 +1472,16 @@ static void ToggleAutoStart() {
         self.widgetPanelView = [[WidgetPanelView alloc] initWithFrame:NSMakeRect(0, 0, WPANEL_W, WPANEL_H)];
         self.widgetPanel.contentView = self.widgetPanelView;
         [self repositionWidgetPanel];
+        [[NSNotificationCenter defaultCenter] addObserver:self
+            selector:@selector(windowsBehindMayHaveChanged:)
+            name:NSWindowDidMoveNotification object:self.widgetPanel];
     }
 
     if (self.widgetPanel.isVisible) {
         [self.widgetPanel orderOut:nil];
         [self.window orderFrontRegardless];
         g_widgetDocked = false;
+        [self windowsBehindMayHaveChanged:nil];
         item.title = @"Dock as Widget";
     } else {
         [self disableStatusTextModeIfNeeded];
@@ -1160,6 +1490,7 @@ static void ToggleAutoStart() {
         [self repositionWidgetPanel];
         [self.widgetPanel orderFrontRegardless];
         g_widgetDocked = true;
+        [self windowsBehindMayHaveChanged:nil];
         item.title = @"Undock Widget";
     }
 }
@@ -1177,6 +1508,10 @@ static void ToggleAutoStart() {
 
 - (void)applicationWillTerminate:(NSNotification *)notification {
     g_shutdown.store(true);
+    StopExporter();
+    TsdbClose();
+    ShmClose();
+    StopPlugins();
 }
 
 @end
@@ -1186,14 +1521,45 @@ static void ToggleAutoStart() {
 // ===================================================================
 int main(int argc, const char *argv[]) {
     @autoreleasepool {
-        InitCpu();
-        UpdateMem();
-        UpdateDisk();
-        InitNet();
-        UpdateLanIP();
-
-        std::thread bgThread(BgThreadFunc);
-        bgThread.detach();
+        LoadConfig();
+        std::vector<std::string> ruleErrors;
+        CompileRules(g_alerts, &ruleErrors);
+        for (const std::string& e : ruleErrors) NSLog(@"SysMonitor: %s", e.c_str());
+        std::vector<std::string> plugErrors;
+        if (SectionOn(SEC_ID_PLUGIN) && ConfigurePlugins(g_pluginSpecs, &plugErrors)) {
+            StartPlugins();
+            g_numPlugVals = PluginValues(g_plugVals, PLUGIN_MAX);
+        }
+        for (const std::string& e : plugErrors) NSLog(@"SysMonitor: %s", e.c_str());
+        FootprintBudget budget;
+        std::string budgetError;
+        if (ParseBudget(g_budget.c_str(), budget, &budgetError)) SetFootprintBudget(budget);
+        else NSLog(@"SysMonitor: %s", budgetError.c_str());
+        FootprintTick(PerfNow() / 1000000);
+        if (SectionOn(SEC_ID_CPU))  InitCpu();
+        if (SectionOn(SEC_ID_MEM))  UpdateMem();
+        if (SectionOn(SEC_ID_DISK)) UpdateDisk();
+        if (SectionOn(SEC_ID_NET))  { InitNet(); UpdateLanIP(); }
+        RateConfig rates = DefaultRates();
+        std::string ratesError;
+        if (!ParseRates(g_intervals.c_str(), rates, &ratesError)) NSLog(@"SysMonitor: %s", ratesError.c_str());
+        SetRates(rates, (uint32_t)(UPDATE_SEC * 1000));
+        // Without address notifications the LAN IP falls back to polling
+        if (RateMs(RATE_LANIP) == RATE_ON_CHANGE && !StartAddrWatch([] { RateTrigger(RATE_LANIP); }))
+            SetRate(RATE_LANIP, 60000);
+        // Power-source changes resample the battery between its polls
+        StartPowerWatch([] { RateTrigger(RATE_BATTERY); });
+        if (g_exporterPort) StartExporter(g_exporterPort);
+        ShmOpen();
+        if (g_historyFile != "off") {
+            std::string path = g_historyFile.empty() ? TsdbDefaultPath() : g_historyFile;
+            TsdbOpen(path.c_str());
+        }
+
+        if (WantExternal()) {
+            std::thread bgThread(BgThreadFunc);
+            bgThread.detach();
+        }
 
         NSApplication *app = [NSApplication sharedApplication];
         AppDelegate *delegate = [[AppDelegate alloc] init];
@@ -3,17 +3,18 @@
 
 #include "libs/common/common.h"
 #include "libs/globals/globals.h"
-#include "libs/cpu/cpu.h"
-#include "libs/mem/mem.h"
-#include "libs/gpu/gpu.h"
-#include "libs/disk/disk.h"
-#include "libs/net/net.h"
 #include "libs/external/external.h"
 #include "libs/tray/tray.h"
 #include "libs/gdip/gdip.h"
 #include "libs/layout/layout.h"
 #include "libs/draw/draw.h"
 #include "libs/tooltip/tooltip.h"
+#include "libs/power/power.h"
+#include "libs/config/config.h"
+#include "libs/sampler/sampler.h"
+#include "libs/exporter/exporter.h"
+#include "libs/tsdb/tsdb.h"
+#include "libs/shm/shm.h"
 
 static HANDLE g_singleMtx = nullptr;
 static bool AcquireSingleInstance() {
@@ -24,22 +25,39 @@ static bool AcquireSingleInstance() {
 static LRESULT CALLBACK WndProc(HWND hw, UINT msg, WPARAM wp, LPARAM lp) {
     switch (msg) {
     case WM_CREATE:
-        SetTimer(hw, TIMER_REFRESH, UPDATE_MS, nullptr);
+        InitPowerState(hw);
         return 0;
 
-    case WM_TIMER:
-        if (wp == TIMER_REFRESH) {
-            UpdateCpu();
-            UpdateMem();
-            UpdateGpu();
-            UpdateDisk();
-            UpdateNet();
-            UpdateLanIP();
+    case WM_SNAPSHOT:
+        FootprintWake();
+        // Always latch so a later show renders current data
+        LatchSnapshot();
+        if (g_powerMode == PM_ACTIVE) {
             Render();
-            if (g_hovCore >= 0 || g_hovVol >= 0) UpdateTip(hw);
+            if (g_hovCore >= 0 || g_hovVol >= 0 || g_hovSensor >= 0) UpdateTip(hw);
         }
         return 0;
 
+    case WM_ALERT: {
+        // One balloon per burst: the shell shows only the latest anyway
+        wchar_t text[256] = {}, line[160];
+        while (PopAlert(line, 160)) {
+            size_t n = wcslen(text);
+            if (n + wcslen(line) + 2 < 256) swprintf_s(text + n, 256 - n, L"%s%s", n ? L"\n" : L"", line);
+        }
+        if (text[0]) ShowTrayBalloon(L"SysMonitor alert", text);
+        return 0;
+    }
+
+    case WM_WTSSESSION_CHANGE:
+        OnSessionChange(hw, wp);
+        return 0;
+
+    case WM_POWERBROADCAST:
+        if (wp == PBT_POWERSETTINGCHANGE)
+            OnPowerSetting(hw, reinterpret_cast<const POWERBROADCAST_SETTING*>(lp));
+        return TRUE;
+
     case WM_MOUSEACTIVATE:
         return MA_NOACTIVATE;
 
@@ -52,17 +70,19 @@ static LRESULT CALLBACK WndProc(HWND hw, UINT msg, WPARAM wp, LPARAM lp) {
         int mx = GET_X_LPARAM(lp), my = GET_Y_LPARAM(lp);
         int core = HitTestCore(mx, my);
         int vol  = (core < 0) ? HitTestVol(mx, my) : -1;
+        int sens = (core < 0 && vol < 0) ? HitTestSensor(mx, my) : -1;
 
-        bool changed = (core != g_hovCore) || (vol != g_hovVol);
-        g_hovCore = core;
-        g_hovVol  = vol;
+        bool changed = (core != g_hovCore) || (vol != g_hovVol) || (sens != g_hovSensor);
+        g_hovCore   = core;
+        g_hovVol    = vol;
+        g_hovSensor = sens;
 
         if (changed) {
-            if (core >= 0 || vol >= 0)
+            if (core >= 0 || vol >= 0 || sens >= 0)
                 UpdateTip(hw);
             else
                 HideTip(hw);
-        } else if (core >= 0 || vol >= 0) {
+        } else if (core >= 0 || vol >= 0 || sens >= 0) {
             UpdateTip(hw);
         }
         return 0;
@@ -70,8 +90,9 @@ static LRESULT CALLBACK WndProc(HWND hw, UINT msg, WPARAM wp, LPARAM lp) {
 
     case WM_MOUSELEAVE:
         g_mouseTracking = false;
-        g_hovCore = -1;
-        g_hovVol  = -1;
+        g_hovCore   = -1;
+        g_hovVol    = -1;
+        g_hovSensor = -1;
         HideTip(hw);
         return 0;
 
@@ -81,7 +102,8 @@ static LRESULT CALLBACK WndProc(HWND hw, UINT msg, WPARAM wp, LPARAM lp) {
         else if (LOWORD(lp) == WM_LBUTTONDBLCLK) {
             g_visible = !g_visible;
             ShowWindow(hw, g_visible ? SW_SHOWNOACTIVATE : SW_HIDE);
-            if (g_visible) Render();
+            ApplyPowerMode(hw);
+            if (g_visible) Render(true);
         }
         return 0;
 
@@ -90,11 +112,15 @@ static LRESULT CALLBACK WndProc(HWND hw, UINT msg, WPARAM wp, LPARAM lp) {
         case IDM_SHOWHIDE:
             g_visible = !g_visible;
             ShowWindow(hw, g_visible ? SW_SHOWNOACTIVATE : SW_HIDE);
-            if (g_visible) Render();
+            ApplyPowerMode(hw);
+            if (g_visible) Render(true);
             break;
         case IDM_AUTOSTART:
             ToggleAutoStart();
             break;
+        case IDM_DUMPTIMING:
+            DumpTiming();
+            break;
         case IDM_EXIT:
             PostQuitMessage(0);
             break;
@@ -102,7 +128,7 @@ static LRESULT CALLBACK WndProc(HWND hw, UINT msg, WPARAM wp, LPARAM lp) {
         return 0;
 
     case WM_DESTROY:
-        KillTimer(hw, TIMER_REFRESH);
+        CleanupPowerState(hw);
         RemoveTray();
         PostQuitMessage(0);
         return 0;
@@ -123,14 +149,9 @@ int WINAPI wWinMain(HINSTANCE hInst, HINSTANCE, LPWSTR, int) {
     wc.hCursor        = LoadCursor(nullptr, IDC_ARROW);
     RegisterClassExW(&wc);
 
+    LoadConfig();
     InitGdip();
-    InitCpu();
-    UpdateMem();
-    InitGpuD3dKmt();
-    UpdateGpu();
-    UpdateDisk();
-    InitNet();
-    UpdateLanIP();
+    InitSampler();
 
     int scrW = GetSystemMetrics(SM_CXSCREEN);
     int wW   = CalcWidth();
@@ -149,10 +170,14 @@ int WINAPI wWinMain(HINSTANCE hInst, HINSTANCE, LPWSTR, int) {
     InitTip(g_hwnd);
 
     g_shutdownEvt = CreateEventW(nullptr, TRUE, FALSE, nullptr);
-    g_bgThread = CreateThread(nullptr, 0, BgThread, nullptr, 0, nullptr);
+    g_fetchEvt    = CreateEventW(nullptr, FALSE, FALSE, nullptr);
+    StartSampler(g_hwnd);
+    if (g_exporterPort) StartExporter(g_exporterPort);
+    if (WantExternal())
+        g_bgThread = CreateThread(nullptr, 0, BgThread, nullptr, 0, nullptr);
 
     ShowWindow(g_hwnd, SW_SHOWNOACTIVATE);
-    Render();
+    Render(true);
 
     MSG msg;
     while (GetMessage(&msg, nullptr, 0, 0)) {
@@ -161,9 +186,17 @@ int WINAPI wWinMain(HINSTANCE hInst, HINSTANCE, LPWSTR, int) {
     }
 
     SetEvent(g_shutdownEvt);
-    WaitForSingleObject(g_bgThread, 5000);
-    CloseHandle(g_bgThread);
+    StopSampler();
+    StopExporter();
+    TsdbClose();
+    ShmClose();
+    StopPlugins();
+    if (g_bgThread) {
+        WaitForSingleObject(g_bgThread, 5000);
+        CloseHandle(g_bgThread);
+    }
     CloseHandle(g_shutdownEvt);
+    CloseHandle(g_fetchEvt);
     CleanupGdip();
     if (g_singleMtx) CloseHandle(g_singleMtx);
     return 0;
@@ -0,0 +1,181 @@
+// SysMonitor - Scale simulator (Linux)
+// Runs the real samplers, layout, hit-test and output encoders against a
+// synthetic host (libs/sim) and reports per-tick cost and memory as core,
+// volume and interface counts grow. Counts past the fixed metric slots
+// show up as shown < simulated instead of disappearing silently.
+// Usage: sysmon_scale [--json] [--ticks N] [--seed N]
+//                     [--cores N --vols N --ifaces N]   (one point)
+
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "libs/bench/bench.h"
+#include "libs/sim/sim.h"
+#include "libs/linux/metrics_linux.h"
+#include "libs/agent/agent.h"
+#include "libs/metrics/metrics.h"
+#include "libs/exporter/exporter.h"
+#include "libs/layout/win_spec.h"
+
+enum ScaleStage {
+    ST_CPU, ST_MEM, ST_DISK, ST_NET, ST_THERMAL, ST_LAYOUT, ST_HIT, ST_JSON, ST_OPENMETRICS,
+    ST_COUNT
+};
+static const char* STAGE_NAMES[ST_COUNT] = {
+    "update_cpu", "update_mem", "update_disk", "update_net", "update_thermal",
+    "layout", "hit_test", "encode_json", "openmetrics",
+};
+
+static const int HITS_PER_TICK = 32;        // a mouse sweep across the bar
+
+static const int SCALE_ORDER[] = { SEC_ID_TIME, SEC_ID_CPU, SEC_ID_MEM, SEC_ID_DISK,
+                                   SEC_ID_NET, SEC_ID_WX };
+static const int SCALE_SECS = (int)(sizeof(SCALE_ORDER) / sizeof(SCALE_ORDER[0]));
+
+static char     g_buf[AGENT_RECORD_MAX * 8];
+static uint64_t g_ns[ST_COUNT];
+static uint64_t g_allocs;
+
+template <class F>
+static void Timed(int stage, F fn) {
+    BenchCounters a = BenchRead();
+    fn();
+    BenchCounters b = BenchRead();
+    g_ns[stage] += b.ns - a.ns;
+    g_allocs    += b.allocs - a.allocs;
+}
+
+static long RssKB() {
+    long pages = 0, rss = 0;
+    FILE* f = fopen("/proc/self/statm", "r");
+    if (!f) return 0;
+    if (fscanf(f, "%ld %ld", &pages, &rss) != 2) rss = 0;
+    fclose(f);
+    return rss * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+static size_t LayoutBytes(const Layout& l) {
+    return l.elems.capacity() * sizeof(LayoutElem) + l.hitCols.capacity() * sizeof(uint16_t) +
+           (l.cores.capacity() + l.vols.capacity() + l.plugins.capacity()) * sizeof(LayoutRect);
+}
+
+static void RunPoint(const SimConfig& want, int ticks, bool json) {
+    SimConfig c = SimStart(want);
+    InitCpu();
+    InitNet();
+    memset(g_ns, 0, sizeof(g_ns));
+    g_allocs = 0;
+
+    // First layout for these counts is a full build; later ticks hit the cache
+    SimStep(1000);
+    UpdateCpu(); UpdateDisk();
+    BenchCounters a = BenchRead();
+    const Layout* l = &GetLayout(WIN_SPEC, SCALE_ORDER, SCALE_SECS,
+                                 g_metrics.Cores(), g_metrics.Vols(), 0, 0, 1.f);
+    uint64_t buildNs = BenchRead().ns - a.ns;
+
+    for (int t = 0; t < ticks; t++) {
+        SimStep(1000);
+        Timed(ST_CPU,  [] { UpdateCpu(); });
+        Timed(ST_MEM,  [] { UpdateMem(); });
+        Timed(ST_DISK, [] { UpdateDisk(); });
+        Timed(ST_NET,  [] { UpdateNet(); });
+        Timed(ST_THERMAL, [] { UpdateThermal(); });
+        Timed(ST_LAYOUT, [&] {
+            l = &GetLayout(WIN_SPEC, SCALE_ORDER, SCALE_SECS,
+                           g_metrics.Cores(), g_metrics.Vols(), 0, 0, 1.f);
+        });
+        Timed(ST_HIT, [&] {
+            for (int i = 0; i < HITS_PER_TICK; i++) {
+                int idx;
+                float x = (float)l->width * i / HITS_PER_TICK;
+                HitKind k = LayoutHitTest(*l, x, 40.f + (i & 1) * 10.f, &idx);
+                BenchKeep(&k); BenchKeep(&idx);
+            }
+        });
+        Timed(ST_JSON, [] {
+            size_t n = EncodeRecord(AGENT_JSON, g_metrics, 0, 0, g_buf, sizeof(g_buf));
+            BenchKeep(&n);
+        });
+        Timed(ST_OPENMETRICS, [] {
+            size_t n = RenderOpenMetrics(g_metrics, g_buf, sizeof(g_buf));
+            BenchKeep(&n);
+        });
+    }
+
+    uint64_t total = 0;
+    for (int s = 0; s < ST_COUNT; s++) total += g_ns[s];
+    double perTick = (double)total / ticks;
+    double allocs  = (double)g_allocs / ticks;
+    int shownCores = g_metrics.Cores(), shownVols = g_metrics.Vols();
+
+    if (json) {
+        printf("{\"cores\":%d,\"vols\":%d,\"ifaces\":%d,\"shown_cores\":%d,\"shown_vols\":%d,"
+               "\"width\":%d,\"ticks\":%d,\"tick_ns\":%.0f,\"layout_build_ns\":%llu,\"ns\":{",
+               c.cores, c.vols, c.ifaces, shownCores, shownVols, l->width, ticks, perTick,
+               (unsigned long long)buildNs);
+        for (int s = 0; s < ST_COUNT; s++)
+            printf("%s\"%s\":%.0f", s ? "," : "", STAGE_NAMES[s], (double)g_ns[s] / ticks);
+        printf("},\"allocs_per_tick\":%.2f,\"layout_bytes\":%zu,\"rss_kb\":%ld}\n",
+               allocs, LayoutBytes(*l), RssKB());
+    } else {
+        printf("%5d %4d %6d  %5d %4d %6d", c.cores, c.vols, c.ifaces, shownCores, shownVols, l->width);
+        for (int s = 0; s < ST_COUNT; s++) printf(" %9.0f", (double)g_ns[s] / ticks);
+        printf(" %10.0f %9llu %7.2f %8zu %8ld\n", perTick, (unsigned long long)buildNs,
+               allocs, LayoutBytes(*l), RssKB());
+    }
+    fflush(stdout);
+    SimStop();
+}
+
+static void Usage(const char* argv0) {
+    fprintf(stderr,
+        "usage: %s [--json] [--ticks N] [--seed N] [--cores N --vols N --ifaces N]\n"
+        "  Without counts, sweeps from a laptop to 512 cores / 60 mounts /\n"
+        "  200 interfaces.\n", argv0);
+}
+
+int main(int argc, char** argv) {
+    bool json = false;
+    int ticks = 200;
+    SimConfig one = { 0, -1, 0, 1 };
+    for (int i = 1; i < argc; i++) {
+        const char* a = argv[i];
+        const char* v = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (strcmp(a, "--json") == 0) json = true;
+        else if (strcmp(a, "--ticks") == 0 && v)  { ticks = atoi(v); i++; }
+        else if (strcmp(a, "--seed") == 0 && v)   { one.seed = (uint32_t)strtoul(v, nullptr, 10); i++; }
+        else if (strcmp(a, "--cores") == 0 && v)  { one.cores = atoi(v); i++; }
+        else if (strcmp(a, "--vols") == 0 && v)   { one.vols = atoi(v); i++; }
+        else if (strcmp(a, "--ifaces") == 0 && v) { one.ifaces = atoi(v); i++; }
+        else { Usage(argv[0]); return 2; }
+    }
+    if (ticks < 1) ticks = 1;
+
+    if (!json) {
+        printf("%5s %4s %6s  %5s %4s %6s", "cores", "vols", "ifaces", "shown", "vols", "width");
+        for (int s = 0; s < ST_COUNT; s++) printf(" %9.9s", STAGE_NAMES[s]);
+        printf(" %10s %9s %7s %8s %8s\n", "tick_ns", "build_ns", "allocs", "layout_B", "rss_kB");
+    }
+
+    if (one.cores > 0 || one.vols >= 0 || one.ifaces > 0) {
+        if (one.cores <= 0)  one.cores = 8;
+        if (one.vols < 0)    one.vols = 4;
+        if (one.ifaces <= 0) one.ifaces = 4;
+        RunPoint(one, ticks, json);
+        return 0;
+    }
+
+    static const SimConfig SWEEP[] = {
+        {   4,  1,   2, 0 }, {  16,  4,  16, 0 }, {  64,  8,  64, 0 },
+        { 128, 26, 128, 0 }, { 256, 40, 160, 0 }, { 512, 60, 200, 0 },
+    };
+    for (SimConfig c : SWEEP) {
+        c.seed = one.seed;
+        RunPoint(c, ticks, json);
+    }
+    return 0;
+}